@@ -29,25 +29,189 @@
 #include "PMIC_BQ25896.h"
 
 void PMIC_BQ25896::_read(bq25896_reg_t reg, uint8_t *val) {
+#if BQ25896_ENABLE_CACHE
+    if (_cache_enabled && _cacheRead(reg, val))
+    {
+      return;
+    }
+#endif
+    _readBurst(reg, val, 1);
+}
+
+uint8_t PMIC_BQ25896::_readBurst(bq25896_reg_t reg, uint8_t *buf, uint8_t len) {
+    BQ25896_TRACEPOINT(BQ25896_TP_BUS_BEGIN, BQ25896_TP_BUS_ARG(reg, BQ25896_TRACE_READ, len));
     _i2c->beginTransmission(_i2c_addr);
     _i2c->write(reg);
-    _i2c->endTransmission();
+    uint8_t status = _i2c->endTransmission();
+
+    _i2c->requestFrom((uint8_t)_i2c_addr, len);
 
-    _i2c->requestFrom(_i2c_addr, 1);
+    uint8_t count = 0;
+    while (count < len && _i2c->available())
+    {
+      buf[count++] = _i2c->read();
+    }
+    BQ25896_TRACEPOINT(BQ25896_TP_BUS_END, BQ25896_TP_BUS_END_ARG(status, count));
 
-    if (_i2c->available())
+#if BQ25896_ENABLE_INSTRUMENTATION
+    if (_trace_hook)
+    {
+      _trace(reg, BQ25896_TRACE_READ, status | (count < len ? BQ25896_TRACE_SHORT_READ : 0), buf, count);
+    }
+#else
+    (void)status;
+#endif
+#if BQ25896_ENABLE_CACHE
+    if (_cache_enabled)
     {
-      *val = _i2c->read();
+      _cacheStore(reg, buf, count, true);
     }
+#endif
+    return count;
 }
 
 void PMIC_BQ25896::_write(bq25896_reg_t reg, uint8_t *val) {
+    _writeBurst(reg, val, 1);
+}
+
+uint8_t PMIC_BQ25896::_writeBurst(bq25896_reg_t reg, const uint8_t *buf, uint8_t len) {
+    BQ25896_TRACEPOINT(BQ25896_TP_BUS_BEGIN, BQ25896_TP_BUS_ARG(reg, BQ25896_TRACE_WRITE, len));
     _i2c->beginTransmission(_i2c_addr);
     _i2c->write(reg);
-    _i2c->write(*val);
-    _i2c->endTransmission();
+    _i2c->write(buf, len);
+    uint8_t status = _i2c->endTransmission();
+    BQ25896_TRACEPOINT(BQ25896_TP_BUS_END, BQ25896_TP_BUS_END_ARG(status, status == 0 ? len : 0));
+
+#if BQ25896_ENABLE_INSTRUMENTATION
+    if (_trace_hook)
+    {
+      _trace(reg, BQ25896_TRACE_WRITE, status, buf, len);
+    }
+#endif
+#if BQ25896_ENABLE_CACHE
+    if (_cache_enabled && status == 0)
+    {
+      _cacheStore(reg, buf, len, false);
+    }
+#endif
+    return status;
+}
+
+#if BQ25896_ENABLE_CACHE
+// First register and length of each cache block
+static const struct {
+    uint8_t first;
+    uint8_t len;
+} bq25896_cache_blocks[BQ25896_CACHE_GROUPS] = {
+    { ILIM, BOOST_CTRL - ILIM + 1 },
+    { VBUS_STAT, 1 },
+    { VINDPM, IDPM_LIM - VINDPM + 1 },
+};
+
+// Cache block of reg, -1 if reg is not cached
+static int8_t bq25896_cache_group(uint8_t reg){
+    if(reg <= BOOST_CTRL) return BQ25896_CACHE_CONFIG;
+    if(reg == VBUS_STAT) return BQ25896_CACHE_STATUS;
+    if(reg >= VINDPM && reg <= IDPM_LIM) return BQ25896_CACHE_ADC;
+    return -1;
+}
+
+bool PMIC_BQ25896::_cacheRead(bq25896_reg_t reg, uint8_t *val){
+    int8_t g = bq25896_cache_group(reg);
+    if(g < 0 || _cache_age[g] == 0){
+        return false;
+    }
+    uint32_t age = _cache_age[g];
+    if(_cache_valid[g] && (age == BQ25896_CACHE_FOREVER || (uint32_t)(millis() - _cache_time[g]) < age)){
+        // A cached value with a self-clearing bit set is re-read until it clears
+        if((_cache[reg] & bq25896_reg_sc_mask[reg]) == 0){
+            _cache_stats[g].hits++;
+            *val = _cache[reg];
+            return true;
+        }
+        _cache_stats[g].misses++;
+        return false;
+    }
+    _cache_stats[g].misses++;
+    BQ25896_TRACEPOINT(BQ25896_TP_CACHE_REFRESH, g);
+    uint8_t buf[BQ25896_REG_COUNT];
+    if(_readBurst((bq25896_reg_t)bq25896_cache_blocks[g].first, buf, bq25896_cache_blocks[g].len) != bq25896_cache_blocks[g].len){
+        return false;
+    }
+    *val = _cache[reg];
+    return true;
 }
 
+void PMIC_BQ25896::_cacheStore(bq25896_reg_t reg, const uint8_t *buf, uint8_t len, bool refresh){
+    for(uint8_t i = 0; i < len && reg + i < BQ25896_REG_COUNT; i++){
+        uint8_t r = reg + i;
+        if(r == CTRL2 && !refresh && (buf[i] & 0x80)){
+            // REG_RST, every register goes back to its default
+            invalidateCACHE();
+        }
+        if(bq25896_cache_group(r) >= 0){
+            _cache[r] = buf[i];
+        }
+    }
+    if(!refresh){
+        return;
+    }
+    uint32_t now = millis();
+    for(uint8_t g = 0; g < BQ25896_CACHE_GROUPS; g++){
+        if(reg <= bq25896_cache_blocks[g].first &&
+           reg + len >= bq25896_cache_blocks[g].first + bq25896_cache_blocks[g].len){
+            _cache_valid[g] = true;
+            _cache_time[g] = now;
+        }
+    }
+}
+
+void PMIC_BQ25896::setCACHE(bool enable){
+    _cache_enabled = enable;
+    invalidateCACHE();
+}
+
+void PMIC_BQ25896::setCACHE_AGE(bq25896_cache_group_t group, uint32_t max_age_ms){
+    if(group < BQ25896_CACHE_GROUPS){
+        _cache_age[group] = max_age_ms;
+    }
+}
+
+void PMIC_BQ25896::invalidateCACHE(){
+    memset(_cache_valid, 0, sizeof(_cache_valid));
+}
+
+bq25896_cache_stats_t PMIC_BQ25896::getCACHE_STATS(bq25896_cache_group_t group){
+    bq25896_cache_stats_t stats = { 0, 0 };
+    if(group < BQ25896_CACHE_GROUPS){
+        stats = _cache_stats[group];
+    }
+    return stats;
+}
+
+void PMIC_BQ25896::clearCACHE_STATS(){
+    memset(_cache_stats, 0, sizeof(_cache_stats));
+}
+#endif
+
+#if BQ25896_ENABLE_INSTRUMENTATION
+void PMIC_BQ25896::_trace(bq25896_reg_t reg, bq25896_trace_dir_t dir, uint8_t status, const uint8_t *data, uint8_t len) {
+    bq25896_trace_record_t rec;
+    rec.timestamp_us = micros();
+    rec.reg = reg;
+    rec.dir = dir;
+    rec.status = status;
+    rec.len = len;
+    memcpy(rec.data, data, len);
+    _trace_hook(rec, _trace_ctx);
+}
+
+void PMIC_BQ25896::setTRACE_HOOK(bq25896_trace_hook_t hook, void *ctx){
+    _trace_hook = hook;
+    _trace_ctx = ctx;
+}
+#endif
+
 void PMIC_BQ25896::begin(TwoWire *theWire){
     _i2c = theWire;
     _i2c->begin();
@@ -60,10 +224,153 @@ bool PMIC_BQ25896::isConnected(){
     else return false;
 }
 
+bq25896_error_t PMIC_BQ25896::checkVARIANT(){
+    bq25896_regs_t regs;
+    if(!readSNAPSHOT(regs, CTRL2, 1)){
+        return BQ_BUS_ERR;
+    }
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    if(!bq25896_variant_known(regs.ctrl2.pn)){
+        return BQ_RANGE_ERR;
+    }
+    _variant = regs.ctrl2.pn;
+    return BQ_OK;
+#else
+    return regs.ctrl2.pn == BQ25896_VARIANT ? BQ_OK : BQ_RANGE_ERR;
+#endif
+}
+
+uint8_t PMIC_BQ25896::getVARIANT(){
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    return _variant;
+#else
+    return BQ25896_VARIANT;
+#endif
+}
+
 void PMIC_BQ25896::reset(){
     PMIC_BQ25896::setREG_RST(1);
 }
 
+bq25896_regs_t PMIC_BQ25896::getSNAPSHOT(){
+    bq25896_regs_t regs;
+    memset(&regs, 0, sizeof(regs));
+    readSNAPSHOT(regs);
+    return regs;
+}
+
+bool PMIC_BQ25896::readSNAPSHOT(bq25896_regs_t &regs, bq25896_reg_t first, uint8_t count){
+    if(first >= BQ25896_REG_COUNT || count == 0 || count > BQ25896_REG_COUNT - first){
+        return false;
+    }
+    uint8_t len = _readBurst(first, &regs.raw[first], count);
+    if(first <= FAULT && first + len > FAULT){
+        _recordFault(regs.fault);
+    }
+    return len == count;
+}
+
+uint8_t PMIC_BQ25896::getFIELD(bq25896_field_t id){
+    uint8_t temp_reg;
+    _read((bq25896_reg_t)bq25896_fields[id].reg, &temp_reg);
+    bq25896_regs_t regs;
+    regs.raw[bq25896_fields[id].reg] = temp_reg;
+    if(bq25896_fields[id].reg == FAULT){
+        _recordFault(regs.fault);
+    }
+    return bq25896_field_get(regs, id);
+}
+
+bq25896_error_t PMIC_BQ25896::setFIELD(bq25896_field_t id, uint8_t code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, id);
+    const bq25896_field_info_t &f = bq25896_fields[id];
+    if(f.access == BQ25896_ACCESS_RO || f.access == BQ25896_ACCESS_RC || code >= (1u << f.width)){
+        return BQ_RANGE_ERR;
+    }
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    if((id == BQ25896_F_HVDCP_EN || id == BQ25896_F_MAXC_EN) && !bq25896_variant_has_hvdcp(_variant)){
+        return BQ_RANGE_ERR;
+    }
+#endif
+    bq25896_regs_t regs;
+    _read((bq25896_reg_t)f.reg, &regs.raw[f.reg]);
+    bq25896_field_set(regs, id, code);
+    _write((bq25896_reg_t)f.reg, &regs.raw[f.reg]);
+    return BQ_OK;
+}
+
+int32_t PMIC_BQ25896::getFIELD_value(bq25896_field_t id){
+    return bq25896_field_decode(id, getFIELD(id));
+}
+
+bq25896_error_t PMIC_BQ25896::setFIELD_value(bq25896_field_t id, int32_t value){
+    uint8_t code;
+    if(!bq25896_field_encode(id, value, code)){
+        return BQ_RANGE_ERR;
+    }
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    if(id == BQ25896_F_ICHG && value > bq25896_variant_ichg_max(_variant)){
+        return BQ_RANGE_ERR;
+    }
+#endif
+    return setFIELD(id, code);
+}
+
+bq25896_error_t PMIC_BQ25896::applyPROFILE(const bq25896_profile_t &profile){
+    if(!bq25896::Iinlim::in_range(profile.iinlim) ||
+       !bq25896::SysMin::in_range(profile.sys_min) ||
+       !bq25896::Ichg::in_range(profile.ichg) ||
+       !bq25896::Iprechg::in_range(profile.iprechg) ||
+       !bq25896::Iterm::in_range(profile.iterm) ||
+       !bq25896::Vreg::in_range(profile.vreg)){
+        return BQ_RANGE_ERR;
+    }
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    if(profile.ichg > bq25896_variant_ichg_max(_variant)){
+        return BQ_RANGE_ERR;
+    }
+#endif
+    bq25896_regs_t regs;
+    if(!readSNAPSHOT(regs, ILIM, VREG - ILIM + 1)){
+        return BQ_BUS_ERR;
+    }
+    bq25896_regs_t next = regs;
+    next.ilim.iinlim = bq25896::Iinlim::raw(profile.iinlim);
+    next.sys_ctrl.sys_min = bq25896::SysMin::raw(profile.sys_min);
+    next.ichg.ichg = bq25896::Ichg::raw(profile.ichg);
+    next.ipre_iterm.iprechg = bq25896::Iprechg::raw(profile.iprechg);
+    next.ipre_iterm.iterm = bq25896::Iterm::raw(profile.iterm);
+    next.vreg.vreg = bq25896::Vreg::raw(profile.vreg);
+
+    if(next.raw[ILIM] != regs.raw[ILIM]){
+        if(_writeBurst(ILIM, &next.raw[ILIM], 1) != 0) return BQ_BUS_ERR;
+    }
+    // REG01 and REG02 are not touched, REG03 - REG06 go out as one burst
+    // spanning the first to the last changed register
+    uint8_t first = SYS_CTRL;
+    uint8_t last = VREG;
+    while(first <= VREG && next.raw[first] == regs.raw[first]) first++;
+    while(last > first && next.raw[last] == regs.raw[last]) last--;
+    if(first <= VREG){
+        if(_writeBurst((bq25896_reg_t)first, &next.raw[first], last - first + 1) != 0) return BQ_BUS_ERR;
+    }
+    return BQ_OK;
+}
+
+bq25896_profile_t PMIC_BQ25896::getPROFILE(){
+    bq25896_regs_t regs;
+    memset(&regs, 0, sizeof(regs));
+    readSNAPSHOT(regs, ILIM, VREG - ILIM + 1);
+    bq25896_profile_t profile;
+    profile.iinlim = bq25896::Iinlim::decode(regs.ilim.iinlim);
+    profile.sys_min = bq25896::SysMin::decode(regs.sys_ctrl.sys_min);
+    profile.ichg = bq25896::Ichg::decode(regs.ichg.ichg);
+    profile.iprechg = bq25896::Iprechg::decode(regs.ipre_iterm.iprechg);
+    profile.iterm = bq25896::Iterm::decode(regs.ipre_iterm.iterm);
+    profile.vreg = bq25896::Vreg::decode(regs.vreg.vreg);
+    return profile;
+}
+
 // REG00
 ilim_reg_t PMIC_BQ25896::getILIM_reg(){
     ilim_reg_t temp_reg;
@@ -72,32 +379,39 @@ ilim_reg_t PMIC_BQ25896::getILIM_reg(){
 }
 
 void PMIC_BQ25896::setEN_HIZ(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_EN_HIZ);
     ilim_reg_t temp_reg;
     _read(ILIM, (uint8_t*)&temp_reg);
     temp_reg.en_hiz = value;
     _write(ILIM, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setEN_ILIM(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_EN_ILIM);
     ilim_reg_t temp_reg;
     _read(ILIM, (uint8_t*)&temp_reg);
     temp_reg.en_ilim = value;
     _write(ILIM, (uint8_t*)&temp_reg);
 }
 bq25896_error_t PMIC_BQ25896::setIINLIM(int value){
-    ilim_reg_t temp_reg;
-    if(value < 100 && value > 3250){
+    if(!bq25896::Iinlim::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = value - 100;
-    data = (float)data/50.0;
+    setIINLIM(bq25896::Code<bq25896::Iinlim>(bq25896::Iinlim::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setIINLIM(bq25896::Milliamps value){
+    return setIINLIM((int)value.value);
+}
+void PMIC_BQ25896::setIINLIM(bq25896::Code<bq25896::Iinlim> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_IINLIM);
+    ilim_reg_t temp_reg;
     _read(ILIM, (uint8_t*)&temp_reg);
-    temp_reg.iinlim = data;
+    temp_reg.iinlim = code.value;
     _write(ILIM, (uint8_t*)&temp_reg);
-    return BQ_OK;    
 }
 uint16_t PMIC_BQ25896::getIINLIM(){
     ilim_reg_t temp_reg = PMIC_BQ25896::getILIM_reg();
-    uint16_t data = 100 + (temp_reg.iinlim * 50);
+    uint16_t data = bq25896::Iinlim::decode(temp_reg.iinlim);
     return data;
 }
 
@@ -107,9 +421,11 @@ vindpm_os_reg_t PMIC_BQ25896::getVINDPM_OS_reg(){
     _read(VINDPM_OS, (uint8_t*)&temp_reg);
     return temp_reg;
 }
+#if BQ25896_ENABLE_BOOST
 bq25896_error_t PMIC_BQ25896::setBHOT(int value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BHOT);
     vindpm_os_reg_t temp_reg;
-    if(value < 0 && value > 3){
+    if(value < 0 || value > 3){
         return BQ_RANGE_ERR;
     }
     _read(VINDPM_OS, (uint8_t*)&temp_reg);
@@ -118,25 +434,33 @@ bq25896_error_t PMIC_BQ25896::setBHOT(int value){
     return BQ_OK; 
 }
 void PMIC_BQ25896::setBCOLD(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BCOLD);
     vindpm_os_reg_t temp_reg;
     _read(VINDPM_OS, (uint8_t*)&temp_reg);
     temp_reg.bcold = value;
     _write(VINDPM_OS, (uint8_t*)&temp_reg);
 }
+#endif
 bq25896_error_t PMIC_BQ25896::setVINDPM_OS(int value){
-    vindpm_os_reg_t temp_reg;
-    if(value < 0 && value > 3100){
+    if(!bq25896::VindpmOs::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = (float)value / 100.0;
+    setVINDPM_OS(bq25896::Code<bq25896::VindpmOs>(bq25896::VindpmOs::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setVINDPM_OS(bq25896::Millivolts value){
+    return setVINDPM_OS((int)value.value);
+}
+void PMIC_BQ25896::setVINDPM_OS(bq25896::Code<bq25896::VindpmOs> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_VINDPM_OS);
+    vindpm_os_reg_t temp_reg;
     _read(VINDPM_OS, (uint8_t*)&temp_reg);
-    temp_reg.vindpm_os = data;
+    temp_reg.vindpm_os = code.value;
     _write(VINDPM_OS, (uint8_t*)&temp_reg);
-    return BQ_OK; 
 }
 uint16_t PMIC_BQ25896::getVINDPM_OS(){
     vindpm_os_reg_t temp_reg = PMIC_BQ25896::getVINDPM_OS_reg();
-    uint16_t data = temp_reg.vindpm_os * 100;
+    uint16_t data = bq25896::VindpmOs::decode(temp_reg.vindpm_os);
     return data;
 }
 
@@ -146,42 +470,82 @@ adc_ctrl_reg_t PMIC_BQ25896::getADC_CTRL_reg(){
     _read(ADC_CTRL, (uint8_t*)&temp_reg);
     return temp_reg;
 }
+#if BQ25896_ENABLE_ADC
 void PMIC_BQ25896::setCONV_START(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_CONV_START);
     adc_ctrl_reg_t temp_reg;
     _read(ADC_CTRL, (uint8_t*)&temp_reg);
     temp_reg.conv_start = value;
     _write(ADC_CTRL, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setCONV_RATE(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_CONV_RATE);
     adc_ctrl_reg_t temp_reg;
     _read(ADC_CTRL, (uint8_t*)&temp_reg);
     temp_reg.conv_rate = value;
     _write(ADC_CTRL, (uint8_t*)&temp_reg);
 }
+#endif
+#if BQ25896_ENABLE_BOOST
 void PMIC_BQ25896::setBOOST_FREQ(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BOOST_FREQ);
     adc_ctrl_reg_t temp_reg;
     _read(ADC_CTRL, (uint8_t*)&temp_reg);
     temp_reg.boost_freq = value;
     _write(ADC_CTRL, (uint8_t*)&temp_reg);
 }
+#endif
+#if BQ25896_ENABLE_ICO
 void PMIC_BQ25896::setICO_EN(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_ICO_EN);
     adc_ctrl_reg_t temp_reg;
     _read(ADC_CTRL, (uint8_t*)&temp_reg);
     temp_reg.ico_en = value;
     _write(ADC_CTRL, (uint8_t*)&temp_reg);
 }
+#endif
 void PMIC_BQ25896::setFORCE_DPDM(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_FORCE_DPDM);
     adc_ctrl_reg_t temp_reg;
     _read(ADC_CTRL, (uint8_t*)&temp_reg);
     temp_reg.force_dpdm = value;
     _write(ADC_CTRL, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setAUTO_DPDM_EN(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_AUTO_DPDM_EN);
     adc_ctrl_reg_t temp_reg;
     _read(ADC_CTRL, (uint8_t*)&temp_reg);
     temp_reg.auto_dpdm_en = value;
     _write(ADC_CTRL, (uint8_t*)&temp_reg);
 }
+#if BQ25896_VARIANT_HAS_HVDCP
+bq25896_error_t PMIC_BQ25896::setHVDCP_EN(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_HVDCP_EN);
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    if(!bq25896_variant_has_hvdcp(_variant)){
+        return BQ_RANGE_ERR;
+    }
+#endif
+    adc_ctrl_reg_t temp_reg;
+    _read(ADC_CTRL, (uint8_t*)&temp_reg);
+    temp_reg.hvdcp_en = value;
+    _write(ADC_CTRL, (uint8_t*)&temp_reg);
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setMAXC_EN(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_MAXC_EN);
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    if(!bq25896_variant_has_hvdcp(_variant)){
+        return BQ_RANGE_ERR;
+    }
+#endif
+    adc_ctrl_reg_t temp_reg;
+    _read(ADC_CTRL, (uint8_t*)&temp_reg);
+    temp_reg.maxc_en = value;
+    _write(ADC_CTRL, (uint8_t*)&temp_reg);
+    return BQ_OK;
+}
+#endif
 
 // REG03
 sys_ctrl_reg_t PMIC_BQ25896::getSYS_CTRL_reg(){
@@ -190,52 +554,66 @@ sys_ctrl_reg_t PMIC_BQ25896::getSYS_CTRL_reg(){
     return temp_reg;
 }
 void PMIC_BQ25896::setBAT_LOADEN(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BAT_LOADEN);
     sys_ctrl_reg_t temp_reg;
     _read(SYS_CTRL, (uint8_t*)&temp_reg);
     temp_reg.bat_loaden = value;
     _write(SYS_CTRL, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setWD_RST(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_WD_RST);
     sys_ctrl_reg_t temp_reg;
     _read(SYS_CTRL, (uint8_t*)&temp_reg);
     temp_reg.wd_rst = value;
     _write(SYS_CTRL, (uint8_t*)&temp_reg);
 }
+#if BQ25896_ENABLE_BOOST
 void PMIC_BQ25896::setOTG_CONFIG(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_OTG_CONFIG);
     sys_ctrl_reg_t temp_reg;
     _read(SYS_CTRL, (uint8_t*)&temp_reg);
     temp_reg.otg_config = value;
     _write(SYS_CTRL, (uint8_t*)&temp_reg);
 }
+#endif
 void PMIC_BQ25896::setCHG_CONFIG(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_CHG_CONFIG);
     sys_ctrl_reg_t temp_reg;
     _read(SYS_CTRL, (uint8_t*)&temp_reg);
     temp_reg.chg_config = value;
     _write(SYS_CTRL, (uint8_t*)&temp_reg);
 }
 bq25896_error_t PMIC_BQ25896::setSYS_MIN(int value){
-    sys_ctrl_reg_t temp_reg;
-    if(value < 3000 && value > 3700){
+    if(!bq25896::SysMin::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = value - 3000;
-    data = (float)data/100.0;
+    setSYS_MIN(bq25896::Code<bq25896::SysMin>(bq25896::SysMin::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setSYS_MIN(bq25896::Millivolts value){
+    return setSYS_MIN((int)value.value);
+}
+void PMIC_BQ25896::setSYS_MIN(bq25896::Code<bq25896::SysMin> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_SYS_MIN);
+    sys_ctrl_reg_t temp_reg;
     _read(SYS_CTRL, (uint8_t*)&temp_reg);
-    temp_reg.sys_min = data;
+    temp_reg.sys_min = code.value;
     _write(SYS_CTRL, (uint8_t*)&temp_reg);
-    return BQ_OK;
 }
 uint16_t PMIC_BQ25896::getSYS_MIN(){
     sys_ctrl_reg_t temp_reg = PMIC_BQ25896::getSYS_CTRL_reg();
-    uint16_t data = 3000 + (temp_reg.sys_min * 100);
+    uint16_t data = bq25896::SysMin::decode(temp_reg.sys_min);
     return data;
 }
+#if BQ25896_ENABLE_BOOST
 void PMIC_BQ25896::setMIN_VBAT_SEL(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_MIN_VBAT_SEL);
     sys_ctrl_reg_t temp_reg;
     _read(SYS_CTRL, (uint8_t*)&temp_reg);
     temp_reg.min_vbat_sel = value;
     _write(SYS_CTRL, (uint8_t*)&temp_reg);
 }
+#endif
 
 // REG04
 ichg_reg_t PMIC_BQ25896::getICHG_reg(){
@@ -243,26 +621,40 @@ ichg_reg_t PMIC_BQ25896::getICHG_reg(){
     _read(ICHG, (uint8_t*)&temp_reg);
     return temp_reg;
 }
+#if BQ25896_ENABLE_PUMPX
 void PMIC_BQ25896::setEN_PUMPX(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_EN_PUMPX);
     ichg_reg_t temp_reg;
     _read(ICHG, (uint8_t*)&temp_reg);
     temp_reg.en_pumpx = value;
     _write(ICHG, (uint8_t*)&temp_reg);
 }
+#endif
 bq25896_error_t PMIC_BQ25896::setICHG(int value){
-    ichg_reg_t temp_reg;
-    if(value < 0 && value > 3008){
+    if(!bq25896::Ichg::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = (float)value / 64.0;
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    if(value > bq25896_variant_ichg_max(_variant)){
+        return BQ_RANGE_ERR;
+    }
+#endif
+    setICHG(bq25896::Code<bq25896::Ichg>(bq25896::Ichg::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setICHG(bq25896::Milliamps value){
+    return setICHG((int)value.value);
+}
+void PMIC_BQ25896::setICHG(bq25896::Code<bq25896::Ichg> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_ICHG);
+    ichg_reg_t temp_reg;
     _read(ICHG, (uint8_t*)&temp_reg);
-    temp_reg.ichg = data;
+    temp_reg.ichg = code.value;
     _write(ICHG, (uint8_t*)&temp_reg);
-    return BQ_OK;
 }
 uint16_t PMIC_BQ25896::getICHG(){
     ichg_reg_t temp_reg = PMIC_BQ25896::getICHG_reg();
-    uint16_t data = temp_reg.ichg * 64;
+    uint16_t data = bq25896::Ichg::decode(temp_reg.ichg);
     return data;
 }
 
@@ -273,37 +665,47 @@ ipre_iterm_reg_t PMIC_BQ25896::getIPRE_ITERM_reg(){
     return temp_reg;
 }
 bq25896_error_t PMIC_BQ25896::setIPRECHG(int value){
-    ipre_iterm_reg_t temp_reg;
-    if(value < 64 && value > 1024){
+    if(!bq25896::Iprechg::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = value - 64.0;
-    data = (float)data / 64.0;
+    setIPRECHG(bq25896::Code<bq25896::Iprechg>(bq25896::Iprechg::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setIPRECHG(bq25896::Milliamps value){
+    return setIPRECHG((int)value.value);
+}
+void PMIC_BQ25896::setIPRECHG(bq25896::Code<bq25896::Iprechg> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_IPRECHG);
+    ipre_iterm_reg_t temp_reg;
     _read(IPRE_ITERM, (uint8_t*)&temp_reg);
-    temp_reg.iprechg = data;
+    temp_reg.iprechg = code.value;
     _write(IPRE_ITERM, (uint8_t*)&temp_reg);
-    return BQ_OK;
 }
 uint16_t PMIC_BQ25896::getIPRECHG(){
     ipre_iterm_reg_t temp_reg = PMIC_BQ25896::getIPRE_ITERM_reg();
-    uint16_t data = 64 + (temp_reg.iprechg * 64);
+    uint16_t data = bq25896::Iprechg::decode(temp_reg.iprechg);
     return data;
 }
 bq25896_error_t PMIC_BQ25896::setITERM(int value){
-    ipre_iterm_reg_t temp_reg;
-    if(value < 64 && value > 1024){
+    if(!bq25896::Iterm::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = value - 64.0;
-    data = (float)data / 64.0;
+    setITERM(bq25896::Code<bq25896::Iterm>(bq25896::Iterm::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setITERM(bq25896::Milliamps value){
+    return setITERM((int)value.value);
+}
+void PMIC_BQ25896::setITERM(bq25896::Code<bq25896::Iterm> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_ITERM);
+    ipre_iterm_reg_t temp_reg;
     _read(IPRE_ITERM, (uint8_t*)&temp_reg);
-    temp_reg.iterm = data;
+    temp_reg.iterm = code.value;
     _write(IPRE_ITERM, (uint8_t*)&temp_reg);
-    return BQ_OK;
 }
 uint16_t PMIC_BQ25896::getITERM(){
     ipre_iterm_reg_t temp_reg = PMIC_BQ25896::getIPRE_ITERM_reg();
-    uint16_t data = 64 + (temp_reg.iterm * 64);
+    uint16_t data = bq25896::Iterm::decode(temp_reg.iterm);
     return data;
 }
 
@@ -314,29 +716,36 @@ vreg_reg_t PMIC_BQ25896::getVREG_reg(){
     return temp_reg;
 }
 bq25896_error_t PMIC_BQ25896::setVREG(int value){
-    vreg_reg_t temp_reg;
-    if(value < 3840 && value > 4608){
+    if(!bq25896::Vreg::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = value - 3840.0;
-    data = (float)data / 16.0;
+    setVREG(bq25896::Code<bq25896::Vreg>(bq25896::Vreg::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setVREG(bq25896::Millivolts value){
+    return setVREG((int)value.value);
+}
+void PMIC_BQ25896::setVREG(bq25896::Code<bq25896::Vreg> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_VREG);
+    vreg_reg_t temp_reg;
     _read(VREG, (uint8_t*)&temp_reg);
-    temp_reg.vreg = data;
+    temp_reg.vreg = code.value;
     _write(VREG, (uint8_t*)&temp_reg);
-    return BQ_OK;
 }
 uint16_t PMIC_BQ25896::getVREG(){
     vreg_reg_t temp_reg = PMIC_BQ25896::getVREG_reg();
-    uint16_t data = 3840 + (temp_reg.vreg * 16);
+    uint16_t data = bq25896::Vreg::decode(temp_reg.vreg);
     return data;
 }
 void PMIC_BQ25896::setBATLOWV(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BATLOWV);
     vreg_reg_t temp_reg;
     _read(VREG, (uint8_t*)&temp_reg);
     temp_reg.batlowv = value;
     _write(VREG, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setVRECHG(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_VRECHG);
     vreg_reg_t temp_reg;
     _read(VREG, (uint8_t*)&temp_reg);
     temp_reg.vrechg = value;
@@ -350,20 +759,23 @@ timer_reg_t PMIC_BQ25896::getTIMER_reg(){
     return temp_reg;
 }
 void PMIC_BQ25896::setEN_TERM(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_EN_TERM);
     timer_reg_t temp_reg;
     _read(TIMER, (uint8_t*)&temp_reg);
     temp_reg.en_term = value;
     _write(TIMER, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setSTAT_DIS(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_STAT_DIS);
     timer_reg_t temp_reg;
     _read(TIMER, (uint8_t*)&temp_reg);
     temp_reg.stat_dis = value;
     _write(TIMER, (uint8_t*)&temp_reg);
 }
 bq25896_error_t PMIC_BQ25896::setWATCHDOG(int value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_WATCHDOG);
     timer_reg_t temp_reg;
-    if(value < 0 && value > 3){
+    if(value < 0 || value > 3){
         return BQ_RANGE_ERR;
     }
     _read(TIMER, (uint8_t*)&temp_reg);
@@ -372,14 +784,16 @@ bq25896_error_t PMIC_BQ25896::setWATCHDOG(int value){
     return BQ_OK;
 }
 void PMIC_BQ25896::setEN_TIMER(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_EN_TIMER);
     timer_reg_t temp_reg;
     _read(TIMER, (uint8_t*)&temp_reg);
     temp_reg.en_timer = value;
     _write(TIMER, (uint8_t*)&temp_reg);
 }
 bq25896_error_t PMIC_BQ25896::setCHG_TIMER(int value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_CHG_TIMER);
     timer_reg_t temp_reg;
-    if(value < 0 && value > 3){
+    if(value < 0 || value > 3){
         return BQ_RANGE_ERR;
     }
     _read(TIMER, (uint8_t*)&temp_reg);
@@ -388,6 +802,7 @@ bq25896_error_t PMIC_BQ25896::setCHG_TIMER(int value){
     return BQ_OK;
 }
 void PMIC_BQ25896::setJEITA_ISET(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_JEITA_ISET);
     timer_reg_t temp_reg;
     _read(TIMER, (uint8_t*)&temp_reg);
     temp_reg.jeita_iset = value;
@@ -401,11 +816,12 @@ bat_comp_reg_t PMIC_BQ25896::getBAT_COMP_reg(){
     return temp_reg;
 }
 bq25896_error_t PMIC_BQ25896::setBAT_COMP(int value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BAT_COMP);
     bat_comp_reg_t temp_reg;
-    if(value < 0 && value > 140){
+    if(value < 0 || value > 140){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = (float)value / 20.0;
+    uint16_t data = value / 20;
     _read(BAT_COMP, (uint8_t*)&temp_reg);
     temp_reg.bat_comp = data;
     _write(BAT_COMP, (uint8_t*)&temp_reg);
@@ -417,24 +833,31 @@ uint16_t PMIC_BQ25896::getBAT_COMP(){
     return data;
 }
 bq25896_error_t PMIC_BQ25896::setVCLAMP(int value){
-    bat_comp_reg_t temp_reg;
-    if(value < 0 && value > 224){
+    if(!bq25896::Vclamp::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = (float)value / 32.0;
+    setVCLAMP(bq25896::Code<bq25896::Vclamp>(bq25896::Vclamp::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setVCLAMP(bq25896::Millivolts value){
+    return setVCLAMP((int)value.value);
+}
+void PMIC_BQ25896::setVCLAMP(bq25896::Code<bq25896::Vclamp> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_VCLAMP);
+    bat_comp_reg_t temp_reg;
     _read(BAT_COMP, (uint8_t*)&temp_reg);
-    temp_reg.vclamp = data;
+    temp_reg.vclamp = code.value;
     _write(BAT_COMP, (uint8_t*)&temp_reg);
-    return BQ_OK;
 }
 uint16_t PMIC_BQ25896::getVCLAMP(){
     bat_comp_reg_t temp_reg = PMIC_BQ25896::getBAT_COMP_reg();
-    uint16_t data = temp_reg.vclamp * 32;
+    uint16_t data = bq25896::Vclamp::decode(temp_reg.vclamp);
     return data;
 }
 bq25896_error_t PMIC_BQ25896::setTREG(int value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_TREG);
     bat_comp_reg_t temp_reg;
-    if(value < 0 && value > 3){
+    if(value < 0 || value > 3){
         return BQ_RANGE_ERR;
     }
     _read(BAT_COMP, (uint8_t*)&temp_reg);
@@ -449,55 +872,68 @@ ctrl1_reg_t PMIC_BQ25896::getCTRL1_reg(){
     _read(CTRL1, (uint8_t*)&temp_reg);
     return temp_reg;
 }
+#if BQ25896_ENABLE_ICO
 void PMIC_BQ25896::setFORCE_ICO(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_FORCE_ICO);
     ctrl1_reg_t temp_reg;
     _read(CTRL1, (uint8_t*)&temp_reg);
     temp_reg.force_ico = value;
     _write(CTRL1, (uint8_t*)&temp_reg);
 }
+#endif
 void PMIC_BQ25896::setTMR2X_EN(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_TMR2X_EN);
     ctrl1_reg_t temp_reg;
     _read(CTRL1, (uint8_t*)&temp_reg);
     temp_reg.tmr2x_en = value;
     _write(CTRL1, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setBATFET_DIS(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BATFET_DIS);
     ctrl1_reg_t temp_reg;
     _read(CTRL1, (uint8_t*)&temp_reg);
     temp_reg.batfet_dis = value;
     _write(CTRL1, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setJEITA_VSET(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_JEITA_VSET);
     ctrl1_reg_t temp_reg;
     _read(CTRL1, (uint8_t*)&temp_reg);
     temp_reg.jeita_vset = value;
     _write(CTRL1, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setBATFET_DLY(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BATFET_DLY);
     ctrl1_reg_t temp_reg;
     _read(CTRL1, (uint8_t*)&temp_reg);
     temp_reg.batfet_dly = value;
     _write(CTRL1, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setBATFET_RST_EN(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BATFET_RST_EN);
     ctrl1_reg_t temp_reg;
     _read(CTRL1, (uint8_t*)&temp_reg);
     temp_reg.batfet_rst_en = value;
     _write(CTRL1, (uint8_t*)&temp_reg);
 }
+#if BQ25896_ENABLE_PUMPX
 void PMIC_BQ25896::setPUMPX_UP(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_PUMPX_UP);
     ctrl1_reg_t temp_reg;
     _read(CTRL1, (uint8_t*)&temp_reg);
     temp_reg.pumpx_up = value;
     _write(CTRL1, (uint8_t*)&temp_reg);
 }
 void PMIC_BQ25896::setPUMPX_DN(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_PUMPX_DN);
     ctrl1_reg_t temp_reg;
     _read(CTRL1, (uint8_t*)&temp_reg);
     temp_reg.pumpx_dn = value;
     _write(CTRL1, (uint8_t*)&temp_reg);
 }
+#endif
 
+#if BQ25896_ENABLE_BOOST
 // REG0A
 boost_ctrl_reg_t PMIC_BQ25896::getBOOST_CTRL_reg(){
     boost_ctrl_reg_t temp_reg;
@@ -505,31 +941,38 @@ boost_ctrl_reg_t PMIC_BQ25896::getBOOST_CTRL_reg(){
     return temp_reg;
 }
 bq25896_error_t PMIC_BQ25896::setBOOSTV(int value){
-    boost_ctrl_reg_t temp_reg;
-    if(value < 4550 && value > 5510){
+    if(!bq25896::Boostv::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = value - 4550.0;
-    data = (float)data / 64.0;
+    setBOOSTV(bq25896::Code<bq25896::Boostv>(bq25896::Boostv::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setBOOSTV(bq25896::Millivolts value){
+    return setBOOSTV((int)value.value);
+}
+void PMIC_BQ25896::setBOOSTV(bq25896::Code<bq25896::Boostv> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BOOSTV);
+    boost_ctrl_reg_t temp_reg;
     _read(BOOST_CTRL, (uint8_t*)&temp_reg);
-    temp_reg.boostv = data;
+    temp_reg.boostv = code.value;
     _write(BOOST_CTRL, (uint8_t*)&temp_reg);
-    return BQ_OK;
 }
 uint16_t PMIC_BQ25896::getBOOSTV(){
     boost_ctrl_reg_t temp_reg = PMIC_BQ25896::getBOOST_CTRL_reg();
-    uint16_t data = 4550 + (temp_reg.boost_lim * 64);
+    uint16_t data = bq25896::Boostv::decode(temp_reg.boostv);
     return data;
 }
 void PMIC_BQ25896::setPFM_OTG_DIS(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_PFM_OTG_DIS);
     boost_ctrl_reg_t temp_reg;
     _read(BOOST_CTRL, (uint8_t*)&temp_reg);
     temp_reg.pfm_otg_dis = value;
     _write(BOOST_CTRL, (uint8_t*)&temp_reg);
 }
 bq25896_error_t PMIC_BQ25896::setBOOST_LIM(int value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_BOOST_LIM);
     boost_ctrl_reg_t temp_reg;
-    if(value < 0 && value > 6){
+    if(value < 0 || value > 6){
         return BQ_RANGE_ERR;
     }
     _read(BOOST_CTRL, (uint8_t*)&temp_reg);
@@ -566,6 +1009,7 @@ uint16_t PMIC_BQ25896::getBOOST_LIM(){
         return 0;
     }
 }
+#endif
 
 // REG0B
 vbus_stat_reg_t PMIC_BQ25896::get_VBUS_STAT_reg(){
@@ -578,8 +1022,56 @@ vbus_stat_reg_t PMIC_BQ25896::get_VBUS_STAT_reg(){
 fault_reg_t PMIC_BQ25896::getFAULT_reg(){
     fault_reg_t temp_reg;
     _read(FAULT, (uint8_t*)&temp_reg);
+    _recordFault(temp_reg);
     return temp_reg;
 }
+bool PMIC_BQ25896::serviceFAULT(){
+    fault_reg_t temp_reg = PMIC_BQ25896::getFAULT_reg();
+    return bq25896_raw(temp_reg) != 0;
+}
+void PMIC_BQ25896::clearFAULT_record(){
+    memset(&_fault_record, 0, sizeof(_fault_record));
+}
+void PMIC_BQ25896::_recordFault(fault_reg_t fault){
+    bq25896_fault_record_t &rec = _fault_record;
+    rec.read_count++;
+    if(bq25896_raw(fault) == 0){
+        return;
+    }
+    uint32_t now = millis();
+    if(rec.history_len == 0){
+        rec.first_timestamp = now;
+    }
+    rec.last_timestamp = now;
+
+    if(fault.ntc_fault){
+        rec.sticky.ntc_fault = fault.ntc_fault;
+        rec.ntc_count++;
+    }
+    if(fault.chrg_fault){
+        rec.sticky.chrg_fault = fault.chrg_fault;
+        rec.chrg_count++;
+    }
+    if(fault.bat_fault){
+        rec.sticky.bat_fault = 1;
+        rec.bat_count++;
+    }
+    if(fault.boost_fault){
+        rec.sticky.boost_fault = 1;
+        rec.boost_count++;
+    }
+    if(fault.watchdog_fault){
+        rec.sticky.watchdog_fault = 1;
+        rec.watchdog_count++;
+    }
+
+    rec.history[rec.head].timestamp = now;
+    rec.history[rec.head].fault = fault;
+    rec.head = (rec.head + 1) % BQ25896_FAULT_HISTORY_LEN;
+    if(rec.history_len < BQ25896_FAULT_HISTORY_LEN){
+        rec.history_len++;
+    }
+}
 
 // REG0D
 vindpm_reg_t PMIC_BQ25896::getVINDPM_reg(){
@@ -588,29 +1080,43 @@ vindpm_reg_t PMIC_BQ25896::getVINDPM_reg(){
     return temp_reg;
 }
 void PMIC_BQ25896::setFORCE_VINDPM(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_FORCE_VINDPM);
     vindpm_reg_t temp_reg;
     _read(VINDPM, (uint8_t*)&temp_reg);
     temp_reg.force_vindpm = value;
     _write(VINDPM, (uint8_t*)&temp_reg);
 }
 bq25896_error_t PMIC_BQ25896::setVINDPM(int value){
-    vindpm_reg_t temp_reg;
-    if(value < 3900 && value > 15300){
+    if(!bq25896::Vindpm::in_range(value)){
         return BQ_RANGE_ERR;
     }
-    uint16_t data = value - 2600.0;
-    data = (float)data / 100.0;
+    setVINDPM(bq25896::Code<bq25896::Vindpm>(bq25896::Vindpm::raw(value)));
+    return BQ_OK;
+}
+bq25896_error_t PMIC_BQ25896::setVINDPM(bq25896::Millivolts value){
+    return setVINDPM((int)value.value);
+}
+void PMIC_BQ25896::setVINDPM(bq25896::Code<bq25896::Vindpm> code){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_VINDPM);
+    vindpm_reg_t temp_reg;
     _read(VINDPM, (uint8_t*)&temp_reg);
-    temp_reg.vindpm = data;
+    temp_reg.vindpm = code.value;
     _write(VINDPM, (uint8_t*)&temp_reg);
-    return BQ_OK;
 }
 uint16_t PMIC_BQ25896::getVINDPM(){
     vindpm_reg_t temp_reg = PMIC_BQ25896::getVINDPM_reg();
-    uint16_t data = 2600 + (temp_reg.vindpm * 100);
+    uint16_t data = bq25896::Vindpm::decode(temp_reg.vindpm);
     return data;
 }
 
+#if BQ25896_ENABLE_ADC
+void PMIC_BQ25896::setCALIBRATION(const bq25896_cal_t *cal){
+    _cal = cal ? cal : &bq25896_cal_identity;
+}
+const bq25896_cal_t &PMIC_BQ25896::getCALIBRATION(){
+    return *_cal;
+}
+
 // REG0E
 batv_reg_t PMIC_BQ25896::getBATV_reg(){
     batv_reg_t temp_reg;
@@ -619,7 +1125,7 @@ batv_reg_t PMIC_BQ25896::getBATV_reg(){
 }
 uint16_t PMIC_BQ25896::getBATV(){
     batv_reg_t temp_reg = PMIC_BQ25896::getBATV_reg();
-    uint16_t data = 2304 + (temp_reg.batv * 20);
+    uint16_t data = bq25896_decode_batv(temp_reg.batv, *_cal);
     return data;
 }
 
@@ -632,7 +1138,7 @@ sysv_reg_t PMIC_BQ25896::getSYSV_reg(){
 }
 uint16_t PMIC_BQ25896::getSYSV(){
     sysv_reg_t temp_reg = PMIC_BQ25896::getSYSV_reg();
-    uint16_t data = 2304 + (temp_reg.sysv * 20);
+    uint16_t data = bq25896_decode_sysv(temp_reg.sysv, *_cal);
     return data;
 }
 
@@ -644,9 +1150,21 @@ tspct_reg_t PMIC_BQ25896::getTSPCT_reg(){
 }
 uint16_t PMIC_BQ25896::getTSPCT(){
     tspct_reg_t temp_reg = PMIC_BQ25896::getTSPCT_reg();
-    uint16_t data = 21 + ((float)temp_reg.tspct * 0.465);
+    uint16_t data = bq25896_decode_tspct(temp_reg.tspct);
     return data;
 }
+void PMIC_BQ25896::setNTC_LUT(const bq25896_ntc_lut_t *lut){
+    _ntc_lut = lut ? lut : &bq25896_ntc_default_lut;
+}
+int16_t PMIC_BQ25896::getBatteryTemperature(){
+    tspct_reg_t temp_reg = PMIC_BQ25896::getTSPCT_reg();
+    int16_t data = bq25896_ntc_decode(*_ntc_lut, temp_reg.tspct);
+    return data;
+}
+bq25896_jeita_zone_t PMIC_BQ25896::getJEITA_ZONE(){
+    tspct_reg_t temp_reg = PMIC_BQ25896::getTSPCT_reg();
+    return bq25896_jeita_zone(temp_reg.tspct);
+}
 
 // REG11
 vbusv_reg_t PMIC_BQ25896::getVBUSV_reg(){
@@ -656,7 +1174,7 @@ vbusv_reg_t PMIC_BQ25896::getVBUSV_reg(){
 }
 uint16_t PMIC_BQ25896::getVBUSV(){
     vbusv_reg_t temp_reg = PMIC_BQ25896::getVBUSV_reg();
-    uint16_t data = 2600 + (temp_reg.vbusv * 100);
+    uint16_t data = bq25896_decode_vbusv(temp_reg.vbusv, *_cal);
     return data;
 }
 
@@ -668,9 +1186,10 @@ ichgr_reg_t PMIC_BQ25896::getICHGR_reg(){
 }
 uint16_t PMIC_BQ25896::getICHGR(){
     ichgr_reg_t temp_reg = PMIC_BQ25896::getICHGR_reg();
-    uint16_t data = temp_reg.ichgr * 50;
+    uint16_t data = bq25896_decode_ichgr(temp_reg.ichgr, *_cal);
     return data;
 }
+#endif
 
 // REG13
 idpm_lim_reg_t PMIC_BQ25896::getIDPM_LIM_reg(){
@@ -678,6 +1197,13 @@ idpm_lim_reg_t PMIC_BQ25896::getIDPM_LIM_reg(){
     _read(IDPM_LIM, (uint8_t*)&temp_reg);
     return temp_reg;
 }
+#if BQ25896_ENABLE_ICO
+uint16_t PMIC_BQ25896::getIDPM_LIM(){
+    idpm_lim_reg_t temp_reg = PMIC_BQ25896::getIDPM_LIM_reg();
+    uint16_t data = bq25896_decode_idpm_lim(temp_reg.idpm_lim);
+    return data;
+}
+#endif
 
 // REG14
 ctrl2_reg_t PMIC_BQ25896::getCTRL2_reg(){
@@ -687,6 +1213,7 @@ ctrl2_reg_t PMIC_BQ25896::getCTRL2_reg(){
 }
 
 void PMIC_BQ25896::setREG_RST(bool value){
+    BQ25896_TRACEPOINT(BQ25896_TP_SETTER, BQ25896_F_REG_RST);
     ctrl2_reg_t temp_reg;
 
     _read(CTRL2, (uint8_t*)&temp_reg);
@@ -31,455 +31,103 @@
 
 #include "Arduino.h"
 #include "Wire.h"
-
-typedef enum {
-    BQ25896_ADDR = 0x6B
-} bq25896_addr_t;
-
-typedef enum {
-    ILIM        = 0x00,
-    VINDPM_OS   = 0x01,
-    ADC_CTRL    = 0x02,
-    SYS_CTRL    = 0x03,
-    ICHG        = 0x04,
-    IPRE_ITERM  = 0x05,
-    VREG        = 0x06,
-    TIMER       = 0x07,
-    BAT_COMP    = 0x08,
-    CTRL1       = 0x09,
-    BOOST_CTRL  = 0x0A,
-    VBUS_STAT   = 0x0B,
-    FAULT       = 0x0C,
-    VINDPM      = 0x0D,
-    BATV        = 0x0E,
-    SYSV        = 0x0F,
-    TSPCT       = 0x10,
-    VBUSV       = 0x11,
-    ICHGR       = 0x12,
-    IDPM_LIM    = 0x13,
-    CTRL2       = 0x14
-} bq25896_reg_t;
-
-typedef enum {
-    BQ_OK = 0x00,
-    BQ_RANGE_ERR
-} bq25896_error_t;
-
-typedef struct {
-    // Input Current Limit
-    // Offset: 100mA 
-    // Range: 100mA (000000) – 3.25A (111111) (LSB = 50mA)
-    // Default:0001000 (500mA)
-    // (Actual input current limit is the lower of I2C or ILIM pin, changes with input type detection)
-    uint8_t iinlim:6;
-    // Enable ILIM Pin
-    // 0 – Disable
-    // 1 – Enable (default: Enable ILIM pin (1))
-    uint8_t en_ilim:1;
-    // Enable HIZ Mode
-    // 0 - Disable (default)
-    // 1 - Enable
-    uint8_t en_hiz:1;
-} ilim_reg_t __attribute__(());
-
-typedef struct {
-    // Input Voltage Limit Offset
-    // Default: 600mV (00110)
-    // Range: 0mV (00000) – 3100mV (11111) (LSB = 100mV)
-    // Minimum VINDPM threshold is clamped at 3.9V
-    // Maximum VINDPM threshold is clamped at 15.3V
-    uint8_t vindpm_os:5;
-    // Boost Mode Cold Temperature Monitor Threshold
-    // 0 – VBCOLD0 Threshold (Typ. 77%) (default)
-    // 1 – VBCOLD1 Threshold (Typ. 80%)
-    uint8_t bcold:1;
-    // Boost Mode Hot Temperature Monitor Threshold
-    // 00 – VBHOT1 Threshold (34.75%) (default)
-    // 01 – VBHOT0 Threshold (Typ. 37.75%)
-    // 10 – VBHOT2 Threshold (Typ. 31.25%)
-    // 11 – Disable boost mode thermal protection
-    uint8_t bhot:2;
-} vindpm_os_reg_t __attribute__(());
-
-typedef struct {
-    // Automatic Input Detection Enable
-    // 0 – Disable PSEL detection when VBUS is plugged-in
-    // 1 – Enable PEL detection when VBUS is plugged-in (default)
-    uint8_t auto_dpdm_en:1;
-    // Force Input Detection
-    // 0 – Not in PSEL detection (default)
-    // 1 – Force PSEL detection
-    uint8_t force_dpdm:1;
-    // Reserved - both bits defualt to 0
-    uint8_t reserved:2;
-    // Input Current Optimizer (ICO) Enable
-    // 0 – Disable ICO Algorithm
-    // 1 – Enable ICO Algorithm (default)
-    uint8_t ico_en:1;
-    // Boost Mode Frequency Selection
-    // 0 – 1.5MHz (default)
-    // 1 – 500KHz
-    // Note: Write to this bit is ignored when OTG_CONFIG is enabled.
-    uint8_t boost_freq:1;
-    // ADC Conversion Rate Selection
-    // 0 – One shot ADC conversion (default)
-    // 1 – Start 1s Continuous Conversion
-    uint8_t conv_rate:1;
-    // ADC Conversion Start Control
-    // 0 – ADC conversion not active (default).
-    // 1 – Start ADC Conversion
-    // This bit is read-only when CONV_RATE = 1. The bit stays high during ADC conversion and during input source detection.
-    uint8_t conv_start:1;
-} adc_ctrl_reg_t __attribute__(());
-
-typedef struct {
-    // Minimum Battery Voltage (falling) to exit boost mode
-    // 0 - 2.9V (default)
-    // 1 - 2.5V
-    uint8_t min_vbat_sel:1;
-    // Minimum System Voltage Limit
-    // Offset: 3.0V
-    // Range 3.0V (000) - 3.7V (111) (LSB = 0.1V)
-    // Default: 3.5V (101)
-    uint8_t sys_min:3;
-    // Charge Enable Configuration
-    // 0 - Charge Disable
-    // 1 - Charge Enable (default)
-    uint8_t chg_config:1;
-    // Boost (OTG) Mode Configuration
-    // 0 – OTG Disable (default)
-    // 1 – OTG Enable
-    uint8_t otg_config:1;
-    // I2C Watchdog Timer Reset
-    // 0 – Normal (default)
-    // 1 – Reset (Back to 0 after timer reset)
-    uint8_t wd_rst:1;
-    // Battery Load (IBATLOAD) Enable
-    // 0 – Disabled (default)
-    // 1 – Enabled
-    uint8_t bat_loaden:1;
-} sys_ctrl_reg_t __attribute__(());
-
-typedef struct {
-    // Fast Charge Current Limit
-    // Offset: 0mA
-    // Range: 0mA (0000000) – 3008mA (0101111) (LSB = 64mA)
-    // Default: 2048mA (0100000)
-    // Note: ICHG=000000 (0mA) disables charge
-    // Note: ICHG > 0101111 (3008mA) is clamped to register value 0101111 (3008mA)
-    uint8_t ichg:7;
-    // Current pulse control Enable
-    // 0 - Disable Current pulse control (default)
-    // 1- Enable Current pulse control (PUMPX_UP and PUMPX_DN)
-    uint8_t en_pumpx:1;
-} ichg_reg_t __attribute__(());
-
-typedef struct {
-    // Termination Current Limit
-    // Offset: 64mA
-    // Range: 64mA (0000) – 1024mA (1111) (LSB = 64mA)
-    // Default: 256mA (0011)
-    uint8_t iterm:4;
-    // Precharge Current Limit
-    // Offset: 64mA
-    // Range: 64mA (0000) – 1024mA (1111) (LSB = 64mA)
-    // Default: 128mA (0001)
-    uint8_t iprechg:4;
-} ipre_iterm_reg_t __attribute__(());
-
-typedef struct {
-    // Battery Recharge Threshold Offset (below Charge Voltage Limit)
-    // 0 – 100mV (VRECHG) below VREG (REG06[7:2]) (default)
-    // 1 – 200mV (VRECHG) below VREG (REG06[7:2])
-    uint8_t vrechg:1;
-    // Battery Precharge to Fast Charge Threshold
-    // 0 – 2.8V
-    // 1 – 3.0V (default)
-    uint8_t batlowv:1;
-    // Charge Voltage Limit
-    // Offset: 3.840V
-    // Range: 3.840V (00000) – 4.608V (110000) (LSB = 16mV)
-    // Default: 4.208V (010111)
-    // Note: VREG > 110000 (4.608V) is clamped to register value 110000 (4.608V)
-    uint8_t vreg:6;
-} vreg_reg_t __attribute__(());
-
-typedef struct {
-    // JEITA Low Temperature Current Setting
-    // 0 – 50% of ICHG (REG04[6:0])
-    // 1 – 20% of ICHG (REG04[6:0]) (default)
-    uint8_t jeita_iset:1;
-    // Fast Charge Timer Setting
-    // 00 – 5 hrs
-    // 01 – 8 hrs
-    // 10 – 12 hrs (default)
-    // 11 – 20 hrs
-    uint8_t chg_timer:2;
-    // Charging Safety Timer Enable
-    // 0 – Disable
-    // 1 – Enable (default)
-    uint8_t en_timer:1;
-    // I2C Watchdog Timer Setting
-    // 00 – Disable watchdog timer
-    // 01 – 40s (default)
-    // 10 – 80s
-    // 11 – 160s
-    uint8_t watchdog:2;
-    // STAT Pin Disable
-    // 0 – Enable STAT pin function (default)
-    // 1 – Disable STAT pin function
-    uint8_t stat_dis:1;
-    // Charging Termination Enable
-    // 0 – Disable
-    // 1 – Enable (default)
-    uint8_t en_term:1;
-} timer_reg_t __attribute__(());
-
-typedef struct {
-    // Thermal Regulation Threshold
-    // 00 – 60°C
-    // 01 – 80°C
-    // 10 – 100°C
-    // 11 – 120°C (default)
-    uint8_t treg:2;
-    // IR Compensation Voltage Clamp
-    // above VREG (REG06[7:2])
-    // Offset: 0mV
-    // Range: 0mV (000) - 224mV (111) (LSB = 32mV)
-    // Default: 0mV (000)
-    uint8_t vclamp:3;
-    // IR Compensation Resistor Setting
-    // Range: 0mΩ (000) – 140mΩ (111) (LSB = 20mΩ)
-    // Default: 0Ω (000) (i.e. Disable IRComp)
-    uint8_t bat_comp:3;
-} bat_comp_reg_t __attribute__(());
-
-typedef struct {
-    // Current pulse control voltage down enable
-    // 0 – Disable (default)
-    // 1 – Enable
-    // Note: This bit is can only be set when EN_PUMPX bit is set and returns to 0 after current pulse control sequence is completed
-    uint8_t pumpx_dn:1;
-    // Current pulse control voltage up enable
-    // 0 – Disable (default)
-    // 1 – Enable
-    // Note: This bit is can only be set when EN_PUMPX bit is set and returns to 0 after current pulse control sequence is completed
-    uint8_t pumpx_up:1;
-    // BATFET full system reset enable
-    // 0 – Disable BATFET full system reset
-    // 1 – Enable BATFET full system reset (default)
-    uint8_t batfet_rst_en:1;
-    // BATFET turn off delay control
-    // 0 – BATFET turn off immediately when BATFET_DIS bit is set (default)
-    // 1 – BATFET turn off delay by tSM_DLY when BATFET_DIS bit is set
-    uint8_t batfet_dly:1;
-    // JEITA High Temperature Voltage Setting
-    // 0 – Set Charge Voltage to VREG-200mV during JEITA hig temperature (default)
-    // 1 – Set Charge Voltage to VREG during JEITA high temperature
-    uint8_t jeita_vset:1;
-    // Force BATFET off to enable ship mode
-    // 0 – Allow BATFET turn on (default)
-    // 1 – Force BATFET off
-    uint8_t batfet_dis:1;
-    // Safety Timer Setting during DPM or Thermal Regulation
-    // 0 – Safety timer not slowed by 2X during input DPM or thermal regulation
-    // 1 – Safety timer slowed by 2X during input DPM or thermal regulation (default)
-    uint8_t tmr2x_en:1;
-    // Force Start Input Current Optimizer (ICO)
-    // 0 – Do not force ICO (default)
-    // 1 – Force ICO
-    // Note: This bit is can only be set only and always returns to 0 after ICO starts
-    uint8_t force_ico:1;
-} ctrl1_reg_t __attribute__(());
+#include "PMIC_BQ25896_config.h"
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_units.h"
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_regmap.h"
+#include "PMIC_BQ25896_ntc.h"
+#include "PMIC_BQ25896_trace.h"
+#include "PMIC_BQ25896_tracepoint.h"
+
+// Number of fault events kept in the fault history ring
+#ifndef BQ25896_FAULT_HISTORY_LEN
+#define BQ25896_FAULT_HISTORY_LEN 8
+#endif
 
 typedef struct {
-    // Boost Mode Current Limit
-    // 000: 0.5A
-    // 001: 0.75A
-    // 010: 1.2A
-    // 011: 1.4A (default)
-    // 100: 1.65A
-    // 101: 1.875A
-    // 110: 2.15A
-    // 111: Reserved
-    uint8_t boost_lim:3;
-    // PFM mode allowed in boost mode
-    // 0 – Allow PFM in boost mode (default)
-    // 1 – Disable PFM in boost mode
-    uint8_t pfm_otg_dis:1;
-    // Boost Mode Voltage Regulation
-    // Offset: 4.55V
-    // Range: 4.55V (0000) – 5.51V (1111) (LSB = 64mV)
-    // Default: 4.998V (0111)
-    uint8_t boostv:4;
-} boost_ctrl_reg_t __attribute__(());
+    // millis() at the time REG0C was read
+    uint32_t timestamp;
+    // REG0C as read from the device
+    fault_reg_t fault;
+} bq25896_fault_event_t;
 
 typedef struct {
-    // VSYS Regulation Status
-    // 0 – Not in VSYSMIN regulation (BAT > VSYSMIN)
-    // 1 – In VSYSMIN regulation (BAT < VSYSMIN)
-    uint8_t vsys_stat:1;
-    // Reserved - always reads 1
-    uint8_t reserved:1;
-    // Power Good Status
-    // 0 – Not Power Good
-    // 1 – Power Good
-    uint8_t pg_stat:1;
-    // Charging Status
-    // 00 – Not Charging
-    // 01 – Pre-charge ( < VBATLOWV)
-    // 10 – Fast Charging
-    // 11 – Charge Termination Done
-    uint8_t chrg_stat:2;
-    // VBUS Status register
-    // 000: No Input
-    // 001: USB Host SDP
-    // 010: Adapter (3.25A)
-    // 111: OTG
-    // Note: Software current limit is reported in IINLIM register
-    uint8_t vbus_stat:3;
-} vbus_stat_reg_t __attribute__(());
-
+    // Sticky fault state since the last clearFAULT_record()
+    // Single bit faults (bat, boost, watchdog) are ORed in,
+    // ntc_fault and chrg_fault hold the last non-normal code seen
+    fault_reg_t sticky;
+    // millis() of the first and the most recent faulty REG0C read
+    uint32_t first_timestamp;
+    uint32_t last_timestamp;
+    // Number of REG0C reads reporting each fault
+    uint16_t ntc_count;
+    uint16_t bat_count;
+    uint16_t chrg_count;
+    uint16_t boost_count;
+    uint16_t watchdog_count;
+    // Number of REG0C reads done by the driver
+    uint16_t read_count;
+    // Ring of the most recent faulty REG0C reads, oldest at history[(head + BQ25896_FAULT_HISTORY_LEN - history_len) % BQ25896_FAULT_HISTORY_LEN]
+    bq25896_fault_event_t history[BQ25896_FAULT_HISTORY_LEN];
+    uint8_t head;
+    uint8_t history_len;
+} bq25896_fault_record_t;
+
+// Charging parameters written together by applyPROFILE()
+// Units and ranges are those of the matching setters
 typedef struct {
-    // NTC Fault Status
-    // Buck Mode:
-    // 000 – Normal
-    // 010 – TS Warm
-    // 011 – TS Cool
-    // 101 – TS Cold
-    // 110 – TS Hot
-    // Boost Mode:
-    // 000 – Normal
-    // 101 – TS Cold
-    // 110 – TS Hot
-    uint8_t ntc_fault:3;
-    // Battery Fault Status
-    // 0 – Normal
-    // 1 – BATOVP (VBAT > VBATOVP)
-    uint8_t bat_fault:1;
-    // Charge Fault Status
-    // 00 – Normal
-    // 01 – Input fault (VBUS > VACOV or VBAT < VBUS < VVBUSMIN(typical 3.8V))
-    // 10 - Thermal shutdown
-    // 11 – Charge Safety Timer Expiration
-    uint8_t chrg_fault:2;
-    // Boost Mode Fault Status
-    // 0 – Normal
-    // 1 – VBUS overloaded in OTG, or VBUS OVP, or battery is too low in boost mode
-    uint8_t boost_fault:1;
-    // Watchdog Fault Status
-    // 0 – Normal
-    // 1 - Watchdog timer expiration
-    uint8_t watchdog_fault:1;
-} fault_reg_t __attribute__(());
-
-typedef struct {
-    // Absolute VINDPM Threshold
-    // Offset: 2.6V
-    // Range: 3.9V (0001101) – 15.3V (1111111) (LSB = 100mV)
-    // Default: 4.4V (0010010)
-    // Note: Value < 0001101 is clamped to 3.9V (0001101)
-    // Register is read only when FORCE_VINDPM=0 and can be written by internal control based on relative VINDPM threshold setting
-    // Register can be read/write when FORCE_VINDPM = 1
-    // Note: Register is reset to default value when input source is plugged-in
-    uint8_t vindpm:7;
-    // VINDPM Threshold Setting Method
-    // 0 – Run Relative VINDPM Threshold (default)
-    // 1 – Run Absolute VINDPM Threshold
-    // Note: Register is reset to default value when input source is plugged-in
-    uint8_t force_vindpm:1;
-} vindpm_reg_t __attribute__(());
-
-typedef struct {
-    // ADC conversion of Battery Voltage (VBAT)
-    // Offset: 2304mV
-    // Range: 2304mV (0000000) – 4848mV (1111111) (LSB = 20mV)
-    // Default: 2304mV (0000000)
-    uint8_t batv:7;
-    // Thermal Regulation Status
-    // 0 – Normal
-    // 1 – In Thermal Regulation
-    uint8_t therm_stat:1;
-} batv_reg_t __attribute__(());
-
-typedef struct {
-    // ADC conversion of System Voltage (VSYS)
-    // Offset: 2304mV
-    // Range: 2304mV (0000000) – 4848mV (1111111) (LSB = 20mV)
-    // Default: 2304mV (0000000)
-    uint8_t sysv:7;
-    // Reserved - always reads 0
-    uint8_t reserved:1;
-} sysv_reg_t __attribute__(());
-
-typedef struct {
-    // ADC conversion of TS Voltage (TS) as percentage of REGN
-    // Offset: 21%
-    // Range 21% (0000000) – 80% (1111111) (LSB = 0.465%)
-    // Default: 21% (0000000)
-    uint8_t tspct:7;
-    // Reserved - always reads 0
-    uint8_t reserved:1;
-} tspct_reg_t __attribute__(());
-
-typedef struct {
-    // ADC conversion of VBUS voltage (VBUS)
-    // Offset: 2600mV
-    // Range 2600mV (0000000) – 15300mV (1111111) (LSB = 100mV)
-    // Default: 2600mV (0000000)
-    uint8_t vbusv:7;
-    // VBUS Good Status
-    // 0 – Not VBUS attached
-    // 1 – VBUS Attached
-    uint8_t vbus_gd:1;
-} vbusv_reg_t __attribute__(());
-
-typedef struct {
-    // ADC conversion of Charge Current (IBAT) when VBAT > VBATSHORT
-    // Offset: 0mA
-    // Range 0mA (0000000) – 6350mA (1111111) (LSB = 50mA)
-    // Default: 0mA (0000000)
-    // Note: This register returns 0000000 for VBAT < VBATSHORT
-    uint8_t ichgr:7;
-    // Unused - always reads 0
-    uint8_t unused:1;
-} ichgr_reg_t __attribute__(());
+    // Input Current Limit in mA, 100 - 3250 (REG00)
+    uint16_t iinlim;
+    // Minimum System Voltage in mV, 3000 - 3700 (REG03)
+    uint16_t sys_min;
+    // Fast Charge Current Limit in mA, 0 - 3008 (REG04)
+    uint16_t ichg;
+    // Precharge and Termination Current in mA, 64 - 1024 (REG05)
+    uint16_t iprechg;
+    uint16_t iterm;
+    // Charge Voltage Limit in mV, 3840 - 4608 (REG06)
+    uint16_t vreg;
+} bq25896_profile_t;
+
+#if BQ25896_ENABLE_CACHE
+// Register blocks of the read-through cache, each refreshed with one burst
+typedef enum {
+    // REG00 - REG0A, changed by the charger only on input detection, ICO
+    // and watchdog expiry
+    BQ25896_CACHE_CONFIG = 0,
+    // REG0B
+    BQ25896_CACHE_STATUS,
+    // REG0D - REG13, VINDPM is set by the charger unless FORCE_VINDPM
+    BQ25896_CACHE_ADC,
+    BQ25896_CACHE_GROUPS
+} bq25896_cache_group_t;
+
+// Max age that never expires
+#define BQ25896_CACHE_FOREVER 0xFFFFFFFFUL
+
+// Default max ages in ms
+#ifndef BQ25896_CACHE_CONFIG_AGE_MS
+#define BQ25896_CACHE_CONFIG_AGE_MS BQ25896_CACHE_FOREVER
+#endif
+#ifndef BQ25896_CACHE_STATUS_AGE_MS
+#define BQ25896_CACHE_STATUS_AGE_MS 100
+#endif
+#ifndef BQ25896_CACHE_ADC_AGE_MS
+#define BQ25896_CACHE_ADC_AGE_MS 1000
+#endif
 
 typedef struct {
-    // Input Current Limit in effect while Input Current Optimizer (ICO) is enabled
-    // Offset: 100mA
-    // Range 100mA (0000000) – 3.25mA (1111111) (LSB = 50mA)
-    // Default: 100mA (0000000)
-    uint8_t idpm_lim:6;
-    // IINDPM Status
-    // 0 – Not in IINDPM
-    // 1 – IINDPM
-    uint8_t idpm_stat:1;
-    // VINDPM Status
-    // 0 – Not in VINDPM
-    // 1 – VINDPM
-    uint8_t vdpm_stat:1;
-} idpm_lim_reg_t __attribute__(());
+    // Getter reads served from the cache, and ones that went to the bus
+    uint32_t hits;
+    uint32_t misses;
+} bq25896_cache_stats_t;
+#endif
 
-typedef struct {
-    // Device Revision: 10
-    uint8_t dev_rev:2;
-    // Temperature Profile
-    // 1- JEITA (default)
-    uint8_t ts_profile:1;
-    // Device Configuration
-    // 000: bq25896 
-    uint8_t pn:3;
-    // Input Current Optimizer (ICO) Status
-    // 0 – Optimization is in progress
-    // 1 – Maximum Input Current Detected
-    uint8_t ico_optimized:1;
-    // Register Reset
-    // 0 – Keep current register setting (default)
-    // 1 – Reset to default register value and reset safety timer
-    // Note: Reset to 0 after register reset is completed
-    uint8_t reg_rst:1;
-} ctrl2_reg_t __attribute__(());
+#if BQ25896_ENABLE_INSTRUMENTATION
+// Called after every register transaction with the transaction record
+typedef void (*bq25896_trace_hook_t)(const bq25896_trace_record_t &rec, void *ctx);
+#endif
 
 class PMIC_BQ25896 {
 
@@ -495,18 +143,155 @@ class PMIC_BQ25896 {
     // Writes 16 bytes to a register.
     void _write(bq25896_reg_t reg, uint8_t *val);
 
+    // Writes len consecutive registers starting at reg in one transaction.
+    // Returns the endTransmission() status
+    uint8_t _writeBurst(bq25896_reg_t reg, const uint8_t *buf, uint8_t len);
+
+    // Reads len consecutive registers starting at reg in one transaction.
+    // Returns the number of bytes read.
+    uint8_t _readBurst(bq25896_reg_t reg, uint8_t *buf, uint8_t len);
+
+    // Latched fault bookkeeping, updated on every REG0C read
+    bq25896_fault_record_t _fault_record;
+
+    // Merges a freshly read REG0C value into _fault_record
+    void _recordFault(fault_reg_t fault);
+
+#if BQ25896_ENABLE_ADC
+    // TSPCT to temperature table used by getBatteryTemperature()
+    const bq25896_ntc_lut_t *_ntc_lut;
+    // ADC calibration used by the getters
+    const bq25896_cal_t *_cal;
+#endif
+
+#if BQ25896_ENABLE_CACHE
+    // Register image of the cached blocks, REG0C and REG14 are never cached
+    bool _cache_enabled;
+    uint8_t _cache[BQ25896_REG_COUNT];
+    bool _cache_valid[BQ25896_CACHE_GROUPS];
+    uint32_t _cache_time[BQ25896_CACHE_GROUPS];
+    uint32_t _cache_age[BQ25896_CACHE_GROUPS];
+    bq25896_cache_stats_t _cache_stats[BQ25896_CACHE_GROUPS];
+
+    // Serves reg from the cache, refreshing its block if stale
+    // Returns false if reg is not cached
+    bool _cacheRead(bq25896_reg_t reg, uint8_t *val);
+    // Copies registers read or written on the bus into the cache
+    void _cacheStore(bq25896_reg_t reg, const uint8_t *buf, uint8_t len, bool refresh);
+#endif
+
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+    // PN of the part found by checkVARIANT(), BQ25896_VARIANT_GENERIC before
+    uint8_t _variant;
+#endif
+
+#if BQ25896_ENABLE_INSTRUMENTATION
+    // Transaction trace hook, NULL when not tracing
+    bq25896_trace_hook_t _trace_hook;
+    void *_trace_ctx;
+
+    // Hands a finished transaction to the trace hook
+    void _trace(bq25896_reg_t reg, bq25896_trace_dir_t dir, uint8_t status, const uint8_t *data, uint8_t len);
+#endif
+
 public:
 
-    PMIC_BQ25896(bq25896_addr_t addr = BQ25896_ADDR) : _i2c_addr(addr) {};
+    PMIC_BQ25896(bq25896_addr_t addr = BQ25896_ADDR) : _i2c_addr(addr) {
+#if BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+        _variant = BQ25896_VARIANT_GENERIC;
+#endif
+#if BQ25896_ENABLE_ADC
+        _ntc_lut = &bq25896_ntc_default_lut;
+        _cal = &bq25896_cal_identity;
+#endif
+#if BQ25896_ENABLE_CACHE
+        _cache_enabled = false;
+        _cache_age[BQ25896_CACHE_CONFIG] = BQ25896_CACHE_CONFIG_AGE_MS;
+        _cache_age[BQ25896_CACHE_STATUS] = BQ25896_CACHE_STATUS_AGE_MS;
+        _cache_age[BQ25896_CACHE_ADC] = BQ25896_CACHE_ADC_AGE_MS;
+        invalidateCACHE();
+        clearCACHE_STATS();
+#endif
+#if BQ25896_ENABLE_INSTRUMENTATION
+        _trace_hook = NULL;
+        _trace_ctx = NULL;
+#endif
+        clearFAULT_record();
+    };
     // Initializes BQ25896
     void begin(TwoWire *theWire = &Wire);
 
     // Check if IC is communicating
     bool isConnected();
 
+    // Reads PN from REG14 and checks it against the part the driver is built
+    // for (BQ25896_VARIANT). A generic build accepts any part of the family
+    // and takes its limits from then on.
+    // Returns BQ_BUS_ERR if REG14 cannot be read, BQ_RANGE_ERR for another part
+    bq25896_error_t checkVARIANT();
+    // PN code of the part driven: BQ25896_VARIANT, or in a generic build the
+    // part found by checkVARIANT() (BQ25896_VARIANT_GENERIC before)
+    uint8_t getVARIANT();
+
+#if BQ25896_ENABLE_INSTRUMENTATION
+    // Records every register read and write through hook, NULL to stop tracing
+    // The hook runs inline after each transaction, keep it short
+    void setTRACE_HOOK(bq25896_trace_hook_t hook, void *ctx = NULL);
+#endif
+
+#if BQ25896_ENABLE_CACHE
+    // Read-through cache, off by default
+    // When on, getters and the reads of read-modify-write setters are served
+    // from a register image while their block is younger than its max age,
+    // a stale block is refreshed with one burst. Writes and getSNAPSHOT()
+    // update the image. REG0C (clears on read) and REG14 always go to the
+    // bus, and self-clearing bits (CONV_START, FORCE_DPDM, WD_RST,
+    // FORCE_ICO, PUMPX_UP/DN) are re-read until they read back 0.
+    // Use a finite CONFIG age if the charger may change IINLIM (input
+    // detection, ICO) or reset registers (watchdog expiry) behind the driver.
+    void setCACHE(bool enable);
+    // Max age of group in ms, 0 reads the group's registers from the bus
+    // one by one, BQ25896_CACHE_FOREVER never refreshes
+    void setCACHE_AGE(bq25896_cache_group_t group, uint32_t max_age_ms);
+    // Makes every block stale, e.g. after the charger was power cycled
+    void invalidateCACHE();
+    // Hit and miss counters of group
+    bq25896_cache_stats_t getCACHE_STATS(bq25896_cache_group_t group);
+    void clearCACHE_STATS();
+#endif
+
     // Resets BQ25896
     void reset();
 
+    // Reads REG00 - REG14 in one burst and returns the register image
+    // REG0C is part of the burst and is merged into the fault record
+    bq25896_regs_t getSNAPSHOT();
+    // Reads count registers starting at first in one burst, in place into
+    // regs.raw[first] ... regs.raw[first + count - 1]. Other registers are left as is.
+    // Returns false if the device returned fewer bytes than requested
+    bool readSNAPSHOT(bq25896_regs_t &regs, bq25896_reg_t first = ILIM, uint8_t count = BQ25896_REG_COUNT);
+
+    // Generic access to any field of the register map (PMIC_BQ25896_regmap.h)
+    // e.g. getFIELD(BQ25896_F_CHRG_STAT), setFIELD(BQ25896_F_EN_TERM, 0)
+    // Field code of id, one register read
+    uint8_t getFIELD(bq25896_field_t id);
+    // Read-modify-write of the field code, BQ_RANGE_ERR for status fields
+    // and codes wider than the field, and for HVDCP_EN / MAXC_EN in a generic
+    // build until checkVARIANT() has found a bq25890/5
+    bq25896_error_t setFIELD(bq25896_field_t id, uint8_t code);
+    // Same with the decoded value in the unit of the field name (mA, mV, ...)
+    // Linear values round down to the field step, BQ_RANGE_ERR outside the
+    // limits of the named setter, see bq25896_field_encode()
+    int32_t getFIELD_value(bq25896_field_t id);
+    bq25896_error_t setFIELD_value(bq25896_field_t id, int32_t value);
+
+    // Writes a complete charging profile: one burst read of REG00 - REG06,
+    // then only the registers that change, REG03 - REG06 in one burst
+    // Nothing is written if any value is out of range
+    bq25896_error_t applyPROFILE(const bq25896_profile_t &profile);
+    // Reads the charging profile back from REG00 - REG06 in one burst
+    bq25896_profile_t getPROFILE();
+
     // REG00
     // Read and return stored values in this register
     ilim_reg_t getILIM_reg();
@@ -524,12 +309,16 @@ public:
     // Default:0001000 (500mA)
     // (Actual input current limit is the lower of I2C or ILIM pin, changes with input type detection)
     bq25896_error_t setIINLIM(int value);
+    bq25896_error_t setIINLIM(bq25896::Milliamps value);
+    // Writes a field code made by BQ25896_CONST(Iinlim, value), no range check
+    void setIINLIM(bq25896::Code<bq25896::Iinlim> code);
     // Returns Input Current Limit in mA
     uint16_t getIINLIM();
 
     // REG01
     // Read and return stored values in this register
     vindpm_os_reg_t getVINDPM_OS_reg();
+#if BQ25896_ENABLE_BOOST
     // Boost Mode Hot Temperature Monitor Threshold
     // 00 – VBHOT1 Threshold (34.75%) (default)
     // 01 – VBHOT0 Threshold (Typ. 37.75%)
@@ -540,18 +329,23 @@ public:
     // 0 – VBCOLD0 Threshold (Typ. 77%) (default)
     // 1 – VBCOLD1 Threshold (Typ. 80%)
     void setBCOLD(bool value);
+#endif
     // Input Voltage Limit Offset
     // Default: 600mV (00110)
     // Range: 0mV (00000) – 3100mV (11111) (LSB = 100mV)
     // Minimum VINDPM threshold is clamped at 3.9V
     // Maximum VINDPM threshold is clamped at 15.3V
     bq25896_error_t setVINDPM_OS(int value);
+    bq25896_error_t setVINDPM_OS(bq25896::Millivolts value);
+    // Writes a field code made by BQ25896_CONST(VindpmOs, value), no range check
+    void setVINDPM_OS(bq25896::Code<bq25896::VindpmOs> code);
     // Returns Input Voltage Limit Offset in mV
     uint16_t getVINDPM_OS();
 
     // REG02
     // Read and return stored values in this register
     adc_ctrl_reg_t getADC_CTRL_reg();
+#if BQ25896_ENABLE_ADC
     // ADC Conversion Start Control
     // 0 – ADC conversion not active (default).
     // 1 – Start ADC Conversion
@@ -561,15 +355,20 @@ public:
     // 0 – One shot ADC conversion (default)
     // 1 – Start 1s Continuous Conversion
     void setCONV_RATE(bool value);
+#endif
+#if BQ25896_ENABLE_BOOST
     // Boost Mode Frequency Selection
     // 0 – 1.5MHz (default)
     // 1 – 500KHz
     // Note: Write to this bit is ignored when OTG_CONFIG is enabled.
     void setBOOST_FREQ(bool value);
+#endif
+#if BQ25896_ENABLE_ICO
     // Input Current Optimizer (ICO) Enable
     // 0 – Disable ICO Algorithm
     // 1 – Enable ICO Algorithm (default)
     void setICO_EN(bool value);
+#endif
     // Force Input Detection
     // 0 – Not in PSEL detection (default)
     // 1 – Force PSEL detection
@@ -578,6 +377,18 @@ public:
     // 0 – Disable PSEL detection when VBUS is plugged-in
     // 1 – Enable PEL detection when VBUS is plugged-in (default)
     void setAUTO_DPDM_EN(bool value);
+#if BQ25896_VARIANT_HAS_HVDCP
+    // High Voltage DCP Enable (bq25890/bq25895)
+    // 0 – Disable HVDCP handshake
+    // 1 – Enable HVDCP handshake (default)
+    // Returns BQ_RANGE_ERR in a generic build driving a bq25896 or before checkVARIANT()
+    bq25896_error_t setHVDCP_EN(bool value);
+    // MaxCharge Adapter Enable (bq25890/bq25895)
+    // 0 – Disable MaxCharge handshake
+    // 1 – Enable MaxCharge handshake (default)
+    // Returns BQ_RANGE_ERR in a generic build driving a bq25896 or before checkVARIANT()
+    bq25896_error_t setMAXC_EN(bool value);
+#endif
 
     // REG03
     // Read and return stored values in this register
@@ -590,10 +401,12 @@ public:
     // 0 – Normal (default)
     // 1 – Reset (Back to 0 after timer reset)
     void setWD_RST(bool value);
+#if BQ25896_ENABLE_BOOST
     // Boost (OTG) Mode Configuration
     // 0 – OTG Disable (default)
     // 1 – OTG Enable
     void setOTG_CONFIG(bool value);
+#endif
     // Charge Enable Configuration
     // 0 - Charge Disable
     // 1 - Charge Enable (default)
@@ -603,27 +416,38 @@ public:
     // Range 3000mV (000) - 3700mV (111) (LSB = 100mV)
     // Default: 3500mV (101)
     bq25896_error_t setSYS_MIN(int value);
+    bq25896_error_t setSYS_MIN(bq25896::Millivolts value);
+    // Writes a field code made by BQ25896_CONST(SysMin, value), no range check
+    void setSYS_MIN(bq25896::Code<bq25896::SysMin> code);
     // Returns Minimum System Voltage Limit in mV
     uint16_t getSYS_MIN();
+#if BQ25896_ENABLE_BOOST
     // Minimum Battery Voltage (falling) to exit boost mode
     // 0 - 2.9V (default)
     // 1 - 2.5V
     void setMIN_VBAT_SEL(bool value);
+#endif
 
     // REG04
     // Read and return stored values in this register
     ichg_reg_t getICHG_reg();
+#if BQ25896_ENABLE_PUMPX
     // Current pulse control Enable
     // 0 - Disable Current pulse control (default)
     // 1- Enable Current pulse control (PUMPX_UP and PUMPX_DN)
     void setEN_PUMPX(bool value);
+#endif
     // Fast Charge Current Limit
     // Offset: 0mA
     // Range: 0mA (0000000) – 3008mA (0101111) (LSB = 64mA)
     // Default: 2048mA (0100000)
     // Note: ICHG=000000 (0mA) disables charge
     // Note: ICHG > 0101111 (3008mA) is clamped to register value 0101111 (3008mA)
+    // Note: bq25890/bq25895 range up to 5056mA (1001111)
     bq25896_error_t setICHG(int value);
+    bq25896_error_t setICHG(bq25896::Milliamps value);
+    // Writes a field code made by BQ25896_CONST(Ichg, value), no range check
+    void setICHG(bq25896::Code<bq25896::Ichg> code);
     // Returns Fast Charge Current Limit in mA
     uint16_t getICHG();
 
@@ -635,6 +459,9 @@ public:
     // Range: 64mA (0000) – 1024mA (1111) (LSB = 64mA)
     // Default: 128mA (0001)
     bq25896_error_t setIPRECHG(int value);
+    bq25896_error_t setIPRECHG(bq25896::Milliamps value);
+    // Writes a field code made by BQ25896_CONST(Iprechg, value), no range check
+    void setIPRECHG(bq25896::Code<bq25896::Iprechg> code);
     // Returns Precharge Current Limit in mA
     uint16_t getIPRECHG();
     // Termination Current Limit
@@ -642,6 +469,9 @@ public:
     // Range: 64mA (0000) – 1024mA (1111) (LSB = 64mA)
     // Default: 256mA (0011)
     bq25896_error_t setITERM(int value);
+    bq25896_error_t setITERM(bq25896::Milliamps value);
+    // Writes a field code made by BQ25896_CONST(Iterm, value), no range check
+    void setITERM(bq25896::Code<bq25896::Iterm> code);
     // Returns Termination Current Limit in mA
     uint16_t getITERM();
 
@@ -654,6 +484,9 @@ public:
     // Default: 4208mV (010111)
     // Note: VREG > 110000 (4.608V) is clamped to register value 110000 (4.608V)
     bq25896_error_t setVREG(int value);
+    bq25896_error_t setVREG(bq25896::Millivolts value);
+    // Writes a field code made by BQ25896_CONST(Vreg, value), no range check
+    void setVREG(bq25896::Code<bq25896::Vreg> code);
     // Returns Charge Voltage Limit in mV
     uint16_t getVREG();
     // Battery Precharge to Fast Charge Threshold
@@ -712,6 +545,9 @@ public:
     // Range: 0mV (000) - 224mV (111) (LSB = 32mV)
     // Default: 0mV (000)
     bq25896_error_t setVCLAMP(int value);
+    bq25896_error_t setVCLAMP(bq25896::Millivolts value);
+    // Writes a field code made by BQ25896_CONST(Vclamp, value), no range check
+    void setVCLAMP(bq25896::Code<bq25896::Vclamp> code);
     // Returns IR Compensation Voltage Clamp in mV
     uint16_t getVCLAMP();
     // Thermal Regulation Threshold
@@ -724,11 +560,13 @@ public:
     // REG09
     // Read and return stored values in this register
     ctrl1_reg_t getCTRL1_reg();
+#if BQ25896_ENABLE_ICO
     // Force Start Input Current Optimizer (ICO)
     // 0 – Do not force ICO (default)
     // 1 – Force ICO
     // Note: This bit is can only be set only and always returns to 0 after ICO starts
     void setFORCE_ICO(bool value);
+#endif
     // Safety Timer Setting during DPM or Thermal Regulation
     // 0 – Safety timer not slowed by 2X during input DPM or thermal regulation
     // 1 – Safety timer slowed by 2X during input DPM or thermal regulation (default)
@@ -749,6 +587,7 @@ public:
     // 0 – Disable BATFET full system reset
     // 1 – Enable BATFET full system reset (default)
     void setBATFET_RST_EN(bool value);
+#if BQ25896_ENABLE_PUMPX
     // Current pulse control voltage up enable
     // 0 – Disable (default)
     // 1 – Enable
@@ -759,7 +598,9 @@ public:
     // 1 – Enable
     // Note: This bit is can only be set when EN_PUMPX bit is set and returns to 0 after current pulse control sequence is completed
     void setPUMPX_DN(bool value);
+#endif
 
+#if BQ25896_ENABLE_BOOST
     // REG0A
     // Read and return stored values in this register
     boost_ctrl_reg_t getBOOST_CTRL_reg();
@@ -768,6 +609,9 @@ public:
     // Range: 4550mV (0000) – 5510mV (1111) (LSB = 64mV)
     // Default: 4998mV (0111)
     bq25896_error_t setBOOSTV(int value);
+    bq25896_error_t setBOOSTV(bq25896::Millivolts value);
+    // Writes a field code made by BQ25896_CONST(Boostv, value), no range check
+    void setBOOSTV(bq25896::Code<bq25896::Boostv> code);
     // Returns Boost Mode Voltage Regulation in mV
     uint16_t getBOOSTV();
     // PFM mode allowed in boost mode
@@ -786,6 +630,7 @@ public:
     bq25896_error_t setBOOST_LIM(int value);
     // Returns Boost Mode Current Limit in mA
     uint16_t getBOOST_LIM();
+#endif
 
     // REG0B
     // Read and return stored values in this register
@@ -793,7 +638,16 @@ public:
 
     // REG0C
     // Read and return stored values in this register
+    // Faults are latched and cleared by the read, so read it once per event
+    // and keep the returned value. Every read is merged into the fault record.
     fault_reg_t getFAULT_reg();
+    // Read REG0C once (on INT or periodic poll) and update the fault record
+    // Returns true if the read reported any fault
+    bool serviceFAULT();
+    // Returns sticky faults, counters and history collected from REG0C reads
+    const bq25896_fault_record_t &getFAULT_record() const { return _fault_record; }
+    // Clears sticky faults, counters and history
+    void clearFAULT_record();
 
     // REG0D
     // Read and return stored values in this register
@@ -812,9 +666,19 @@ public:
     // Register can be read/write when FORCE_VINDPM = 1
     // Note: Register is reset to default value when input source is plugged-in
     bq25896_error_t setVINDPM(int value);
+    bq25896_error_t setVINDPM(bq25896::Millivolts value);
+    // Writes a field code made by BQ25896_CONST(Vindpm, value), no range check
+    void setVINDPM(bq25896::Code<bq25896::Vindpm> code);
     // Returns Absolute VINDPM Threshold in mV
     uint16_t getVINDPM();
 
+#if BQ25896_ENABLE_ADC
+    // Sets the board calibration applied by getBATV(), getSYSV(), getVBUSV()
+    // and getICHGR() (PMIC_BQ25896_cal.h), it must stay valid
+    // Default: bq25896_cal_identity (values as decoded), NULL restores it
+    void setCALIBRATION(const bq25896_cal_t *cal);
+    const bq25896_cal_t &getCALIBRATION();
+
     // REG0E
     // Read and return stored values in this register
     batv_reg_t getBATV_reg();
@@ -832,6 +696,13 @@ public:
     tspct_reg_t getTSPCT_reg();
     // Returns TS Voltage (TS) as percentage of REGN in %
     uint16_t getTSPCT();
+    // Sets the NTC table built with bq25896_ntc_build(), it must stay valid
+    // Default: bq25896_ntc_default_lut (TI EVM network), NULL restores it
+    void setNTC_LUT(const bq25896_ntc_lut_t *lut);
+    // Returns battery temperature from TSPCT in 0.1 degC
+    int16_t getBatteryTemperature();
+    // Returns JEITA zone from TSPCT (cold, cool, normal, warm, hot)
+    bq25896_jeita_zone_t getJEITA_ZONE();
 
     // REG11
     // Read and return stored values in this register
@@ -844,10 +715,15 @@ public:
     ichgr_reg_t getICHGR_reg();
     // Returns Charge Current (IBAT) in mA
     uint16_t getICHGR();
+#endif
 
     // REG13
     // Read and return stored values in this register
     idpm_lim_reg_t getIDPM_LIM_reg();
+#if BQ25896_ENABLE_ICO
+    // Returns Input Current Limit in effect while ICO is enabled in mA
+    uint16_t getIDPM_LIM();
+#endif
 
     // REG14
     // Read and return stored values in this register
@@ -0,0 +1,172 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include "PMIC_BQ25896_LowPower.h"
+
+#if defined(ESP32)
+#include "esp_sleep.h"
+#include "driver/gpio.h"
+// Survives deep sleep so changes and wake-ups are tracked across sleeps
+#define BQ25896_RETAINED RTC_DATA_ATTR
+#else
+#define BQ25896_RETAINED
+#endif
+
+// Status registers from the previous service()
+BQ25896_RETAINED static uint8_t last_vbus_stat = 0;
+BQ25896_RETAINED static bool last_valid = false;
+BQ25896_RETAINED static bq25896_lowpower_stats_t stats = { 0, 0, 0 };
+#if BQ25896_ENABLE_ADC
+// A one-shot conversion was started before the sleep and not read yet
+BQ25896_RETAINED static bool conv_pending = false;
+#endif
+
+void PMIC_BQ25896_LowPower::begin(const bq25896_lowpower_config_t &config){
+    _config = config;
+#if BQ25896_ENABLE_ADC
+    adc_ctrl_reg_t adc_ctrl = _pmic.getADC_CTRL_reg();
+    _adc_valid_ms = millis();
+    if(adc_ctrl.conv_rate != _config.continuous_adc){
+        _pmic.setCONV_RATE(_config.continuous_adc);
+        // The first continuous conversion completes within a second
+        if(_config.continuous_adc) _adc_valid_ms += 1000;
+    }
+#endif
+    if(_config.int_pin >= 0){
+        pinMode(_config.int_pin, INPUT_PULLUP);
+    }
+}
+
+bq25896_wake_t PMIC_BQ25896_LowPower::_wakeCause(){
+#if defined(ESP32)
+    switch(esp_sleep_get_wakeup_cause()){
+        case ESP_SLEEP_WAKEUP_EXT0:
+        case ESP_SLEEP_WAKEUP_GPIO:
+        return BQ25896_WAKE_INT;
+        case ESP_SLEEP_WAKEUP_TIMER:
+        return BQ25896_WAKE_TIMER;
+        default:
+        return BQ25896_WAKE_OTHER;
+    }
+#else
+    return BQ25896_WAKE_OTHER;
+#endif
+}
+
+bool PMIC_BQ25896_LowPower::_adcFresh(){
+#if BQ25896_ENABLE_ADC
+    if(_config.continuous_adc){
+        return (int32_t)(millis() - _adc_valid_ms) >= 0;
+    }
+    // One-shot: CONV_START (REG02 of the same burst) clears when the
+    // conversion started before the sleep is done
+    if(conv_pending && !_regs.adc_ctrl.conv_start){
+        conv_pending = false;
+        return true;
+    }
+#endif
+    return false;
+}
+
+uint8_t PMIC_BQ25896_LowPower::service(){
+    bq25896_wake_t cause = _wakeCause();
+    BQ25896_TRACEPOINT(BQ25896_TP_INT_HANDLER, cause);
+    switch(cause){
+        case BQ25896_WAKE_INT:
+        stats.int_wakeups++;
+        break;
+        case BQ25896_WAKE_TIMER:
+        stats.timer_wakeups++;
+        break;
+        default:
+        stats.other_wakeups++;
+    }
+
+    // One burst for status, latched faults and ADC results, from REG02
+    // for CONV_START when the ADC is used
+#if BQ25896_ENABLE_ADC
+    const bq25896_reg_t first = ADC_CTRL;
+#else
+    const bq25896_reg_t first = VBUS_STAT;
+#endif
+    if(!_pmic.readSNAPSHOT(_regs, first, IDPM_LIM - first + 1)){
+        return 0;
+    }
+
+    bool fresh = _adcFresh();
+    uint8_t events = fresh ? BQ25896_EVENT_TELEMETRY : 0;
+    uint8_t vbus_stat = _regs.raw[VBUS_STAT];
+    if(last_valid){
+        vbus_stat_reg_t last = bq25896_view<vbus_stat_reg_t>(last_vbus_stat);
+        if(last.pg_stat != _regs.vbus_stat.pg_stat) events |= BQ25896_EVENT_POWER_GOOD;
+        if(last.vbus_stat != _regs.vbus_stat.vbus_stat) events |= BQ25896_EVENT_VBUS;
+        if(last.chrg_stat != _regs.vbus_stat.chrg_stat) events |= BQ25896_EVENT_CHARGE;
+    }
+    if(_regs.raw[FAULT]) events |= BQ25896_EVENT_FAULT;
+    if(_stats && fresh) bq25896_stats_feed(*_stats, _regs);
+    last_vbus_stat = vbus_stat;
+    last_valid = true;
+    return events;
+}
+
+bool PMIC_BQ25896_LowPower::sleep(){
+#if defined(ESP32)
+#if BQ25896_ENABLE_ADC
+    if(!_config.continuous_adc){
+        // Convert while we sleep, the next service() reads the result
+        _pmic.setCONV_START(true);
+        conv_pending = true;
+    }
+#endif
+    if(_config.telemetry_period_ms){
+        esp_sleep_enable_timer_wakeup((uint64_t)_config.telemetry_period_ms * 1000);
+    }
+    if(_config.sleep == BQ25896_SLEEP_DEEP){
+        if(_config.int_pin >= 0){
+            esp_sleep_enable_ext0_wakeup((gpio_num_t)_config.int_pin, 0);
+        }
+        esp_deep_sleep_start();
+    }
+    if(_config.int_pin >= 0){
+        gpio_wakeup_enable((gpio_num_t)_config.int_pin, GPIO_INTR_LOW_LEVEL);
+        esp_sleep_enable_gpio_wakeup();
+    }
+    esp_light_sleep_start();
+    if(_config.int_pin >= 0){
+        gpio_wakeup_disable((gpio_num_t)_config.int_pin);
+    }
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    return true;
+#else
+    return false;
+#endif
+}
+
+const bq25896_lowpower_stats_t &PMIC_BQ25896_LowPower::getSTATS() const {
+    return stats;
+}
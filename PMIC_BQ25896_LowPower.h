@@ -0,0 +1,144 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_LOWPOWER_H
+#define PMIC_BQ25896_LOWPOWER_H
+
+#include "PMIC_BQ25896.h"
+#include "PMIC_BQ25896_stats.h"
+
+// Sleep coordination for battery powered hosts
+// The MCU sleeps until the BQ25896 pulses INT (charge state change or
+// fault) or a telemetry timer expires. On every wake one burst read of
+// REG0B - REG13 picks up status, latched faults and ADC results, and the
+// result is compared against the state before the sleep.
+// Sleeping is implemented for ESP32 (light and deep sleep); on other
+// targets sleep() returns false and service() is called from the
+// application's own wake-up path.
+// Note: the I2C watchdog (40s default) resets the charge settings when the
+// host sleeps longer, disable it with setWATCHDOG(0) or keep the wake period shorter.
+// The state kept across deep sleep (last status, wake-up counters, pending
+// one-shot conversion) lives in RTC memory and is shared, so use a single
+// PMIC_BQ25896_LowPower instance.
+
+typedef enum {
+    BQ25896_SLEEP_LIGHT = 0x00,
+    BQ25896_SLEEP_DEEP
+} bq25896_sleep_t;
+
+typedef enum {
+    BQ25896_WAKE_OTHER = 0x00,
+    BQ25896_WAKE_INT,
+    BQ25896_WAKE_TIMER
+} bq25896_wake_t;
+
+// Events reported by service()
+#define BQ25896_EVENT_POWER_GOOD    0x01    // PG_STAT changed (adapter plugged in or removed)
+#define BQ25896_EVENT_VBUS          0x02    // VBUS_STAT (input type) changed
+#define BQ25896_EVENT_CHARGE        0x04    // CHRG_STAT changed
+#define BQ25896_EVENT_FAULT         0x08    // REG0C reported a fault
+#define BQ25896_EVENT_TELEMETRY     0x10    // ADC results in the snapshot are new (a conversion
+                                            // finished), never set with BQ25896_ENABLE_ADC=0
+
+typedef struct {
+    // MCU pin wired to the open drain INT output (needs a pull-up), -1 for timer only
+    int int_pin;
+    // true: 1s continuous ADC conversion (CONV_RATE=1)
+    // false: one-shot conversion started before every sleep, read on the next wake
+    // Ignored when built with BQ25896_ENABLE_ADC=0
+    bool continuous_adc;
+    // Timer wake-up period for telemetry in ms, 0 to wake on INT only
+    uint32_t telemetry_period_ms;
+    bq25896_sleep_t sleep;
+} bq25896_lowpower_config_t;
+
+typedef struct {
+    uint32_t int_wakeups;
+    uint32_t timer_wakeups;
+    uint32_t other_wakeups;
+} bq25896_lowpower_stats_t;
+
+class PMIC_BQ25896_LowPower {
+
+    PMIC_BQ25896 &_pmic;
+
+    bq25896_lowpower_config_t _config;
+
+    // REG0B - REG13 from the last service(), REG02 too with the ADC
+    bq25896_regs_t _regs;
+
+    // Fed with the ADC results of every service(), NULL if not used
+    bq25896_stats_t *_stats;
+
+    // millis() from which continuous conversion results are valid
+    uint32_t _adc_valid_ms;
+
+    // True when a conversion finished since the last service(), from _regs
+    bool _adcFresh();
+
+    // Returns why the MCU woke up
+    bq25896_wake_t _wakeCause();
+
+public:
+
+    PMIC_BQ25896_LowPower(PMIC_BQ25896 &pmic) : _pmic(pmic) {
+        memset(&_config, 0, sizeof(_config));
+        _config.int_pin = -1;
+        memset(&_regs, 0, sizeof(_regs));
+        _stats = NULL;
+        _adc_valid_ms = 0;
+    };
+
+    // Applies the ADC mode and INT pin setup, call after PMIC_BQ25896::begin()
+    // and after every wake from deep sleep
+    void begin(const bq25896_lowpower_config_t &config);
+
+    // Reads REG0B - REG13 (from REG02 with the ADC) in one burst and returns
+    // BQ25896_EVENT_* flags for what changed since the last service(), across
+    // deep sleep on ESP32. Returns 0 and keeps the previous state if the read fails
+    uint8_t service();
+
+    // Feeds stats with the ADC results of every service() that has new ones, NULL to stop
+    // Put stats in RTC memory to keep them across deep sleep
+    void setADC_STATS(bq25896_stats_t *stats) { _stats = stats; }
+    bq25896_stats_t *getADC_STATS() const { return _stats; }
+
+    // Register image of the last service(), REG0B - REG13 are valid
+    const bq25896_regs_t &getSNAPSHOT() const { return _regs; }
+
+    // Sleeps until INT or the telemetry timer. Starts the next one-shot
+    // conversion first when continuous_adc is false. Deep sleep does not
+    // return, the sketch restarts in setup().
+    // Returns false when sleeping is not supported on this target.
+    bool sleep();
+
+    // Wake-up counters, kept across deep sleep on ESP32
+    const bq25896_lowpower_stats_t &getSTATS() const;
+};
+
+#endif
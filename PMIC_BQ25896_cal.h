@@ -0,0 +1,183 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_CAL_H
+#define PMIC_BQ25896_CAL_H
+
+// Per-board ADC calibration
+// The BATV, SYSV, VBUSV and ICHGR readings carry the offset and gain
+// errors of the part and of the board (sense paths, divider tolerances).
+// A calibration record holds a gain and an offset per channel, applied to
+// the nominal decoded value in integer math:
+//     value = nominal + nominal * gain / 2^15 + offset
+// gain is the Q15 gain error (-1.0 to +1.0), offset is in mV or mA.
+// The identity record (all zero) leaves the values as decoded.
+//
+// Fit a record against a reference meter with bq25896_cal_fit_add() /
+// bq25896_cal_fit_solve(), store it with bq25896_cal_pack() (19 bytes) and
+// load it at startup with bq25896_cal_unpack().
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_crc.h"
+
+typedef enum {
+    BQ25896_CAL_BATV = 0,   // mV
+    BQ25896_CAL_SYSV,       // mV
+    BQ25896_CAL_VBUSV,      // mV
+    BQ25896_CAL_ICHGR,      // mA
+    BQ25896_CAL_CHANNELS
+} bq25896_cal_channel_t;
+
+#define BQ25896_CAL_GAIN_SHIFT 15
+
+typedef struct {
+    // Gain error in Q15
+    int16_t gain;
+    // Offset in the channel unit
+    int16_t offset;
+} bq25896_cal_coef_t;
+
+typedef struct {
+    bq25896_cal_coef_t ch[BQ25896_CAL_CHANNELS];
+} bq25896_cal_t;
+
+static const bq25896_cal_t bq25896_cal_identity = { { { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 } } };
+
+// Calibrated value of a nominal reading, clamped to 0 - 65535
+static inline uint16_t bq25896_cal_apply(const bq25896_cal_coef_t &c, uint16_t nominal){
+    int32_t v = nominal + ((nominal * (int32_t)c.gain + (1 << (BQ25896_CAL_GAIN_SHIFT - 1))) >> BQ25896_CAL_GAIN_SHIFT) + c.offset;
+    return v < 0 ? 0 : (v > 0xFFFF ? 0xFFFF : (uint16_t)v);
+}
+
+// Applies c to n values in place, a separate pass so the bulk decoder
+// loops stay vectorizable
+static inline void bq25896_cal_apply_n(const bq25896_cal_coef_t &c, uint16_t *v, size_t n){
+    if(c.gain == 0 && c.offset == 0) return;
+    for(size_t i = 0; i < n; i++) v[i] = bq25896_cal_apply(c, v[i]);
+}
+
+// Persisted record:
+//   [0]       version, BQ25896_CAL_VERSION
+//   [1..16]   gain, offset per channel, int16 little-endian
+//   [17..18]  CRC-16/CCITT-FALSE of bytes 0 - 16, little-endian
+#define BQ25896_CAL_VERSION 1
+#define BQ25896_CAL_PACKED_LEN (1 + BQ25896_CAL_CHANNELS * 4 + 2)
+
+static inline void bq25896_cal_pack(const bq25896_cal_t &cal, uint8_t out[BQ25896_CAL_PACKED_LEN]){
+    uint8_t *p = out;
+    *p++ = BQ25896_CAL_VERSION;
+    for(int c = 0; c < BQ25896_CAL_CHANNELS; c++){
+        uint16_t g = (uint16_t)cal.ch[c].gain;
+        uint16_t o = (uint16_t)cal.ch[c].offset;
+        *p++ = g;
+        *p++ = g >> 8;
+        *p++ = o;
+        *p++ = o >> 8;
+    }
+    uint16_t crc = bq25896_crc16(out, BQ25896_CAL_PACKED_LEN - 2);
+    *p++ = crc;
+    *p = crc >> 8;
+}
+
+// Returns false and leaves cal untouched for a bad version or CRC
+// (e.g. blank or erased storage)
+static inline bool bq25896_cal_unpack(bq25896_cal_t &cal, const uint8_t in[BQ25896_CAL_PACKED_LEN]){
+    uint16_t crc = in[BQ25896_CAL_PACKED_LEN - 2] | (uint16_t)in[BQ25896_CAL_PACKED_LEN - 1] << 8;
+    if(in[0] != BQ25896_CAL_VERSION || crc != bq25896_crc16(in, BQ25896_CAL_PACKED_LEN - 2)){
+        return false;
+    }
+    const uint8_t *p = in + 1;
+    for(int c = 0; c < BQ25896_CAL_CHANNELS; c++){
+        cal.ch[c].gain = (int16_t)(p[0] | (uint16_t)p[1] << 8);
+        cal.ch[c].offset = (int16_t)(p[2] | (uint16_t)p[3] << 8);
+        p += 4;
+    }
+    return true;
+}
+
+// Least squares fit of one channel from (nominal, reference) pairs
+// nominal is the uncalibrated reading, e.g. bq25896_decode_batv() of
+// getBATV_reg(), reference the value measured at the same time with a
+// meter. Points should span the range the board runs in; the ADC steps
+// are 20mV (BATV, SYSV), 100mV (VBUSV) and 50mA (ICHGR), so a few points
+// per step averaged in help more than many points at one level.
+typedef struct {
+    uint32_t n;
+    int64_t sx;
+    int64_t sy;
+    int64_t sxx;
+    int64_t sxy;
+} bq25896_cal_fit_t;
+
+static inline void bq25896_cal_fit_init(bq25896_cal_fit_t &f){
+    memset(&f, 0, sizeof(f));
+}
+
+static inline void bq25896_cal_fit_add(bq25896_cal_fit_t &f, uint16_t nominal, uint16_t reference){
+    f.n++;
+    f.sx += nominal;
+    f.sy += reference;
+    f.sxx += (int64_t)nominal * nominal;
+    f.sxy += (int64_t)nominal * reference;
+}
+
+// Solves the fit into out. With a single nominal level only the offset is
+// fitted. Returns BQ_RANGE_ERR without points or if the result does not
+// fit the record (gain error beyond +-1.0, offset beyond +-32767).
+// Runs once per calibration, so it uses double; applying the record does not.
+static inline bq25896_error_t bq25896_cal_fit_solve(const bq25896_cal_fit_t &f, bq25896_cal_coef_t &out){
+    if(f.n == 0){
+        return BQ_RANGE_ERR;
+    }
+    double n = f.n;
+    double det = n * (double)f.sxx - (double)f.sx * (double)f.sx;
+    double gain = 1.0;
+    if(det > 0){
+        gain = (n * (double)f.sxy - (double)f.sx * (double)f.sy) / det;
+    }
+    double gain_q = (gain - 1.0) * (1 << BQ25896_CAL_GAIN_SHIFT);
+    gain_q += gain_q < 0 ? -0.5 : 0.5;
+    if(gain_q <= -32769.0 || gain_q >= 32768.0){
+        return BQ_RANGE_ERR;
+    }
+    // Offset for the gain as stored, so the rounding of the gain is absorbed
+    int16_t g = (int16_t)gain_q;
+    double offset = ((double)f.sy - (1.0 + g / (double)(1 << BQ25896_CAL_GAIN_SHIFT)) * (double)f.sx) / n;
+    offset += offset < 0 ? -0.5 : 0.5;
+    if(offset <= -32769.0 || offset >= 32768.0){
+        return BQ_RANGE_ERR;
+    }
+    out.gain = g;
+    out.offset = (int16_t)offset;
+    return BQ_OK;
+}
+
+#endif
@@ -0,0 +1,62 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_CHANNELS_H
+#define PMIC_BQ25896_CHANNELS_H
+
+// ADC samples decoded to physical channels
+// One place for the channel list and the decoding that the statistics
+// (PMIC_BQ25896_stats.h) and the filter (PMIC_BQ25896_filter.h) share.
+
+#include <stdint.h>
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_cal.h"
+#include "PMIC_BQ25896_ntc.h"
+
+// Decoded ADC channels, as kept by the statistics and the filter
+typedef enum {
+    BQ25896_ADC_CH_BATV = 0,  // mV
+    BQ25896_ADC_CH_SYSV,      // mV
+    BQ25896_ADC_CH_VBUSV,     // mV
+    BQ25896_ADC_CH_ICHGR,     // mA
+    BQ25896_ADC_CH_TEMP,      // 0.1 degC from TSPCT
+    BQ25896_ADC_CHANNELS
+} bq25896_adc_channel_t;
+
+// Decodes one ADC sample into out[BQ25896_ADC_CHANNELS], voltages and
+// current corrected by cal, the temperature from TSPCT through ntc
+static inline void bq25896_adc_decode_channels(const bq25896_adc_sample_t &s, const bq25896_cal_t &cal,
+                                               const bq25896_ntc_lut_t &ntc, int32_t out[BQ25896_ADC_CHANNELS]){
+    out[BQ25896_ADC_CH_BATV] = bq25896_decode_batv(s.batv.batv, cal);
+    out[BQ25896_ADC_CH_SYSV] = bq25896_decode_sysv(s.sysv.sysv, cal);
+    out[BQ25896_ADC_CH_VBUSV] = bq25896_decode_vbusv(s.vbusv.vbusv, cal);
+    out[BQ25896_ADC_CH_ICHGR] = bq25896_decode_ichgr(s.ichgr.ichgr, cal);
+    out[BQ25896_ADC_CH_TEMP] = bq25896_ntc_decode(ntc, s.tspct.tspct);
+}
+
+#endif
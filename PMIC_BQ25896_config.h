@@ -0,0 +1,87 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_CONFIG_H
+#define PMIC_BQ25896_CONFIG_H
+
+// Compile-time feature selection
+// Every feature is on by default. Define a macro to 0 in the build flags
+// (e.g. -DBQ25896_ENABLE_BOOST=0 in platformio.ini build_flags or the
+// arduino-cli compiler.cpp.extra_flags property) to drop its accessors and
+// state from the build. extras/size_report.sh reports flash/RAM per set.
+
+// Boost (OTG) mode: REG0A, OTG_CONFIG, BOOST_FREQ, BHOT/BCOLD and MIN_VBAT_SEL
+#ifndef BQ25896_ENABLE_BOOST
+#define BQ25896_ENABLE_BOOST 1
+#endif
+
+// Current pulse control: EN_PUMPX, PUMPX_UP and PUMPX_DN
+#ifndef BQ25896_ENABLE_PUMPX
+#define BQ25896_ENABLE_PUMPX 1
+#endif
+
+// Input Current Optimizer: ICO_EN, FORCE_ICO and the IDPM_LIM result
+#ifndef BQ25896_ENABLE_ICO
+#define BQ25896_ENABLE_ICO 1
+#endif
+
+// ADC: conversion control and the REG0E - REG12 getters
+// The registers stay readable through getSNAPSHOT()/readSNAPSHOT()
+#ifndef BQ25896_ENABLE_ADC
+#define BQ25896_ENABLE_ADC 1
+#endif
+
+// Read-through register cache: setCACHE(), setCACHE_AGE() and the cache counters
+#ifndef BQ25896_ENABLE_CACHE
+#define BQ25896_ENABLE_CACHE 1
+#endif
+
+// Part of the BQ2589x family the driver is built for, see PMIC_BQ25896_variant.h
+// The values are the REG14 PN codes. BQ25896_VARIANT_GENERIC supports every
+// part and takes its limits from the part found by checkVARIANT()
+#define BQ25896_VARIANT_BQ25896 0
+#define BQ25896_VARIANT_BQ25890 3
+#define BQ25896_VARIANT_BQ25895 7
+#define BQ25896_VARIANT_GENERIC 0xFF
+#ifndef BQ25896_VARIANT
+#define BQ25896_VARIANT BQ25896_VARIANT_BQ25896
+#endif
+
+// Instrumentation: the I2C transaction trace hook
+#ifndef BQ25896_ENABLE_INSTRUMENTATION
+#define BQ25896_ENABLE_INSTRUMENTATION 1
+#endif
+
+// Tracepoints: timing markers at bus transactions, setters, cache refreshes
+// and the INT handler, see PMIC_BQ25896_tracepoint.h. Off by default, as
+// they need a sink from the application; off they compile to nothing
+#ifndef BQ25896_ENABLE_TRACEPOINTS
+#define BQ25896_ENABLE_TRACEPOINTS 0
+#endif
+
+#endif
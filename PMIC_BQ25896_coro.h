@@ -0,0 +1,371 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    C++20 coroutine interface
+
+    PMIC_BQ25896_Async wraps a PMIC_BQ25896 and returns awaitable tasks:
+
+        BQ25896Task<void> telemetry(PMIC_BQ25896_Async &pmic){
+            for(;;){
+                if(co_await pmic.convert() == BQ_OK){
+                    bq25896_telemetry_t t = co_await pmic.readTelemetry();
+                    if(t.err == BQ_OK) ...
+                }
+                co_await pmic.executor().sleep(1000);
+            }
+        }
+
+        BQ25896Executor ex;
+        PMIC_BQ25896_Async pmic(charger, ex);
+        ex.spawn(telemetry(pmic));
+        ex.run();
+
+    A coroutine never blocks in requestFrom() or delay(). Register
+    transactions are queued on the executor and the coroutine is resumed
+    once its transaction has completed. The executor runs one transaction
+    per pass, so several coroutines sharing the bus interleave between
+    transactions instead of between whole operations. While waiting for
+    an ADC conversion the coroutine sleeps on a timer and other coroutines
+    run. The executor is single threaded and only sleeps in run() when
+    nothing is ready, so it runs the same on the ESP32 and on the host
+    (extras/host) with the virtual clock.
+
+    Only available when the compiler supports coroutines (C++20).
+    BQ25896_HAS_CORO is 1 when it does.
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_CORO_H
+#define PMIC_BQ25896_CORO_H
+
+#include "PMIC_BQ25896.h"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define BQ25896_HAS_CORO 1
+#endif
+#endif
+
+#ifndef BQ25896_HAS_CORO
+#define BQ25896_HAS_CORO 0
+#endif
+
+#if BQ25896_HAS_CORO
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Interval CONV_START is polled at while a conversion runs
+#ifndef BQ25896_CORO_POLL_MS
+#define BQ25896_CORO_POLL_MS 10
+#endif
+
+template <typename T> class BQ25896Task;
+
+namespace bq25896_detail {
+
+// Resumes whoever awaited the task once it has finished
+struct final_awaiter {
+    bool await_ready() noexcept { return false; }
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+        std::coroutine_handle<> next = h.promise().continuation;
+        return next ? next : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+};
+
+struct promise_base {
+    std::coroutine_handle<> continuation;
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    final_awaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { std::terminate(); }
+};
+
+template <typename T>
+struct promise : promise_base {
+    T value;
+    BQ25896Task<T> get_return_object();
+    void return_value(T v) { value = std::move(v); }
+    T result() { return std::move(value); }
+};
+
+template <>
+struct promise<void> : promise_base {
+    BQ25896Task<void> get_return_object();
+    void return_void() {}
+    void result() {}
+};
+
+}
+
+// Lazily started coroutine returning T
+// Starts when awaited or when handed to BQ25896Executor::spawn()
+template <typename T>
+class BQ25896Task {
+public:
+    typedef bq25896_detail::promise<T> promise_type;
+    typedef std::coroutine_handle<promise_type> handle_type;
+
+    explicit BQ25896Task(handle_type h) : _h(h) {}
+    BQ25896Task(BQ25896Task &&other) noexcept : _h(other._h) { other._h = nullptr; }
+    BQ25896Task &operator=(BQ25896Task &&other) noexcept {
+        if(this != &other){
+            if(_h) _h.destroy();
+            _h = other._h;
+            other._h = nullptr;
+        }
+        return *this;
+    }
+    BQ25896Task(const BQ25896Task &) = delete;
+    BQ25896Task &operator=(const BQ25896Task &) = delete;
+    ~BQ25896Task() { if(_h) _h.destroy(); }
+
+    bool done() const { return !_h || _h.done(); }
+    handle_type handle() const { return _h; }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        _h.promise().continuation = awaiting;
+        return _h;
+    }
+    T await_resume() { return _h.promise().result(); }
+
+private:
+    handle_type _h;
+};
+
+namespace bq25896_detail {
+
+template <typename T>
+inline BQ25896Task<T> promise<T>::get_return_object() {
+    return BQ25896Task<T>(std::coroutine_handle<promise<T> >::from_promise(*this));
+}
+
+inline BQ25896Task<void> promise<void>::get_return_object() {
+    return BQ25896Task<void>(std::coroutine_handle<promise<void> >::from_promise(*this));
+}
+
+}
+
+// Single threaded executor: a ready queue, millis() timers and a queue of
+// bus transactions run one per pass
+class BQ25896Executor {
+public:
+    // A register transaction waiting for the bus
+    struct BusOp {
+        std::coroutine_handle<> waiter;
+        virtual void run() = 0;
+    protected:
+        ~BusOp() {}
+    };
+
+    // Awaiter that runs fn on the bus and resumes with its result
+    template <typename F>
+    class BusAwaiter : public BusOp {
+    public:
+        typedef typename std::invoke_result<F &>::type result_type;
+        BusAwaiter(BQ25896Executor &ex, F fn) : _ex(ex), _fn(std::move(fn)), _result() {}
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            this->waiter = h;
+            _ex._bus.push_back(this);
+        }
+        result_type await_resume() { return std::move(_result); }
+        void run() { _result = _fn(); }
+    private:
+        BQ25896Executor &_ex;
+        F _fn;
+        result_type _result;
+    };
+
+    // Awaiter that resumes after ms milliseconds
+    class SleepAwaiter {
+    public:
+        SleepAwaiter(BQ25896Executor &ex, uint32_t ms) : _ex(ex), _ms(ms) {}
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            Timer t = { (uint32_t)millis() + _ms, h };
+            _ex._timers.push_back(t);
+        }
+        void await_resume() noexcept {}
+    private:
+        BQ25896Executor &_ex;
+        uint32_t _ms;
+    };
+
+    // Runs fn as a bus transaction and resumes the coroutine with its result
+    template <typename F>
+    BusAwaiter<F> bus(F fn) { return BusAwaiter<F>(*this, std::move(fn)); }
+
+    // Resumes the coroutine after ms milliseconds, 0 yields to the other coroutines
+    SleepAwaiter sleep(uint32_t ms) { return SleepAwaiter(*this, ms); }
+
+    // Takes ownership of task and starts it on the next pass
+    void spawn(BQ25896Task<void> task) {
+        _ready.push_back(task.handle());
+        _tasks.push_back(std::move(task));
+    }
+
+    // Runs one pass: due timers, one bus transaction and every coroutine
+    // that was ready at the start of the pass.
+    // Returns true while spawned tasks are unfinished
+    bool poll() {
+        uint32_t now = millis();
+        for(size_t i = 0; i < _timers.size();){
+            if((int32_t)(now - _timers[i].due) >= 0){
+                _ready.push_back(_timers[i].h);
+                _timers[i] = _timers.back();
+                _timers.pop_back();
+            }else{
+                i++;
+            }
+        }
+        if(!_bus.empty()){
+            BusOp *op = _bus.front();
+            _bus.pop_front();
+            op->run();
+            _ready.push_back(op->waiter);
+        }
+        for(size_t n = _ready.size(); n > 0 && !_ready.empty(); n--){
+            std::coroutine_handle<> h = _ready.front();
+            _ready.pop_front();
+            h.resume();
+        }
+        for(size_t i = 0; i < _tasks.size();){
+            if(_tasks[i].done()){
+                _tasks[i] = std::move(_tasks.back());
+                _tasks.pop_back();
+            }else{
+                i++;
+            }
+        }
+        return !_tasks.empty();
+    }
+
+    // Runs until every spawned task has finished, sleeping with delay()
+    // until the next timer when nothing else is ready.
+    // Returns false if the remaining tasks wait on nothing that can resume them
+    bool run() {
+        while(poll()){
+            if(!_ready.empty() || !_bus.empty()) continue;
+            if(_timers.empty()) return false;
+            uint32_t now = millis();
+            uint32_t next = _timers[0].due;
+            for(size_t i = 1; i < _timers.size(); i++){
+                if((int32_t)(_timers[i].due - next) < 0) next = _timers[i].due;
+            }
+            if((int32_t)(next - now) > 0) delay(next - now);
+        }
+        return true;
+    }
+
+    // True when no spawned task is left
+    bool idle() const { return _tasks.empty(); }
+
+private:
+    struct Timer {
+        uint32_t due;
+        std::coroutine_handle<> h;
+    };
+
+    std::deque<std::coroutine_handle<> > _ready;
+    std::deque<BusOp *> _bus;
+    std::vector<Timer> _timers;
+    std::vector<BQ25896Task<void> > _tasks;
+};
+
+// Result of PMIC_BQ25896_Async::readTelemetry()
+typedef struct {
+    // BQ_BUS_ERR if the burst failed, regs is then not valid
+    bq25896_error_t err;
+    bq25896_regs_t regs;
+} bq25896_telemetry_t;
+
+class PMIC_BQ25896_Async {
+
+    PMIC_BQ25896 &_pmic;
+    BQ25896Executor &_ex;
+
+public:
+
+    PMIC_BQ25896_Async(PMIC_BQ25896 &pmic, BQ25896Executor &ex) : _pmic(pmic), _ex(ex) {};
+
+    PMIC_BQ25896 &pmic() { return _pmic; }
+    BQ25896Executor &executor() { return _ex; }
+
+    // Reads REG0B - REG13 (status, faults and ADC results) in one burst
+    // REG0C is part of the burst and is merged into the fault record
+    BQ25896Task<bq25896_telemetry_t> readTelemetry() {
+        PMIC_BQ25896 &pmic = _pmic;
+        bq25896_telemetry_t t = co_await _ex.bus([&pmic]() {
+            bq25896_telemetry_t r;
+            memset(&r, 0, sizeof(r));
+            r.err = pmic.readSNAPSHOT(r.regs, VBUS_STAT, IDPM_LIM - VBUS_STAT + 1) ? BQ_OK : BQ_BUS_ERR;
+            return r;
+        });
+        co_return t;
+    }
+
+#if BQ25896_ENABLE_ADC
+    // Starts a one-shot ADC conversion and resumes once CONV_START has cleared
+    // Returns BQ_TIMEOUT if it is still set after timeout_ms
+    // (it also stays set during input source detection), BQ_BUS_ERR if
+    // REG02 cannot be read
+    BQ25896Task<bq25896_error_t> convert(uint32_t timeout_ms = 1000) {
+        PMIC_BQ25896 &pmic = _pmic;
+        co_await _ex.bus([&pmic]() { pmic.setCONV_START(1); return true; });
+        uint32_t start = millis();
+        for(;;){
+            bq25896_telemetry_t t = co_await _ex.bus([&pmic]() {
+                bq25896_telemetry_t r;
+                memset(&r, 0, sizeof(r));
+                r.err = pmic.readSNAPSHOT(r.regs, ADC_CTRL, 1) ? BQ_OK : BQ_BUS_ERR;
+                return r;
+            });
+            if(t.err != BQ_OK) co_return t.err;
+            if(!t.regs.adc_ctrl.conv_start) co_return BQ_OK;
+            if(millis() - start >= timeout_ms) co_return BQ_TIMEOUT;
+            co_await _ex.sleep(BQ25896_CORO_POLL_MS);
+        }
+    }
+#endif
+
+    // Writes a charging profile, see PMIC_BQ25896::applyPROFILE()
+    BQ25896Task<bq25896_error_t> applyProfile(bq25896_profile_t profile) {
+        PMIC_BQ25896 &pmic = _pmic;
+        bq25896_error_t err = co_await _ex.bus([&pmic, profile]() { return pmic.applyPROFILE(profile); });
+        co_return err;
+    }
+};
+
+#endif
+
+#endif
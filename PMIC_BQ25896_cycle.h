@@ -0,0 +1,186 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_CYCLE_H
+#define PMIC_BQ25896_CYCLE_H
+
+// Charge cycle profiler
+// Splits charging into phases by REG0B CHRG_STAT (not charging, pre-charge,
+// fast charge, charge done) and records for every phase its duration,
+// VBAT at entry and exit, average ICHGR, time spent in VINDPM / IINDPM /
+// thermal regulation and the faults seen. Finished phases go into a ring
+// of the last BQ25896_CYCLE_HISTORY_LEN and into per-phase duration
+// histograms. Time between two samples is attributed to the state of the
+// earlier one, so poll at a steady rate.
+
+#include <stdint.h>
+#include <string.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_decode.h"
+
+// Number of finished phases kept
+#ifndef BQ25896_CYCLE_HISTORY_LEN
+#define BQ25896_CYCLE_HISTORY_LEN 16
+#endif
+
+// Duration histogram bins: bin 0 under 1 min, bin i 2^(i-1) - 2^i min, the last one open ended
+#define BQ25896_CYCLE_HIST_BINS 10
+
+typedef enum {
+    BQ25896_PHASE_NOT_CHARGING = 0,
+    BQ25896_PHASE_PRE_CHARGE,
+    BQ25896_PHASE_FAST_CHARGE,
+    BQ25896_PHASE_DONE,
+    BQ25896_PHASE_COUNT
+} bq25896_phase_t;
+
+typedef struct {
+    // CHRG_STAT of the phase and the one that followed
+    uint8_t phase;
+    uint8_t next;
+    // Non-zero REG0C reads during the phase, and all their bits ORed
+    uint8_t faults;
+    fault_reg_t fault_mask;
+    uint32_t start_ms;
+    uint32_t duration_ms;
+    uint16_t vbat_entry_mv;
+    uint16_t vbat_exit_mv;
+    // Time weighted average of ICHGR
+    uint16_t ichgr_avg_ma;
+    // Time in VINDPM, IINDPM and thermal regulation
+    uint32_t vdpm_ms;
+    uint32_t idpm_ms;
+    uint32_t therm_ms;
+} bq25896_phase_record_t;
+
+typedef struct {
+    // Phase in progress, valid once started is set
+    bq25896_phase_record_t current;
+    bool started;
+    // ICHGR * ms of the current phase
+    uint64_t ichgr_mams;
+    // Regulation flags and ICHGR of the previous sample
+    bool last_vdpm;
+    bool last_idpm;
+    bool last_therm;
+    uint16_t last_ichgr_ma;
+    uint32_t last_ms;
+    // Ring of finished phases, oldest at history[(head + BQ25896_CYCLE_HISTORY_LEN - history_len) % BQ25896_CYCLE_HISTORY_LEN]
+    bq25896_phase_record_t history[BQ25896_CYCLE_HISTORY_LEN];
+    uint8_t head;
+    uint8_t history_len;
+    // Finished phases per CHRG_STAT and duration bin
+    uint16_t duration_hist[BQ25896_PHASE_COUNT][BQ25896_CYCLE_HIST_BINS];
+    // Fast charge phases that ended in charge done
+    uint32_t completed_cycles;
+    // Phases that saw at least one fault
+    uint32_t interrupted_phases;
+    // ADC calibration of the board
+    const bq25896_cal_t *cal;
+} bq25896_cycle_t;
+
+static inline void bq25896_cycle_init(bq25896_cycle_t &c, const bq25896_cal_t *cal = &bq25896_cal_identity){
+    memset(&c, 0, sizeof(c));
+    c.cal = cal;
+}
+
+static inline uint8_t bq25896_cycle_bin(uint32_t duration_ms){
+    uint32_t minutes = duration_ms / 60000;
+    uint8_t bin = 0;
+    while(minutes && bin < BQ25896_CYCLE_HIST_BINS - 1){
+        minutes >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+// Finished phase i, 0 is the oldest, i < history_len
+static inline const bq25896_phase_record_t &bq25896_cycle_record(const bq25896_cycle_t &c, uint8_t i){
+    return c.history[(c.head + BQ25896_CYCLE_HISTORY_LEN - c.history_len + i) % BQ25896_CYCLE_HISTORY_LEN];
+}
+
+static inline void bq25896_cycle_close(bq25896_cycle_t &c, uint8_t next, uint16_t vbat_mv){
+    bq25896_phase_record_t &r = c.current;
+    r.next = next;
+    r.vbat_exit_mv = vbat_mv;
+    r.ichgr_avg_ma = r.duration_ms ? (uint16_t)(c.ichgr_mams / r.duration_ms) : c.last_ichgr_ma;
+    c.history[c.head] = r;
+    c.head = (c.head + 1) % BQ25896_CYCLE_HISTORY_LEN;
+    if(c.history_len < BQ25896_CYCLE_HISTORY_LEN) c.history_len++;
+    c.duration_hist[r.phase][bq25896_cycle_bin(r.duration_ms)]++;
+    if(r.phase == BQ25896_PHASE_FAST_CHARGE && next == BQ25896_PHASE_DONE) c.completed_cycles++;
+    if(r.faults) c.interrupted_phases++;
+}
+
+// Adds a snapshot holding REG0B, REG0C and REG0E - REG13 taken at now_ms (millis())
+// Returns true if it ended a phase, the phase is then the newest history entry
+static inline bool bq25896_cycle_update(bq25896_cycle_t &c, const bq25896_regs_t &regs, uint32_t now_ms){
+    uint8_t phase = regs.vbus_stat.chrg_stat;
+    uint16_t vbat = bq25896_decode_batv(regs.batv.batv, *c.cal);
+    uint16_t ichgr = bq25896_decode_ichgr(regs.ichgr.ichgr, *c.cal);
+    bool closed = false;
+
+    if(c.started){
+        // The interval up to now belongs to the phase and state of the previous sample
+        uint32_t dt = now_ms - c.last_ms;
+        bq25896_phase_record_t &r = c.current;
+        r.duration_ms += dt;
+        c.ichgr_mams += (uint64_t)c.last_ichgr_ma * dt;
+        if(c.last_vdpm) r.vdpm_ms += dt;
+        if(c.last_idpm) r.idpm_ms += dt;
+        if(c.last_therm) r.therm_ms += dt;
+        if(phase != r.phase){
+            bq25896_cycle_close(c, phase, vbat);
+            closed = true;
+        }
+    }
+    if(!c.started || closed){
+        memset(&c.current, 0, sizeof(c.current));
+        c.current.phase = phase;
+        c.current.next = phase;
+        c.current.start_ms = now_ms;
+        c.current.vbat_entry_mv = vbat;
+        c.ichgr_mams = 0;
+        c.started = true;
+    }
+
+    bq25896_phase_record_t &r = c.current;
+    r.vbat_exit_mv = vbat;
+    if(regs.raw[FAULT]){
+        if(r.faults < 0xFF) r.faults++;
+        r.fault_mask = bq25896_view<fault_reg_t>(bq25896_raw(r.fault_mask) | regs.raw[FAULT]);
+    }
+    c.last_vdpm = regs.idpm_lim.vdpm_stat;
+    c.last_idpm = regs.idpm_lim.idpm_stat;
+    c.last_therm = regs.batv.therm_stat;
+    c.last_ichgr_ma = ichgr;
+    c.last_ms = now_ms;
+    return closed;
+}
+
+#endif
@@ -0,0 +1,232 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_DECODE_H
+#define PMIC_BQ25896_DECODE_H
+
+// ADC decoding shared by the device getters and the bulk decoder
+// Like PMIC_BQ25896_regs.h this header has no Arduino dependency, so
+// recorded REG0E - REG13 samples decode on the host exactly like on the device.
+
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_cal.h"
+
+// REG0E Battery Voltage (VBAT): 2304mV + code * 20mV
+#define BQ25896_BATV_OFFSET_MV      2304
+#define BQ25896_BATV_LSB_MV         20
+// REG0F System Voltage (VSYS): 2304mV + code * 20mV
+#define BQ25896_SYSV_OFFSET_MV      2304
+#define BQ25896_SYSV_LSB_MV         20
+// REG10 TS Voltage as percentage of REGN: 21% + code * 0.465%
+// Kept in 0.001% so the decode stays integer
+#define BQ25896_TSPCT_OFFSET_MPCT   21000
+#define BQ25896_TSPCT_LSB_MPCT      465
+// REG11 VBUS Voltage (VBUS): 2600mV + code * 100mV
+#define BQ25896_VBUSV_OFFSET_MV     2600
+#define BQ25896_VBUSV_LSB_MV        100
+// REG12 Charge Current (IBAT): code * 50mA
+#define BQ25896_ICHGR_LSB_MA        50
+// REG13 Input Current Limit in effect: 100mA + code * 50mA
+#define BQ25896_IDPM_LIM_OFFSET_MA  100
+#define BQ25896_IDPM_LIM_LSB_MA     50
+
+// Decoders take the field code (the 7 bit ADC value, 6 bit for IDPM_LIM)
+static inline uint16_t bq25896_decode_batv(uint8_t code){
+    return BQ25896_BATV_OFFSET_MV + code * BQ25896_BATV_LSB_MV;
+}
+static inline uint16_t bq25896_decode_sysv(uint8_t code){
+    return BQ25896_SYSV_OFFSET_MV + code * BQ25896_SYSV_LSB_MV;
+}
+// Returns whole percent, truncated like getTSPCT() always did
+static inline uint8_t bq25896_decode_tspct(uint8_t code){
+    return (BQ25896_TSPCT_OFFSET_MPCT + code * BQ25896_TSPCT_LSB_MPCT) / 1000;
+}
+static inline uint16_t bq25896_decode_vbusv(uint8_t code){
+    return BQ25896_VBUSV_OFFSET_MV + code * BQ25896_VBUSV_LSB_MV;
+}
+static inline uint16_t bq25896_decode_ichgr(uint8_t code){
+    return code * BQ25896_ICHGR_LSB_MA;
+}
+static inline uint16_t bq25896_decode_idpm_lim(uint8_t code){
+    return BQ25896_IDPM_LIM_OFFSET_MA + code * BQ25896_IDPM_LIM_LSB_MA;
+}
+
+// Calibrated decoders, nominal value corrected by cal (PMIC_BQ25896_cal.h)
+static inline uint16_t bq25896_decode_batv(uint8_t code, const bq25896_cal_t &cal){
+    return bq25896_cal_apply(cal.ch[BQ25896_CAL_BATV], bq25896_decode_batv(code));
+}
+static inline uint16_t bq25896_decode_sysv(uint8_t code, const bq25896_cal_t &cal){
+    return bq25896_cal_apply(cal.ch[BQ25896_CAL_SYSV], bq25896_decode_sysv(code));
+}
+static inline uint16_t bq25896_decode_vbusv(uint8_t code, const bq25896_cal_t &cal){
+    return bq25896_cal_apply(cal.ch[BQ25896_CAL_VBUSV], bq25896_decode_vbusv(code));
+}
+static inline uint16_t bq25896_decode_ichgr(uint8_t code, const bq25896_cal_t &cal){
+    return bq25896_cal_apply(cal.ch[BQ25896_CAL_ICHGR], bq25896_decode_ichgr(code));
+}
+
+// Number of registers in one ADC sample, REG0E - REG13
+#define BQ25896_ADC_SAMPLE_LEN (IDPM_LIM - BATV + 1)
+
+// One raw ADC sample as read in one burst from REG0E
+typedef union {
+    uint8_t raw[BQ25896_ADC_SAMPLE_LEN];
+    struct {
+        batv_reg_t batv;
+        sysv_reg_t sysv;
+        tspct_reg_t tspct;
+        vbusv_reg_t vbusv;
+        ichgr_reg_t ichgr;
+        idpm_lim_reg_t idpm_lim;
+    } __attribute__((packed));
+} bq25896_adc_sample_t;
+
+static_assert(sizeof(bq25896_adc_sample_t) == BQ25896_ADC_SAMPLE_LEN, "bq25896_adc_sample_t must match REG0E - REG13");
+
+// Status bits carried by the ADC registers, packed into one byte per sample
+#define BQ25896_ADC_FLAG_THERM_STAT 0x01  // REG0E[7] In Thermal Regulation
+#define BQ25896_ADC_FLAG_VBUS_GD    0x02  // REG11[7] VBUS Attached
+#define BQ25896_ADC_FLAG_IDPM_STAT  0x04  // REG13[6] In IINDPM
+#define BQ25896_ADC_FLAG_VDPM_STAT  0x08  // REG13[7] In VINDPM
+
+// Struct-of-arrays output of the bulk decoder, one element per sample
+// Any array may be NULL to skip that channel.
+typedef struct {
+    uint16_t *batv_mv;
+    uint16_t *sysv_mv;
+    uint8_t  *tspct_pct;
+    uint16_t *vbusv_mv;
+    uint16_t *ichgr_ma;
+    uint16_t *idpm_lim_ma;
+    uint8_t  *flags;
+} bq25896_adc_soa_t;
+
+// Samples decoded per block, small enough that a block of input stays in
+// L1 while every channel loop walks over it
+#define BQ25896_DECODE_BLOCK 512
+
+// Bulk decode kernel for one block. Each channel is its own loop over a
+// fixed stride so the compiler can vectorize the byte gather, mask,
+// multiply and add.
+// With cal the calibrated channels get a second pass over the block.
+template <size_t Stride>
+static inline void bq25896_decode_block(const uint8_t *src, size_t n, const bq25896_adc_soa_t &out,
+                                        const bq25896_cal_t *cal = NULL){
+    const uint8_t *p;
+    size_t i;
+    if(out.batv_mv){
+        p = src;
+        for(i = 0; i < n; i++) out.batv_mv[i] = BQ25896_BATV_OFFSET_MV + (p[i * Stride] & 0x7F) * BQ25896_BATV_LSB_MV;
+        if(cal) bq25896_cal_apply_n(cal->ch[BQ25896_CAL_BATV], out.batv_mv, n);
+    }
+    if(out.sysv_mv){
+        p = src + (SYSV - BATV);
+        for(i = 0; i < n; i++) out.sysv_mv[i] = BQ25896_SYSV_OFFSET_MV + (p[i * Stride] & 0x7F) * BQ25896_SYSV_LSB_MV;
+        if(cal) bq25896_cal_apply_n(cal->ch[BQ25896_CAL_SYSV], out.sysv_mv, n);
+    }
+    if(out.tspct_pct){
+        p = src + (TSPCT - BATV);
+        // x / 1000 as a multiply and shift, exact for every x up to 21000 + 127 * 465
+        for(i = 0; i < n; i++) out.tspct_pct[i] = ((uint32_t)(BQ25896_TSPCT_OFFSET_MPCT + (p[i * Stride] & 0x7F) * BQ25896_TSPCT_LSB_MPCT) * 16778u) >> 24;
+    }
+    if(out.vbusv_mv){
+        p = src + (VBUSV - BATV);
+        for(i = 0; i < n; i++) out.vbusv_mv[i] = BQ25896_VBUSV_OFFSET_MV + (p[i * Stride] & 0x7F) * BQ25896_VBUSV_LSB_MV;
+        if(cal) bq25896_cal_apply_n(cal->ch[BQ25896_CAL_VBUSV], out.vbusv_mv, n);
+    }
+    if(out.ichgr_ma){
+        p = src + (ICHGR - BATV);
+        for(i = 0; i < n; i++) out.ichgr_ma[i] = (p[i * Stride] & 0x7F) * BQ25896_ICHGR_LSB_MA;
+        if(cal) bq25896_cal_apply_n(cal->ch[BQ25896_CAL_ICHGR], out.ichgr_ma, n);
+    }
+    if(out.idpm_lim_ma){
+        p = src + (IDPM_LIM - BATV);
+        for(i = 0; i < n; i++) out.idpm_lim_ma[i] = BQ25896_IDPM_LIM_OFFSET_MA + (p[i * Stride] & 0x3F) * BQ25896_IDPM_LIM_LSB_MA;
+    }
+    if(out.flags){
+        const uint8_t *b = src;
+        const uint8_t *v = src + (VBUSV - BATV);
+        const uint8_t *d = src + (IDPM_LIM - BATV);
+        for(i = 0; i < n; i++){
+            out.flags[i] = (b[i * Stride] >> 7) | ((v[i * Stride] >> 6) & 0x02) | ((d[i * Stride] >> 4) & 0x0C);
+        }
+    }
+}
+
+template <size_t Stride>
+static inline void bq25896_decode_bulk_strided(const uint8_t *src, size_t n, const bq25896_adc_soa_t &out,
+                                               const bq25896_cal_t *cal = NULL){
+    for(size_t base = 0; base < n; base += BQ25896_DECODE_BLOCK){
+        size_t len = n - base < BQ25896_DECODE_BLOCK ? n - base : BQ25896_DECODE_BLOCK;
+        bq25896_adc_soa_t block = {
+            out.batv_mv ? out.batv_mv + base : NULL,
+            out.sysv_mv ? out.sysv_mv + base : NULL,
+            out.tspct_pct ? out.tspct_pct + base : NULL,
+            out.vbusv_mv ? out.vbusv_mv + base : NULL,
+            out.ichgr_ma ? out.ichgr_ma + base : NULL,
+            out.idpm_lim_ma ? out.idpm_lim_ma + base : NULL,
+            out.flags ? out.flags + base : NULL
+        };
+        bq25896_decode_block<Stride>(src + base * Stride, len, block, cal);
+    }
+}
+
+// Decodes n raw ADC samples into out.
+// src points at the REG0E byte of the first sample and stride is the
+// distance in bytes between samples: BQ25896_ADC_SAMPLE_LEN for packed
+// bq25896_adc_sample_t arrays, BQ25896_REG_COUNT for bq25896_regs_t
+// arrays (with src = &regs[0].raw[BATV]), or any record size.
+// BATV, SYSV, VBUSV and ICHGR are corrected by cal if given.
+// Results match getBATV(), getSYSV(), getTSPCT(), getVBUSV(), getICHGR()
+// and getIDPM_LIM() for the same register values and calibration.
+static inline void bq25896_decode_bulk(const uint8_t *src, size_t stride, size_t n, const bq25896_adc_soa_t &out,
+                                       const bq25896_cal_t *cal = NULL){
+    switch(stride){
+        case BQ25896_ADC_SAMPLE_LEN:
+        bq25896_decode_bulk_strided<BQ25896_ADC_SAMPLE_LEN>(src, n, out, cal);
+        break;
+        case BQ25896_REG_COUNT:
+        bq25896_decode_bulk_strided<BQ25896_REG_COUNT>(src, n, out, cal);
+        break;
+        default:
+        for(size_t i = 0; i < n; i++){
+            bq25896_adc_soa_t one = {
+                out.batv_mv ? out.batv_mv + i : NULL,
+                out.sysv_mv ? out.sysv_mv + i : NULL,
+                out.tspct_pct ? out.tspct_pct + i : NULL,
+                out.vbusv_mv ? out.vbusv_mv + i : NULL,
+                out.ichgr_ma ? out.ichgr_ma + i : NULL,
+                out.idpm_lim_ma ? out.idpm_lim_ma + i : NULL,
+                out.flags ? out.flags + i : NULL
+            };
+            bq25896_decode_block<1>(src + i * stride, 1, one, cal);
+        }
+    }
+}
+
+#endif
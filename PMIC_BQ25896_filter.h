@@ -0,0 +1,172 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_FILTER_H
+#define PMIC_BQ25896_FILTER_H
+
+// Noise filtering of the ADC channels
+// The 7 bit ADC readings toggle by one step (20mV, 50mA) between samples,
+// which makes threshold checks on raw values chatter. Each channel runs
+// the samples through three optional stages, in integer math:
+//   median    of the last median_len samples, drops single outliers
+//   IIR       y += (x - y) / 2^iir_shift, in Q8
+//   deadband  the output only moves when the IIR is more than deadband
+//             away from it, so a value sitting on a step holds still
+// Feed it every telemetry sample; the raw and the filtered value of each
+// channel stay readable. State is sized at compile time, nothing is allocated.
+
+#include <stdint.h>
+#include <string.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_ntc.h"
+#include "PMIC_BQ25896_channels.h"
+
+// Longest median window, sets the state size of every channel
+#ifndef BQ25896_FILTER_MEDIAN_MAX
+#define BQ25896_FILTER_MEDIAN_MAX 5
+#endif
+
+typedef struct {
+    // Median window, 0 or 1 = off, up to BQ25896_FILTER_MEDIAN_MAX
+    uint8_t median_len;
+    // IIR weight of a new sample is 1 / 2^iir_shift, 0 = off
+    uint8_t iir_shift;
+    // Hysteresis in the channel unit, 0 = off
+    uint16_t deadband;
+} bq25896_filter_config_t;
+
+typedef struct {
+    // Last median_len samples, a ring
+    int32_t window[BQ25896_FILTER_MEDIAN_MAX];
+    uint8_t pos;
+    uint8_t count;
+    // IIR output in Q8
+    int32_t iir_q8;
+    // Last input and output
+    int32_t raw;
+    int32_t value;
+    // Samples since init, 0 if raw and value are not valid
+    uint32_t samples;
+} bq25896_filter_state_t;
+
+typedef struct {
+    bq25896_filter_config_t config[BQ25896_ADC_CHANNELS];
+    bq25896_filter_state_t state[BQ25896_ADC_CHANNELS];
+    // TSPCT to temperature table and ADC calibration
+    const bq25896_ntc_lut_t *ntc;
+    const bq25896_cal_t *cal;
+} bq25896_filter_t;
+
+// Median 3, IIR 1/4 and a deadband of one ADC step (1.0 degC for TEMP)
+static const bq25896_filter_config_t bq25896_filter_default_config[BQ25896_ADC_CHANNELS] = {
+    { 3, 2, BQ25896_BATV_LSB_MV },
+    { 3, 2, BQ25896_SYSV_LSB_MV },
+    { 3, 2, BQ25896_VBUSV_LSB_MV },
+    { 3, 2, BQ25896_ICHGR_LSB_MA },
+    { 3, 2, 10 }
+};
+
+static inline void bq25896_filter_init(bq25896_filter_t &f, const bq25896_ntc_lut_t *ntc = &bq25896_ntc_default_lut,
+                                       const bq25896_cal_t *cal = &bq25896_cal_identity){
+    memset(&f, 0, sizeof(f));
+    memcpy(f.config, bq25896_filter_default_config, sizeof(f.config));
+    f.ntc = ntc;
+    f.cal = cal;
+}
+
+// Changes the stages of channel and restarts it
+static inline void bq25896_filter_configure(bq25896_filter_t &f, bq25896_adc_channel_t channel,
+                                            const bq25896_filter_config_t &config){
+    f.config[channel] = config;
+    if(f.config[channel].median_len > BQ25896_FILTER_MEDIAN_MAX) f.config[channel].median_len = BQ25896_FILTER_MEDIAN_MAX;
+    memset(&f.state[channel], 0, sizeof(f.state[channel]));
+}
+
+// Runs one sample through the stages of a channel, returns the output
+static inline int32_t bq25896_filter_step(bq25896_filter_state_t &s, const bq25896_filter_config_t &c, int32_t x){
+    s.raw = x;
+
+    if(c.median_len > 1){
+        s.window[s.pos] = x;
+        s.pos = s.pos + 1 < c.median_len ? s.pos + 1 : 0;
+        if(s.count < c.median_len) s.count++;
+        // Insertion sort of a copy, at most BQ25896_FILTER_MEDIAN_MAX values
+        int32_t sorted[BQ25896_FILTER_MEDIAN_MAX];
+        for(uint8_t i = 0; i < s.count; i++){
+            int32_t v = s.window[i];
+            uint8_t j = i;
+            while(j > 0 && sorted[j - 1] > v){
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+            sorted[j] = v;
+        }
+        x = sorted[s.count / 2];
+    }
+
+    if(c.iir_shift){
+        if(s.samples == 0) s.iir_q8 = x * 256;
+        else s.iir_q8 += (x * 256 - s.iir_q8) >> c.iir_shift;
+        x = (s.iir_q8 + 128) >> 8;
+    }
+
+    if(s.samples == 0 || x - s.value > (int32_t)c.deadband || s.value - x > (int32_t)c.deadband){
+        s.value = x;
+    }
+    s.samples++;
+    return s.value;
+}
+
+// Adds one ADC sample (REG0E - REG13) to every channel
+static inline void bq25896_filter_feed(bq25896_filter_t &f, const bq25896_adc_sample_t &s){
+    int32_t v[BQ25896_ADC_CHANNELS];
+    bq25896_adc_decode_channels(s, *f.cal, *f.ntc, v);
+    for(int c = 0; c < BQ25896_ADC_CHANNELS; c++){
+        bq25896_filter_step(f.state[c], f.config[c], v[c]);
+    }
+}
+
+// Same from a register snapshot holding REG0E - REG13
+static inline void bq25896_filter_feed(bq25896_filter_t &f, const bq25896_regs_t &regs){
+    bq25896_adc_sample_t s;
+    memcpy(s.raw, &regs.raw[BATV], BQ25896_ADC_SAMPLE_LEN);
+    bq25896_filter_feed(f, s);
+}
+
+// Last unfiltered value of channel
+static inline int32_t bq25896_filter_raw(const bq25896_filter_t &f, bq25896_adc_channel_t channel){
+    return f.state[channel].raw;
+}
+
+// Filtered value of channel
+static inline int32_t bq25896_filter_value(const bq25896_filter_t &f, bq25896_adc_channel_t channel){
+    return f.state[channel].value;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_LOG_H
+#define PMIC_BQ25896_LOG_H
+
+// Binary telemetry log format
+// A log is one bq25896_log_header_t followed by fixed size
+// bq25896_log_record_t records, each holding the raw REG00 - REG14 image
+// of one device at one point in time. All fields are little endian.
+// Records are plain register images so the host decodes them with the
+// same register views and decoders as the device (see
+// extras/tools/bq25896_logreplay.cpp).
+
+#include "PMIC_BQ25896_regs.h"
+
+#define BQ25896_LOG_MAGIC   0x474C5142  // "BQLG"
+#define BQ25896_LOG_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    // BQ25896_LOG_MAGIC
+    uint32_t magic;
+    // BQ25896_LOG_VERSION
+    uint16_t version;
+    // sizeof(bq25896_log_record_t), lets readers skip unknown trailing fields
+    uint16_t record_size;
+} bq25896_log_header_t;
+
+typedef struct __attribute__((packed)) {
+    // Capture time in microseconds, any epoch as long as it is monotonic per device
+    uint64_t timestamp_us;
+    // Identifies the charger the record belongs to
+    uint32_t device_id;
+    // REG00 - REG14 as read in one burst
+    bq25896_regs_t regs;
+} bq25896_log_record_t;
+
+static_assert(sizeof(bq25896_log_header_t) == 8, "bq25896_log_header_t layout");
+static_assert(sizeof(bq25896_log_record_t) == 12 + BQ25896_REG_COUNT, "bq25896_log_record_t layout");
+
+// Initializes a log header for the current format
+static inline void bq25896_log_init_header(bq25896_log_header_t *header){
+    header->magic = BQ25896_LOG_MAGIC;
+    header->version = BQ25896_LOG_VERSION;
+    header->record_size = sizeof(bq25896_log_record_t);
+}
+
+#endif
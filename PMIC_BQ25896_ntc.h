@@ -0,0 +1,189 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    Battery temperature from the TS pin voltage (REG10 TSPCT)
+
+    The TS pin sits on a divider from REGN: RT1 from REGN to TS and RT2
+    parallel to the NTC from TS to GND. bq25896_ntc_build() turns an NTC
+    (R25, Beta) and bias network into a lookup table of temperatures at
+    every BQ25896_NTC_LUT_STEP-th TSPCT code, once, with float math.
+    bq25896_ntc_decode() interpolates between table entries with integer
+    math only and returns 0.1 degC. With the default network the
+    table and interpolation error is below 0.3 degC over the whole code range.
+
+    bq25896_ntc_default_lut is the table for the network of the TI
+    evaluation module (103AT NTC, R25 = 10k, Beta = 3435, RT1 = 5.23k,
+    RT2 = 30.1k) and needs no build step.
+
+    JEITA zones are classified on the TS percentage against the charger's
+    own thresholds, so they match what the charger does whatever the NTC
+    table says. Threshold hysteresis is not modelled.
+
+    No Arduino dependency, usable on the host.
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_NTC_H
+#define PMIC_BQ25896_NTC_H
+
+#include <stdint.h>
+#include <math.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_units.h"
+
+// TSPCT codes between table entries, a power of two
+#define BQ25896_NTC_LUT_SHIFT   2
+#define BQ25896_NTC_LUT_STEP    (1 << BQ25896_NTC_LUT_SHIFT)
+// Entries for codes 0, STEP, ... 128, the last one closes the top segment
+#define BQ25896_NTC_LUT_LEN     (128 / BQ25896_NTC_LUT_STEP + 1)
+
+// Clamp of the table, 0.1 degC
+#define BQ25896_NTC_MIN_DC      (-400)
+#define BQ25896_NTC_MAX_DC      1250
+
+// JEITA thresholds, TS in milli-percent of REGN (typical)
+// T1 0 degC, T2 10 degC, T3 45 degC, T5 60 degC
+#define BQ25896_JEITA_T1_MPCT   73500
+#define BQ25896_JEITA_T2_MPCT   68000
+#define BQ25896_JEITA_T3_MPCT   44750
+#define BQ25896_JEITA_T5_MPCT   34375
+
+typedef struct {
+    // NTC resistance at 25 degC in Ohm
+    uint32_t r25;
+    // NTC Beta in K
+    uint16_t beta;
+    // REGN to TS in Ohm
+    uint32_t rt1;
+    // TS to GND, parallel to the NTC, in Ohm. 0 if not fitted
+    uint32_t rt2;
+} bq25896_ntc_config_t;
+
+typedef struct {
+    // Temperature at TSPCT code i * BQ25896_NTC_LUT_STEP in 0.1 degC
+    int16_t t_dc[BQ25896_NTC_LUT_LEN];
+} bq25896_ntc_lut_t;
+
+typedef enum {
+    // Below T1, charging suspended
+    BQ25896_JEITA_COLD = 0,
+    // T1 - T2, charge current reduced (JEITA_ISET)
+    BQ25896_JEITA_COOL,
+    // T2 - T3
+    BQ25896_JEITA_NORMAL,
+    // T3 - T5, charge voltage reduced unless JEITA_VSET
+    BQ25896_JEITA_WARM,
+    // Above T5, charging suspended
+    BQ25896_JEITA_HOT
+} bq25896_jeita_zone_t;
+
+// Charge limits the charger applies in a JEITA zone
+typedef struct {
+    uint16_t ichg_ma;
+    uint16_t vreg_mv;
+} bq25896_jeita_limits_t;
+
+// Generated with bq25896_ntc_build() for the network in the header comment
+static const bq25896_ntc_lut_t bq25896_ntc_default_lut = { {
+    848, 806, 767, 731, 696, 663, 632, 602, 573, 545, 518,
+    491, 465, 439, 414, 388, 363, 338, 312, 286, 260, 234,
+    207, 179, 149, 119, 86, 52, 14, -27, -74, -129, -198
+} };
+
+// Fills lut for an NTC and bias network, float math, call once at setup
+static inline void bq25896_ntc_build(const bq25896_ntc_config_t &cfg, bq25896_ntc_lut_t &lut){
+    for(int i = 0; i < BQ25896_NTC_LUT_LEN; i++){
+        double ts = (BQ25896_TSPCT_OFFSET_MPCT + (double)(i * BQ25896_NTC_LUT_STEP) * BQ25896_TSPCT_LSB_MPCT) / 100000.0;
+        // TS to GND resistance, then the NTC alone
+        double rp = ts * cfg.rt1 / (1.0 - ts);
+        double t;
+        if(cfg.rt2 && rp >= cfg.rt2){
+            t = BQ25896_NTC_MIN_DC;
+        }else{
+            double r = cfg.rt2 ? 1.0 / (1.0 / rp - 1.0 / cfg.rt2) : rp;
+            t = (1.0 / (1.0 / 298.15 + log(r / cfg.r25) / cfg.beta) - 273.15) * 10.0;
+        }
+        if(t < BQ25896_NTC_MIN_DC) t = BQ25896_NTC_MIN_DC;
+        if(t > BQ25896_NTC_MAX_DC) t = BQ25896_NTC_MAX_DC;
+        lut.t_dc[i] = (int16_t)(t < 0 ? t - 0.5 : t + 0.5);
+    }
+}
+
+// Temperature of TSPCT code in 0.1 degC, integer math only
+static inline int16_t bq25896_ntc_decode(const bq25896_ntc_lut_t &lut, uint8_t code){
+    code &= 0x7F;
+    uint8_t i = code >> BQ25896_NTC_LUT_SHIFT;
+    int32_t f = code & (BQ25896_NTC_LUT_STEP - 1);
+    int32_t a = lut.t_dc[i];
+    int32_t d = (lut.t_dc[i + 1] - a) * f;
+    // Round to nearest in both directions
+    d = (d >= 0 ? d + BQ25896_NTC_LUT_STEP / 2 : d - BQ25896_NTC_LUT_STEP / 2) / BQ25896_NTC_LUT_STEP;
+    return (int16_t)(a + d);
+}
+
+// JEITA zone of TSPCT code, a higher TS voltage is a colder battery
+static inline bq25896_jeita_zone_t bq25896_jeita_zone(uint8_t code){
+    uint32_t mpct = BQ25896_TSPCT_OFFSET_MPCT + (uint32_t)(code & 0x7F) * BQ25896_TSPCT_LSB_MPCT;
+    if(mpct >= BQ25896_JEITA_T1_MPCT) return BQ25896_JEITA_COLD;
+    if(mpct >= BQ25896_JEITA_T2_MPCT) return BQ25896_JEITA_COOL;
+    if(mpct > BQ25896_JEITA_T3_MPCT) return BQ25896_JEITA_NORMAL;
+    if(mpct > BQ25896_JEITA_T5_MPCT) return BQ25896_JEITA_WARM;
+    return BQ25896_JEITA_HOT;
+}
+
+// Charge current and voltage the charger uses in zone
+// jeita_iset (REG07): 0 - 50% of ICHG, 1 - 20% of ICHG in the cool zone
+// jeita_vset (REG09): 0 - VREG-200mV, 1 - VREG in the warm zone
+static inline bq25896_jeita_limits_t bq25896_jeita_limits(bq25896_jeita_zone_t zone, bool jeita_iset, bool jeita_vset,
+                                                          uint16_t ichg_ma, uint16_t vreg_mv){
+    bq25896_jeita_limits_t lim;
+    lim.ichg_ma = ichg_ma;
+    lim.vreg_mv = vreg_mv;
+    switch(zone){
+        case BQ25896_JEITA_COLD:
+        case BQ25896_JEITA_HOT:
+        lim.ichg_ma = 0;
+        break;
+        case BQ25896_JEITA_COOL:
+        lim.ichg_ma = ichg_ma * (jeita_iset ? 20 : 50) / 100;
+        break;
+        case BQ25896_JEITA_WARM:
+        if(!jeita_vset) lim.vreg_mv = vreg_mv - 200;
+        break;
+        default:
+        break;
+    }
+    return lim;
+}
+
+// Same from a register snapshot holding REG04, REG06, REG07, REG09 and REG10
+static inline bq25896_jeita_limits_t bq25896_jeita_limits(const bq25896_regs_t &regs){
+    return bq25896_jeita_limits(bq25896_jeita_zone(regs.tspct.tspct), regs.timer.jeita_iset, regs.ctrl1.jeita_vset,
+                                bq25896::Ichg::decode(regs.ichg.ichg), bq25896::Vreg::decode(regs.vreg.vreg));
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_POWER_H
+#define PMIC_BQ25896_POWER_H
+
+// Power path analytics from telemetry samples, integer math only
+// The BQ25896 does not measure input current, so input power is an upper
+// bound: VBUS times the effective input current limit, the lower of
+// IINLIM (REG00) and IDPM_LIM (REG13, the limit after ICO). Battery power
+// is BATV times ICHGR. Energy is integrated sample and hold, the power of
+// a sample counts until the next one.
+// A weak adapter or a lossy cable shows as VINDPM regulation (VBUS
+// collapsing under load) and a low charge share at a given input limit.
+
+#include <stdint.h>
+#include <string.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_units.h"
+
+typedef struct {
+    // Effective input current limit in mA, min(IINLIM, IDPM_LIM)
+    uint16_t ilim_ma;
+    // Input power upper bound in mW, 0 without VBUS
+    uint32_t pin_max_mw;
+    // Battery charge power in mW
+    uint32_t pbat_mw;
+    // SYSV - SYS_MIN in mV, how far the system rail is above its minimum
+    int16_t sys_headroom_mv;
+    // pbat_mw / pin_max_mw in per mille (capped at 1000), a lower bound of the charge efficiency
+    uint16_t charge_share_pm;
+    // VINDPM / IINDPM regulation active (REG13)
+    bool in_vdpm;
+    bool in_idpm;
+} bq25896_power_sample_t;
+
+typedef struct {
+    // Metrics of the last update
+    bq25896_power_sample_t last;
+    // Energy in mW * ms
+    uint64_t in_mwms;
+    uint64_t bat_mwms;
+    // Samples, and samples in VINDPM / IINDPM regulation
+    uint32_t samples;
+    uint32_t vdpm_samples;
+    uint32_t idpm_samples;
+    // Lowest sys_headroom_mv seen
+    int16_t min_headroom_mv;
+    // Longest interval integrated, longer gaps (sleep, missed polls) are cut to it
+    uint32_t max_gap_ms;
+    uint32_t last_ms;
+    bool have_last;
+    // ADC calibration of the board
+    const bq25896_cal_t *cal;
+} bq25896_power_t;
+
+static inline void bq25896_power_init(bq25896_power_t &p, uint32_t max_gap_ms = 10000,
+                                      const bq25896_cal_t *cal = &bq25896_cal_identity){
+    memset(&p, 0, sizeof(p));
+    p.max_gap_ms = max_gap_ms;
+    p.cal = cal;
+    p.min_headroom_mv = INT16_MAX;
+}
+
+// Metrics of one snapshot holding REG00, REG03 and REG0E - REG13
+static inline bq25896_power_sample_t bq25896_power_sample(const bq25896_regs_t &regs,
+                                                          const bq25896_cal_t &cal = bq25896_cal_identity){
+    bq25896_power_sample_t s;
+    uint16_t iinlim = bq25896::Iinlim::decode(regs.ilim.iinlim);
+    uint16_t idpm = bq25896_decode_idpm_lim(regs.idpm_lim.idpm_lim);
+    uint16_t batv = bq25896_decode_batv(regs.batv.batv, cal);
+    uint16_t sysv = bq25896_decode_sysv(regs.sysv.sysv, cal);
+    uint16_t ichgr = bq25896_decode_ichgr(regs.ichgr.ichgr, cal);
+    s.ilim_ma = iinlim < idpm ? iinlim : idpm;
+    s.pin_max_mw = regs.vbusv.vbus_gd ? (uint32_t)bq25896_decode_vbusv(regs.vbusv.vbusv, cal) * s.ilim_ma / 1000 : 0;
+    s.pbat_mw = (uint32_t)batv * ichgr / 1000;
+    s.sys_headroom_mv = (int16_t)(sysv - bq25896::SysMin::decode(regs.sys_ctrl.sys_min));
+    s.charge_share_pm = 0;
+    if(s.pin_max_mw){
+        uint32_t share = s.pbat_mw * 1000 / s.pin_max_mw;
+        s.charge_share_pm = share > 1000 ? 1000 : share;
+    }
+    s.in_vdpm = regs.idpm_lim.vdpm_stat;
+    s.in_idpm = regs.idpm_lim.idpm_stat;
+    return s;
+}
+
+// Adds a snapshot taken at now_ms (millis()) and returns its metrics
+static inline const bq25896_power_sample_t &bq25896_power_update(bq25896_power_t &p, const bq25896_regs_t &regs, uint32_t now_ms){
+    if(p.have_last){
+        uint32_t dt = now_ms - p.last_ms;
+        if(dt > p.max_gap_ms) dt = p.max_gap_ms;
+        p.in_mwms += (uint64_t)p.last.pin_max_mw * dt;
+        p.bat_mwms += (uint64_t)p.last.pbat_mw * dt;
+    }
+    p.last = bq25896_power_sample(regs, *p.cal);
+    p.last_ms = now_ms;
+    p.have_last = true;
+    p.samples++;
+    if(p.last.in_vdpm) p.vdpm_samples++;
+    if(p.last.in_idpm) p.idpm_samples++;
+    if(p.last.sys_headroom_mv < p.min_headroom_mv) p.min_headroom_mv = p.last.sys_headroom_mv;
+    return p.last;
+}
+
+// Input energy upper bound in mWh
+static inline uint32_t bq25896_power_in_mwh(const bq25896_power_t &p){
+    return (uint32_t)(p.in_mwms / 3600000u);
+}
+
+// Energy charged into the battery in mWh
+static inline uint32_t bq25896_power_bat_mwh(const bq25896_power_t &p){
+    return (uint32_t)(p.bat_mwms / 3600000u);
+}
+
+#endif
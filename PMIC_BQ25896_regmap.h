@@ -0,0 +1,323 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_REGMAP_H
+#define PMIC_BQ25896_REGMAP_H
+
+// Register map of REG00 - REG14, one line per field
+// Everything that walks the fields is generated from BQ25896_REGMAP: the
+// field ids and info table, the layout checks of the register views in
+// PMIC_BQ25896_regs.h, the generic field accessors (getFIELD/setFIELD),
+// the serializer and text dump, the power-on defaults and write masks of
+// the simulator and the self-clearing bits the register cache re-reads.
+// Add a field here and all of them pick it up.
+//
+// X(reg, view, field, ID, shift, width, access, reset, kind, offset, lsb, unit)
+//   reg, view, field  register address, bq25896_regs_t member and bit-field
+//   ID                upper case name of the field id, BQ25896_F_<ID>
+//   shift, width      bit position and size
+//   access            RW, RO (status), SC (self-clearing, reads back 0 once
+//                     done) or RC (latched, clears on read)
+//   reset             power-on field code
+//   kind              BOOL, CODE, LINEAR (offset + code * lsb), BOOST_LIM
+//                     (table) or TSPCT (milli-percent of REGN)
+//   unit              name suffix of the decoded value, may be empty
+// Fields are listed from the most significant bit down.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_units.h"
+
+// REG02[3:2] only exist on bq25890/bq25895 (PMIC_BQ25896_variant.h)
+#if BQ25896_VARIANT_HAS_HVDCP
+#define BQ25896_REGMAP_HVDCP(X) \
+    X(ADC_CTRL,   adc_ctrl,   hvdcp_en,       HVDCP_EN,       3, 1, RW, BQ25896_VARIANT_HVDCP_RESET, BOOL, 0, 0, ) \
+    X(ADC_CTRL,   adc_ctrl,   maxc_en,        MAXC_EN,        2, 1, RW, BQ25896_VARIANT_HVDCP_RESET, BOOL, 0, 0, )
+#else
+#define BQ25896_REGMAP_HVDCP(X)
+#endif
+
+#define BQ25896_REGMAP(X) \
+    /* REG00 */ \
+    X(ILIM,       ilim,       en_hiz,         EN_HIZ,         7, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(ILIM,       ilim,       en_ilim,        EN_ILIM,        6, 1, RW, 1,  BOOL,      0,    0,   ) \
+    X(ILIM,       ilim,       iinlim,         IINLIM,         0, 6, RW, 8,  LINEAR,    100,  50,  _ma) \
+    /* REG01 */ \
+    X(VINDPM_OS,  vindpm_os,  bhot,           BHOT,           6, 2, RW, 0,  CODE,      0,    0,   ) \
+    X(VINDPM_OS,  vindpm_os,  bcold,          BCOLD,          5, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(VINDPM_OS,  vindpm_os,  vindpm_os,      VINDPM_OS,      0, 5, RW, 6,  LINEAR,    0,    100, _mv) \
+    /* REG02 */ \
+    X(ADC_CTRL,   adc_ctrl,   conv_start,     CONV_START,     7, 1, SC, 0,  BOOL,      0,    0,   ) \
+    X(ADC_CTRL,   adc_ctrl,   conv_rate,      CONV_RATE,      6, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(ADC_CTRL,   adc_ctrl,   boost_freq,     BOOST_FREQ,     5, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(ADC_CTRL,   adc_ctrl,   ico_en,         ICO_EN,         4, 1, RW, 1,  BOOL,      0,    0,   ) \
+    BQ25896_REGMAP_HVDCP(X) \
+    X(ADC_CTRL,   adc_ctrl,   force_dpdm,     FORCE_DPDM,     1, 1, SC, 0,  BOOL,      0,    0,   ) \
+    X(ADC_CTRL,   adc_ctrl,   auto_dpdm_en,   AUTO_DPDM_EN,   0, 1, RW, 1,  BOOL,      0,    0,   ) \
+    /* REG03 */ \
+    X(SYS_CTRL,   sys_ctrl,   bat_loaden,     BAT_LOADEN,     7, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(SYS_CTRL,   sys_ctrl,   wd_rst,         WD_RST,         6, 1, SC, 0,  BOOL,      0,    0,   ) \
+    X(SYS_CTRL,   sys_ctrl,   otg_config,     OTG_CONFIG,     5, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(SYS_CTRL,   sys_ctrl,   chg_config,     CHG_CONFIG,     4, 1, RW, 1,  BOOL,      0,    0,   ) \
+    X(SYS_CTRL,   sys_ctrl,   sys_min,        SYS_MIN,        1, 3, RW, 5,  LINEAR,    3000, 100, _mv) \
+    X(SYS_CTRL,   sys_ctrl,   min_vbat_sel,   MIN_VBAT_SEL,   0, 1, RW, 0,  BOOL,      0,    0,   ) \
+    /* REG04 */ \
+    X(ICHG,       ichg,       en_pumpx,       EN_PUMPX,       7, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(ICHG,       ichg,       ichg,           ICHG,           0, 7, RW, 32, LINEAR,    0,    64,  _ma) \
+    /* REG05 */ \
+    X(IPRE_ITERM, ipre_iterm, iprechg,        IPRECHG,        4, 4, RW, 1,  LINEAR,    64,   64,  _ma) \
+    X(IPRE_ITERM, ipre_iterm, iterm,          ITERM,          0, 4, RW, 3,  LINEAR,    64,   64,  _ma) \
+    /* REG06 */ \
+    X(VREG,       vreg,       vreg,           VREG,           2, 6, RW, 23, LINEAR,    3840, 16,  _mv) \
+    X(VREG,       vreg,       batlowv,        BATLOWV,        1, 1, RW, 1,  BOOL,      0,    0,   ) \
+    X(VREG,       vreg,       vrechg,         VRECHG,         0, 1, RW, 0,  BOOL,      0,    0,   ) \
+    /* REG07 */ \
+    X(TIMER,      timer,      en_term,        EN_TERM,        7, 1, RW, 1,  BOOL,      0,    0,   ) \
+    X(TIMER,      timer,      stat_dis,       STAT_DIS,       6, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(TIMER,      timer,      watchdog,       WATCHDOG,       4, 2, RW, 1,  CODE,      0,    0,   ) \
+    X(TIMER,      timer,      en_timer,       EN_TIMER,       3, 1, RW, 1,  BOOL,      0,    0,   ) \
+    X(TIMER,      timer,      chg_timer,      CHG_TIMER,      1, 2, RW, 2,  CODE,      0,    0,   ) \
+    X(TIMER,      timer,      jeita_iset,     JEITA_ISET,     0, 1, RW, 1,  BOOL,      0,    0,   ) \
+    /* REG08 */ \
+    X(BAT_COMP,   bat_comp,   bat_comp,       BAT_COMP,       5, 3, RW, 0,  LINEAR,    0,    20,  _mohm) \
+    X(BAT_COMP,   bat_comp,   vclamp,         VCLAMP,         2, 3, RW, 0,  LINEAR,    0,    32,  _mv) \
+    X(BAT_COMP,   bat_comp,   treg,           TREG,           0, 2, RW, 3,  CODE,      0,    0,   ) \
+    /* REG09 */ \
+    X(CTRL1,      ctrl1,      force_ico,      FORCE_ICO,      7, 1, SC, 0,  BOOL,      0,    0,   ) \
+    X(CTRL1,      ctrl1,      tmr2x_en,       TMR2X_EN,       6, 1, RW, 1,  BOOL,      0,    0,   ) \
+    X(CTRL1,      ctrl1,      batfet_dis,     BATFET_DIS,     5, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(CTRL1,      ctrl1,      jeita_vset,     JEITA_VSET,     4, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(CTRL1,      ctrl1,      batfet_dly,     BATFET_DLY,     3, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(CTRL1,      ctrl1,      batfet_rst_en,  BATFET_RST_EN,  2, 1, RW, 1,  BOOL,      0,    0,   ) \
+    X(CTRL1,      ctrl1,      pumpx_up,       PUMPX_UP,       1, 1, SC, 0,  BOOL,      0,    0,   ) \
+    X(CTRL1,      ctrl1,      pumpx_dn,       PUMPX_DN,       0, 1, SC, 0,  BOOL,      0,    0,   ) \
+    /* REG0A */ \
+    X(BOOST_CTRL, boost_ctrl, boostv,         BOOSTV,         4, 4, RW, 7,  LINEAR,    4550, 64,  _mv) \
+    X(BOOST_CTRL, boost_ctrl, pfm_otg_dis,    PFM_OTG_DIS,    3, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(BOOST_CTRL, boost_ctrl, boost_lim,      BOOST_LIM,      0, 3, RW, 3,  BOOST_LIM, 0,    0,   _ma) \
+    /* REG0B */ \
+    X(VBUS_STAT,  vbus_stat,  vbus_stat,      VBUS_STAT,      5, 3, RO, 0,  CODE,      0,    0,   ) \
+    X(VBUS_STAT,  vbus_stat,  chrg_stat,      CHRG_STAT,      3, 2, RO, 0,  CODE,      0,    0,   ) \
+    X(VBUS_STAT,  vbus_stat,  pg_stat,        PG_STAT,        2, 1, RO, 0,  BOOL,      0,    0,   ) \
+    X(VBUS_STAT,  vbus_stat,  vsys_stat,      VSYS_STAT,      0, 1, RO, 0,  BOOL,      0,    0,   ) \
+    /* REG0C */ \
+    X(FAULT,      fault,      watchdog_fault, WATCHDOG_FAULT, 7, 1, RC, 0,  BOOL,      0,    0,   ) \
+    X(FAULT,      fault,      boost_fault,    BOOST_FAULT,    6, 1, RC, 0,  BOOL,      0,    0,   ) \
+    X(FAULT,      fault,      chrg_fault,     CHRG_FAULT,     4, 2, RC, 0,  CODE,      0,    0,   ) \
+    X(FAULT,      fault,      bat_fault,      BAT_FAULT,      3, 1, RC, 0,  BOOL,      0,    0,   ) \
+    X(FAULT,      fault,      ntc_fault,      NTC_FAULT,      0, 3, RC, 0,  CODE,      0,    0,   ) \
+    /* REG0D */ \
+    X(VINDPM,     vindpm,     force_vindpm,   FORCE_VINDPM,   7, 1, RW, 0,  BOOL,      0,    0,   ) \
+    X(VINDPM,     vindpm,     vindpm,         VINDPM,         0, 7, RW, 18, LINEAR,    2600, 100, _mv) \
+    /* REG0E - REG13 */ \
+    X(BATV,       batv,       therm_stat,     THERM_STAT,     7, 1, RO, 0,  BOOL,      0,    0,   ) \
+    X(BATV,       batv,       batv,           BATV,           0, 7, RO, 0,  LINEAR,    BQ25896_BATV_OFFSET_MV, BQ25896_BATV_LSB_MV, _mv) \
+    X(SYSV,       sysv,       sysv,           SYSV,           0, 7, RO, 0,  LINEAR,    BQ25896_SYSV_OFFSET_MV, BQ25896_SYSV_LSB_MV, _mv) \
+    X(TSPCT,      tspct,      tspct,          TSPCT,          0, 7, RO, 0,  TSPCT,     0,    0,   _mpct) \
+    X(VBUSV,      vbusv,      vbus_gd,        VBUS_GD,        7, 1, RO, 0,  BOOL,      0,    0,   ) \
+    X(VBUSV,      vbusv,      vbusv,          VBUSV,          0, 7, RO, 0,  LINEAR,    BQ25896_VBUSV_OFFSET_MV, BQ25896_VBUSV_LSB_MV, _mv) \
+    X(ICHGR,      ichgr,      ichgr,          ICHGR,          0, 7, RO, 0,  LINEAR,    0,    BQ25896_ICHGR_LSB_MA, _ma) \
+    X(IDPM_LIM,   idpm_lim,   vdpm_stat,      VDPM_STAT,      7, 1, RO, 0,  BOOL,      0,    0,   ) \
+    X(IDPM_LIM,   idpm_lim,   idpm_stat,      IDPM_STAT,      6, 1, RO, 0,  BOOL,      0,    0,   ) \
+    X(IDPM_LIM,   idpm_lim,   idpm_lim,       IDPM_LIM,       0, 6, RO, 0,  LINEAR,    BQ25896_IDPM_LIM_OFFSET_MA, BQ25896_IDPM_LIM_LSB_MA, _ma) \
+    /* REG14 */ \
+    X(CTRL2,      ctrl2,      reg_rst,        REG_RST,        7, 1, SC, 0,  BOOL,      0,    0,   ) \
+    X(CTRL2,      ctrl2,      ico_optimized,  ICO_OPTIMIZED,  6, 1, RO, 0,  BOOL,      0,    0,   ) \
+    X(CTRL2,      ctrl2,      pn,             PN,             3, 3, RO, BQ25896_VARIANT_PN, CODE, 0, 0, ) \
+    X(CTRL2,      ctrl2,      ts_profile,     TS_PROFILE,     2, 1, RO, 1,  BOOL,      0,    0,   ) \
+    X(CTRL2,      ctrl2,      dev_rev,        DEV_REV,        0, 2, RO, 2,  CODE,      0,    0,   )
+
+typedef enum {
+    BQ25896_ACCESS_RW = 0,
+    BQ25896_ACCESS_RO,
+    BQ25896_ACCESS_SC,
+    BQ25896_ACCESS_RC
+} bq25896_access_t;
+
+typedef enum {
+    BQ25896_KIND_BOOL = 0,
+    BQ25896_KIND_CODE,
+    BQ25896_KIND_LINEAR,
+    BQ25896_KIND_BOOST_LIM,
+    BQ25896_KIND_TSPCT
+} bq25896_kind_t;
+
+// Field ids, BQ25896_F_ICHG, BQ25896_F_CHRG_STAT, ...
+#define BQ25896_REGMAP_ID(reg, view, field, id, shift, width, access, reset, kind, offset, lsb, unit) BQ25896_F_##id,
+typedef enum {
+    BQ25896_REGMAP(BQ25896_REGMAP_ID)
+    BQ25896_FIELD_COUNT
+} bq25896_field_t;
+
+typedef struct {
+    // Field name with the unit of the decoded value, e.g. "ichg_ma"
+    const char *name;
+    uint8_t reg;
+    uint8_t shift;
+    uint8_t width;
+    uint8_t access;
+    uint8_t reset;
+    uint8_t kind;
+    uint16_t offset;
+    uint16_t lsb;
+} bq25896_field_info_t;
+
+#define BQ25896_REGMAP_INFO(reg, view, field, id, shift, width, access, reset, kind, offset, lsb, unit) \
+    { #field #unit, reg, shift, width, BQ25896_ACCESS_##access, reset, BQ25896_KIND_##kind, offset, lsb },
+static const bq25896_field_info_t bq25896_fields[BQ25896_FIELD_COUNT] = {
+    BQ25896_REGMAP(BQ25896_REGMAP_INFO)
+};
+
+// Layout check of every register view against the map
+#define BQ25896_REGMAP_CHECK(reg, view, field, id, shift, width, access, reset, kind, offset, lsb, unit) \
+    BQ25896_CHECK_FIELD(decltype(bq25896_regs_t::view), field, shift, width);
+BQ25896_REGMAP(BQ25896_REGMAP_CHECK)
+
+// Per register masks, OR of the fields of reg with the given access
+#define BQ25896_REGMAP_MASK(reg, view, field, id, shift, width, access, reset, kind, offset, lsb, unit) \
+    | (((reg) == r && BQ25896_ACCESS_##access == a) ? ((1u << (width)) - 1) << (shift) : 0u)
+#define BQ25896_REGMAP_RESET(reg, view, field, id, shift, width, access, reset, kind, offset, lsb, unit) \
+    | ((reg) == r ? (unsigned)(reset) << (shift) : 0u)
+
+constexpr uint8_t bq25896_regmap_mask(uint8_t r, bq25896_access_t a){
+    return (uint8_t)(0u BQ25896_REGMAP(BQ25896_REGMAP_MASK));
+}
+constexpr uint8_t bq25896_regmap_reset(uint8_t r){
+    return (uint8_t)(0u BQ25896_REGMAP(BQ25896_REGMAP_RESET));
+}
+
+#define BQ25896_REGMAP_TABLE(fn) { \
+    fn(0x00), fn(0x01), fn(0x02), fn(0x03), fn(0x04), fn(0x05), fn(0x06), \
+    fn(0x07), fn(0x08), fn(0x09), fn(0x0A), fn(0x0B), fn(0x0C), fn(0x0D), \
+    fn(0x0E), fn(0x0F), fn(0x10), fn(0x11), fn(0x12), fn(0x13), fn(0x14) }
+
+// Power-on field values, reserved bits read as 0
+static const uint8_t bq25896_reg_reset[BQ25896_REG_COUNT] = BQ25896_REGMAP_TABLE(bq25896_regmap_reset);
+// Bits a write changes, RW and SC fields
+#define BQ25896_REGMAP_WRITABLE(r) (uint8_t)(bq25896_regmap_mask(r, BQ25896_ACCESS_RW) | bq25896_regmap_mask(r, BQ25896_ACCESS_SC))
+static const uint8_t bq25896_reg_write_mask[BQ25896_REG_COUNT] = BQ25896_REGMAP_TABLE(BQ25896_REGMAP_WRITABLE);
+// Self-clearing bits
+#define BQ25896_REGMAP_SC(r) bq25896_regmap_mask(r, BQ25896_ACCESS_SC)
+static const uint8_t bq25896_reg_sc_mask[BQ25896_REG_COUNT] = BQ25896_REGMAP_TABLE(BQ25896_REGMAP_SC);
+// Bits cleared by reading the register
+#define BQ25896_REGMAP_RC(r) bq25896_regmap_mask(r, BQ25896_ACCESS_RC)
+static const uint8_t bq25896_reg_rc_mask[BQ25896_REG_COUNT] = BQ25896_REGMAP_TABLE(BQ25896_REGMAP_RC);
+
+// BOOST_LIM codes 0 - 6, code 7 is reserved
+#define BQ25896_BOOST_LIM_CODES 7
+static const uint16_t bq25896_boost_lim_ma[BQ25896_BOOST_LIM_CODES] = { 500, 750, 1200, 1400, 1650, 1875, 2150 };
+
+// Field code of id in a register image
+static inline uint8_t bq25896_field_get(const bq25896_regs_t &regs, bq25896_field_t id){
+    const bq25896_field_info_t &f = bq25896_fields[id];
+    return (regs.raw[f.reg] >> f.shift) & ((1u << f.width) - 1);
+}
+
+// Sets the field code of id in a register image, code is truncated to the field width
+static inline void bq25896_field_set(bq25896_regs_t &regs, bq25896_field_t id, uint8_t code){
+    const bq25896_field_info_t &f = bq25896_fields[id];
+    uint8_t mask = ((1u << f.width) - 1) << f.shift;
+    regs.raw[f.reg] = (regs.raw[f.reg] & ~mask) | ((code << f.shift) & mask);
+}
+
+// Decoded value of a field code in the unit of its name, flags and codes as is
+static inline int32_t bq25896_field_decode(bq25896_field_t id, uint8_t code){
+    const bq25896_field_info_t &f = bq25896_fields[id];
+    switch(f.kind){
+        case BQ25896_KIND_LINEAR:
+        return f.offset + (int32_t)code * f.lsb;
+        case BQ25896_KIND_BOOST_LIM:
+        return code < BQ25896_BOOST_LIM_CODES ? bq25896_boost_lim_ma[code] : 0;
+        case BQ25896_KIND_TSPCT:
+        return BQ25896_TSPCT_OFFSET_MPCT + (int32_t)code * BQ25896_TSPCT_LSB_MPCT;
+        default:
+        return code;
+    }
+}
+
+// Datasheet limits of the fields that have a named setter, the ranges of
+// PMIC_BQ25896_units.h; other fields accept their whole code range
+static inline bool bq25896_field_in_range(bq25896_field_t id, int32_t value){
+    switch(id){
+        case BQ25896_F_IINLIM:
+        return bq25896::Iinlim::in_range(value);
+        case BQ25896_F_VINDPM_OS:
+        return bq25896::VindpmOs::in_range(value);
+        case BQ25896_F_SYS_MIN:
+        return bq25896::SysMin::in_range(value);
+        case BQ25896_F_ICHG:
+        return bq25896::Ichg::in_range(value);
+        case BQ25896_F_IPRECHG:
+        return bq25896::Iprechg::in_range(value);
+        case BQ25896_F_ITERM:
+        return bq25896::Iterm::in_range(value);
+        case BQ25896_F_VREG:
+        return bq25896::Vreg::in_range(value);
+        case BQ25896_F_VCLAMP:
+        return bq25896::Vclamp::in_range(value);
+        case BQ25896_F_BOOSTV:
+        return bq25896::Boostv::in_range(value);
+        case BQ25896_F_VINDPM:
+        return bq25896::Vindpm::in_range(value);
+        default:
+        return true;
+    }
+}
+
+// Field code of value for id, false if value is not representable or
+// outside the datasheet limits. Linear fields round down
+static inline bool bq25896_field_encode(bq25896_field_t id, int32_t value, uint8_t &code){
+    const bq25896_field_info_t &f = bq25896_fields[id];
+    int32_t max = (1 << f.width) - 1;
+    int32_t c;
+    switch(f.kind){
+        case BQ25896_KIND_LINEAR:
+        if(!bq25896_field_in_range(id, value)) return false;
+        c = value < f.offset ? -1 : (value - f.offset) / f.lsb;
+        break;
+        case BQ25896_KIND_BOOST_LIM:
+        c = -1;
+        for(int32_t i = 0; i < BQ25896_BOOST_LIM_CODES; i++){
+            if(bq25896_boost_lim_ma[i] == value) c = i;
+        }
+        break;
+        case BQ25896_KIND_TSPCT:
+        c = value < BQ25896_TSPCT_OFFSET_MPCT ? -1 : (value - BQ25896_TSPCT_OFFSET_MPCT) / BQ25896_TSPCT_LSB_MPCT;
+        break;
+        default:
+        c = value;
+        break;
+    }
+    if(c < 0 || c > max) return false;
+    code = (uint8_t)c;
+    return true;
+}
+
+#endif
@@ -0,0 +1,637 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_REGS_H
+#define PMIC_BQ25896_REGS_H
+
+// Register map of the BQ25896
+// This header has no Arduino dependency so the register views can also be
+// used on the host to decode recorded register images.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PMIC_BQ25896_variant.h"
+
+typedef enum {
+    BQ25896_ADDR = 0x6B
+} bq25896_addr_t;
+
+typedef enum {
+    ILIM        = 0x00,
+    VINDPM_OS   = 0x01,
+    ADC_CTRL    = 0x02,
+    SYS_CTRL    = 0x03,
+    ICHG        = 0x04,
+    IPRE_ITERM  = 0x05,
+    VREG        = 0x06,
+    TIMER       = 0x07,
+    BAT_COMP    = 0x08,
+    CTRL1       = 0x09,
+    BOOST_CTRL  = 0x0A,
+    VBUS_STAT   = 0x0B,
+    FAULT       = 0x0C,
+    VINDPM      = 0x0D,
+    BATV        = 0x0E,
+    SYSV        = 0x0F,
+    TSPCT       = 0x10,
+    VBUSV       = 0x11,
+    ICHGR       = 0x12,
+    IDPM_LIM    = 0x13,
+    CTRL2       = 0x14
+} bq25896_reg_t;
+
+typedef enum {
+    BQ_OK = 0x00,
+    BQ_RANGE_ERR,
+    // The device did not acknowledge or returned fewer bytes than requested
+    BQ_BUS_ERR,
+    // The device did not finish the operation in time
+    BQ_TIMEOUT
+} bq25896_error_t;
+
+typedef struct __attribute__((packed)) {
+    // Input Current Limit
+    // Offset: 100mA 
+    // Range: 100mA (000000) – 3.25A (111111) (LSB = 50mA)
+    // Default:0001000 (500mA)
+    // (Actual input current limit is the lower of I2C or ILIM pin, changes with input type detection)
+    uint8_t iinlim:6;
+    // Enable ILIM Pin
+    // 0 – Disable
+    // 1 – Enable (default: Enable ILIM pin (1))
+    uint8_t en_ilim:1;
+    // Enable HIZ Mode
+    // 0 - Disable (default)
+    // 1 - Enable
+    uint8_t en_hiz:1;
+} ilim_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Input Voltage Limit Offset
+    // Default: 600mV (00110)
+    // Range: 0mV (00000) – 3100mV (11111) (LSB = 100mV)
+    // Minimum VINDPM threshold is clamped at 3.9V
+    // Maximum VINDPM threshold is clamped at 15.3V
+    uint8_t vindpm_os:5;
+    // Boost Mode Cold Temperature Monitor Threshold
+    // 0 – VBCOLD0 Threshold (Typ. 77%) (default)
+    // 1 – VBCOLD1 Threshold (Typ. 80%)
+    uint8_t bcold:1;
+    // Boost Mode Hot Temperature Monitor Threshold
+    // 00 – VBHOT1 Threshold (34.75%) (default)
+    // 01 – VBHOT0 Threshold (Typ. 37.75%)
+    // 10 – VBHOT2 Threshold (Typ. 31.25%)
+    // 11 – Disable boost mode thermal protection
+    uint8_t bhot:2;
+} vindpm_os_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Automatic Input Detection Enable
+    // 0 – Disable PSEL detection when VBUS is plugged-in
+    // 1 – Enable PEL detection when VBUS is plugged-in (default)
+    uint8_t auto_dpdm_en:1;
+    // Force Input Detection
+    // 0 – Not in PSEL detection (default)
+    // 1 – Force PSEL detection
+    uint8_t force_dpdm:1;
+#if BQ25896_VARIANT_HAS_HVDCP
+    // MaxCharge Adapter Enable (bq25890/bq25895, reserved on bq25896)
+    // 0 – Disable MaxCharge handshake
+    // 1 – Enable MaxCharge handshake (default)
+    uint8_t maxc_en:1;
+    // High Voltage DCP Enable (bq25890/bq25895, reserved on bq25896)
+    // 0 – Disable HVDCP handshake
+    // 1 – Enable HVDCP handshake (default)
+    uint8_t hvdcp_en:1;
+#else
+    // Reserved - both bits defualt to 0
+    uint8_t reserved:2;
+#endif
+    // Input Current Optimizer (ICO) Enable
+    // 0 – Disable ICO Algorithm
+    // 1 – Enable ICO Algorithm (default)
+    uint8_t ico_en:1;
+    // Boost Mode Frequency Selection
+    // 0 – 1.5MHz (default)
+    // 1 – 500KHz
+    // Note: Write to this bit is ignored when OTG_CONFIG is enabled.
+    uint8_t boost_freq:1;
+    // ADC Conversion Rate Selection
+    // 0 – One shot ADC conversion (default)
+    // 1 – Start 1s Continuous Conversion
+    uint8_t conv_rate:1;
+    // ADC Conversion Start Control
+    // 0 – ADC conversion not active (default).
+    // 1 – Start ADC Conversion
+    // This bit is read-only when CONV_RATE = 1. The bit stays high during ADC conversion and during input source detection.
+    uint8_t conv_start:1;
+} adc_ctrl_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Minimum Battery Voltage (falling) to exit boost mode
+    // 0 - 2.9V (default)
+    // 1 - 2.5V
+    uint8_t min_vbat_sel:1;
+    // Minimum System Voltage Limit
+    // Offset: 3.0V
+    // Range 3.0V (000) - 3.7V (111) (LSB = 0.1V)
+    // Default: 3.5V (101)
+    uint8_t sys_min:3;
+    // Charge Enable Configuration
+    // 0 - Charge Disable
+    // 1 - Charge Enable (default)
+    uint8_t chg_config:1;
+    // Boost (OTG) Mode Configuration
+    // 0 – OTG Disable (default)
+    // 1 – OTG Enable
+    uint8_t otg_config:1;
+    // I2C Watchdog Timer Reset
+    // 0 – Normal (default)
+    // 1 – Reset (Back to 0 after timer reset)
+    uint8_t wd_rst:1;
+    // Battery Load (IBATLOAD) Enable
+    // 0 – Disabled (default)
+    // 1 – Enabled
+    uint8_t bat_loaden:1;
+} sys_ctrl_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Fast Charge Current Limit
+    // Offset: 0mA
+    // Range: 0mA (0000000) – 3008mA (0101111) (LSB = 64mA)
+    // Default: 2048mA (0100000)
+    // Note: ICHG=000000 (0mA) disables charge
+    // Note: ICHG > 0101111 (3008mA) is clamped to register value 0101111 (3008mA)
+    // Note: bq25890/bq25895 range up to 5056mA (1001111), clamped there
+    uint8_t ichg:7;
+    // Current pulse control Enable
+    // 0 - Disable Current pulse control (default)
+    // 1- Enable Current pulse control (PUMPX_UP and PUMPX_DN)
+    uint8_t en_pumpx:1;
+} ichg_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Termination Current Limit
+    // Offset: 64mA
+    // Range: 64mA (0000) – 1024mA (1111) (LSB = 64mA)
+    // Default: 256mA (0011)
+    uint8_t iterm:4;
+    // Precharge Current Limit
+    // Offset: 64mA
+    // Range: 64mA (0000) – 1024mA (1111) (LSB = 64mA)
+    // Default: 128mA (0001)
+    uint8_t iprechg:4;
+} ipre_iterm_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Battery Recharge Threshold Offset (below Charge Voltage Limit)
+    // 0 – 100mV (VRECHG) below VREG (REG06[7:2]) (default)
+    // 1 – 200mV (VRECHG) below VREG (REG06[7:2])
+    uint8_t vrechg:1;
+    // Battery Precharge to Fast Charge Threshold
+    // 0 – 2.8V
+    // 1 – 3.0V (default)
+    uint8_t batlowv:1;
+    // Charge Voltage Limit
+    // Offset: 3.840V
+    // Range: 3.840V (00000) – 4.608V (110000) (LSB = 16mV)
+    // Default: 4.208V (010111)
+    // Note: VREG > 110000 (4.608V) is clamped to register value 110000 (4.608V)
+    uint8_t vreg:6;
+} vreg_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // JEITA Low Temperature Current Setting
+    // 0 – 50% of ICHG (REG04[6:0])
+    // 1 – 20% of ICHG (REG04[6:0]) (default)
+    uint8_t jeita_iset:1;
+    // Fast Charge Timer Setting
+    // 00 – 5 hrs
+    // 01 – 8 hrs
+    // 10 – 12 hrs (default)
+    // 11 – 20 hrs
+    uint8_t chg_timer:2;
+    // Charging Safety Timer Enable
+    // 0 – Disable
+    // 1 – Enable (default)
+    uint8_t en_timer:1;
+    // I2C Watchdog Timer Setting
+    // 00 – Disable watchdog timer
+    // 01 – 40s (default)
+    // 10 – 80s
+    // 11 – 160s
+    uint8_t watchdog:2;
+    // STAT Pin Disable
+    // 0 – Enable STAT pin function (default)
+    // 1 – Disable STAT pin function
+    uint8_t stat_dis:1;
+    // Charging Termination Enable
+    // 0 – Disable
+    // 1 – Enable (default)
+    uint8_t en_term:1;
+} timer_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Thermal Regulation Threshold
+    // 00 – 60°C
+    // 01 – 80°C
+    // 10 – 100°C
+    // 11 – 120°C (default)
+    uint8_t treg:2;
+    // IR Compensation Voltage Clamp
+    // above VREG (REG06[7:2])
+    // Offset: 0mV
+    // Range: 0mV (000) - 224mV (111) (LSB = 32mV)
+    // Default: 0mV (000)
+    uint8_t vclamp:3;
+    // IR Compensation Resistor Setting
+    // Range: 0mΩ (000) – 140mΩ (111) (LSB = 20mΩ)
+    // Default: 0Ω (000) (i.e. Disable IRComp)
+    uint8_t bat_comp:3;
+} bat_comp_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Current pulse control voltage down enable
+    // 0 – Disable (default)
+    // 1 – Enable
+    // Note: This bit is can only be set when EN_PUMPX bit is set and returns to 0 after current pulse control sequence is completed
+    uint8_t pumpx_dn:1;
+    // Current pulse control voltage up enable
+    // 0 – Disable (default)
+    // 1 – Enable
+    // Note: This bit is can only be set when EN_PUMPX bit is set and returns to 0 after current pulse control sequence is completed
+    uint8_t pumpx_up:1;
+    // BATFET full system reset enable
+    // 0 – Disable BATFET full system reset
+    // 1 – Enable BATFET full system reset (default)
+    uint8_t batfet_rst_en:1;
+    // BATFET turn off delay control
+    // 0 – BATFET turn off immediately when BATFET_DIS bit is set (default)
+    // 1 – BATFET turn off delay by tSM_DLY when BATFET_DIS bit is set
+    uint8_t batfet_dly:1;
+    // JEITA High Temperature Voltage Setting
+    // 0 – Set Charge Voltage to VREG-200mV during JEITA hig temperature (default)
+    // 1 – Set Charge Voltage to VREG during JEITA high temperature
+    uint8_t jeita_vset:1;
+    // Force BATFET off to enable ship mode
+    // 0 – Allow BATFET turn on (default)
+    // 1 – Force BATFET off
+    uint8_t batfet_dis:1;
+    // Safety Timer Setting during DPM or Thermal Regulation
+    // 0 – Safety timer not slowed by 2X during input DPM or thermal regulation
+    // 1 – Safety timer slowed by 2X during input DPM or thermal regulation (default)
+    uint8_t tmr2x_en:1;
+    // Force Start Input Current Optimizer (ICO)
+    // 0 – Do not force ICO (default)
+    // 1 – Force ICO
+    // Note: This bit is can only be set only and always returns to 0 after ICO starts
+    uint8_t force_ico:1;
+} ctrl1_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Boost Mode Current Limit
+    // 000: 0.5A
+    // 001: 0.75A
+    // 010: 1.2A
+    // 011: 1.4A (default)
+    // 100: 1.65A
+    // 101: 1.875A
+    // 110: 2.15A
+    // 111: Reserved
+    uint8_t boost_lim:3;
+    // PFM mode allowed in boost mode
+    // 0 – Allow PFM in boost mode (default)
+    // 1 – Disable PFM in boost mode
+    uint8_t pfm_otg_dis:1;
+    // Boost Mode Voltage Regulation
+    // Offset: 4.55V
+    // Range: 4.55V (0000) – 5.51V (1111) (LSB = 64mV)
+    // Default: 4.998V (0111)
+    uint8_t boostv:4;
+} boost_ctrl_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // VSYS Regulation Status
+    // 0 – Not in VSYSMIN regulation (BAT > VSYSMIN)
+    // 1 – In VSYSMIN regulation (BAT < VSYSMIN)
+    uint8_t vsys_stat:1;
+    // Reserved - always reads 1
+    uint8_t reserved:1;
+    // Power Good Status
+    // 0 – Not Power Good
+    // 1 – Power Good
+    uint8_t pg_stat:1;
+    // Charging Status
+    // 00 – Not Charging
+    // 01 – Pre-charge ( < VBATLOWV)
+    // 10 – Fast Charging
+    // 11 – Charge Termination Done
+    uint8_t chrg_stat:2;
+    // VBUS Status register
+    // 000: No Input
+    // 001: USB Host SDP
+    // 010: Adapter (3.25A)
+    // 111: OTG
+    // Note: Software current limit is reported in IINLIM register
+    uint8_t vbus_stat:3;
+} vbus_stat_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // NTC Fault Status
+    // Buck Mode:
+    // 000 – Normal
+    // 010 – TS Warm
+    // 011 – TS Cool
+    // 101 – TS Cold
+    // 110 – TS Hot
+    // Boost Mode:
+    // 000 – Normal
+    // 101 – TS Cold
+    // 110 – TS Hot
+    uint8_t ntc_fault:3;
+    // Battery Fault Status
+    // 0 – Normal
+    // 1 – BATOVP (VBAT > VBATOVP)
+    uint8_t bat_fault:1;
+    // Charge Fault Status
+    // 00 – Normal
+    // 01 – Input fault (VBUS > VACOV or VBAT < VBUS < VVBUSMIN(typical 3.8V))
+    // 10 - Thermal shutdown
+    // 11 – Charge Safety Timer Expiration
+    uint8_t chrg_fault:2;
+    // Boost Mode Fault Status
+    // 0 – Normal
+    // 1 – VBUS overloaded in OTG, or VBUS OVP, or battery is too low in boost mode
+    uint8_t boost_fault:1;
+    // Watchdog Fault Status
+    // 0 – Normal
+    // 1 - Watchdog timer expiration
+    uint8_t watchdog_fault:1;
+} fault_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Absolute VINDPM Threshold
+    // Offset: 2.6V
+    // Range: 3.9V (0001101) – 15.3V (1111111) (LSB = 100mV)
+    // Default: 4.4V (0010010)
+    // Note: Value < 0001101 is clamped to 3.9V (0001101)
+    // Register is read only when FORCE_VINDPM=0 and can be written by internal control based on relative VINDPM threshold setting
+    // Register can be read/write when FORCE_VINDPM = 1
+    // Note: Register is reset to default value when input source is plugged-in
+    uint8_t vindpm:7;
+    // VINDPM Threshold Setting Method
+    // 0 – Run Relative VINDPM Threshold (default)
+    // 1 – Run Absolute VINDPM Threshold
+    // Note: Register is reset to default value when input source is plugged-in
+    uint8_t force_vindpm:1;
+} vindpm_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // ADC conversion of Battery Voltage (VBAT)
+    // Offset: 2304mV
+    // Range: 2304mV (0000000) – 4848mV (1111111) (LSB = 20mV)
+    // Default: 2304mV (0000000)
+    uint8_t batv:7;
+    // Thermal Regulation Status
+    // 0 – Normal
+    // 1 – In Thermal Regulation
+    uint8_t therm_stat:1;
+} batv_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // ADC conversion of System Voltage (VSYS)
+    // Offset: 2304mV
+    // Range: 2304mV (0000000) – 4848mV (1111111) (LSB = 20mV)
+    // Default: 2304mV (0000000)
+    uint8_t sysv:7;
+    // Reserved - always reads 0
+    uint8_t reserved:1;
+} sysv_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // ADC conversion of TS Voltage (TS) as percentage of REGN
+    // Offset: 21%
+    // Range 21% (0000000) – 80% (1111111) (LSB = 0.465%)
+    // Default: 21% (0000000)
+    uint8_t tspct:7;
+    // Reserved - always reads 0
+    uint8_t reserved:1;
+} tspct_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // ADC conversion of VBUS voltage (VBUS)
+    // Offset: 2600mV
+    // Range 2600mV (0000000) – 15300mV (1111111) (LSB = 100mV)
+    // Default: 2600mV (0000000)
+    uint8_t vbusv:7;
+    // VBUS Good Status
+    // 0 – Not VBUS attached
+    // 1 – VBUS Attached
+    uint8_t vbus_gd:1;
+} vbusv_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // ADC conversion of Charge Current (IBAT) when VBAT > VBATSHORT
+    // Offset: 0mA
+    // Range 0mA (0000000) – 6350mA (1111111) (LSB = 50mA)
+    // Default: 0mA (0000000)
+    // Note: This register returns 0000000 for VBAT < VBATSHORT
+    uint8_t ichgr:7;
+    // Unused - always reads 0
+    uint8_t unused:1;
+} ichgr_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Input Current Limit in effect while Input Current Optimizer (ICO) is enabled
+    // Offset: 100mA
+    // Range 100mA (0000000) – 3.25mA (1111111) (LSB = 50mA)
+    // Default: 100mA (0000000)
+    uint8_t idpm_lim:6;
+    // IINDPM Status
+    // 0 – Not in IINDPM
+    // 1 – IINDPM
+    uint8_t idpm_stat:1;
+    // VINDPM Status
+    // 0 – Not in VINDPM
+    // 1 – VINDPM
+    uint8_t vdpm_stat:1;
+} idpm_lim_reg_t;
+
+typedef struct __attribute__((packed)) {
+    // Device Revision: 10
+    uint8_t dev_rev:2;
+    // Temperature Profile
+    // 1- JEITA (default)
+    uint8_t ts_profile:1;
+    // Device Configuration
+    // 000: bq25896 
+    // 011: bq25890
+    // 111: bq25895
+    uint8_t pn:3;
+    // Input Current Optimizer (ICO) Status
+    // 0 – Optimization is in progress
+    // 1 – Maximum Input Current Detected
+    uint8_t ico_optimized:1;
+    // Register Reset
+    // 0 – Keep current register setting (default)
+    // 1 – Reset to default register value and reset safety timer
+    // Note: Reset to 0 after register reset is completed
+    uint8_t reg_rst:1;
+} ctrl2_reg_t;
+
+// Number of registers, REG00 - REG14
+#define BQ25896_REG_COUNT 0x15
+
+// Register file image, laid out by register address so a burst read of
+// REG00 - REG14 lands in raw[] and can be read through the typed views
+// in place. Register images recorded on the device can be read the same
+// way on the host.
+typedef union {
+    uint8_t raw[BQ25896_REG_COUNT];
+    struct {
+        ilim_reg_t ilim;
+        vindpm_os_reg_t vindpm_os;
+        adc_ctrl_reg_t adc_ctrl;
+        sys_ctrl_reg_t sys_ctrl;
+        ichg_reg_t ichg;
+        ipre_iterm_reg_t ipre_iterm;
+        vreg_reg_t vreg;
+        timer_reg_t timer;
+        bat_comp_reg_t bat_comp;
+        ctrl1_reg_t ctrl1;
+        boost_ctrl_reg_t boost_ctrl;
+        vbus_stat_reg_t vbus_stat;
+        fault_reg_t fault;
+        vindpm_reg_t vindpm;
+        batv_reg_t batv;
+        sysv_reg_t sysv;
+        tspct_reg_t tspct;
+        vbusv_reg_t vbusv;
+        ichgr_reg_t ichgr;
+        idpm_lim_reg_t idpm_lim;
+        ctrl2_reg_t ctrl2;
+    } __attribute__((packed));
+} bq25896_regs_t;
+
+// Returns the raw register byte behind a register view
+template <typename T>
+inline uint8_t bq25896_raw(const T &reg){
+    static_assert(sizeof(T) == 1, "register views are one byte");
+    uint8_t raw;
+    memcpy(&raw, &reg, 1);
+    return raw;
+}
+
+// Returns a register view over a raw register byte
+template <typename T>
+inline T bq25896_view(uint8_t raw){
+    static_assert(sizeof(T) == 1, "register views are one byte");
+    T reg;
+    memcpy(&reg, &raw, 1);
+    return reg;
+}
+
+// Layout checks
+// Each register view must be exactly one byte and every field must sit on
+// the bits given in the datasheet. Bit positions are checked at compile
+// time where the compiler offers a constexpr bit cast, otherwise the check
+// falls back to the bit-field allocation order (LSB first on little endian).
+#define BQ25896_CHECK_SIZE(type) \
+    static_assert(sizeof(type) == 1, #type " must be one byte")
+
+BQ25896_CHECK_SIZE(ilim_reg_t);
+BQ25896_CHECK_SIZE(vindpm_os_reg_t);
+BQ25896_CHECK_SIZE(adc_ctrl_reg_t);
+BQ25896_CHECK_SIZE(sys_ctrl_reg_t);
+BQ25896_CHECK_SIZE(ichg_reg_t);
+BQ25896_CHECK_SIZE(ipre_iterm_reg_t);
+BQ25896_CHECK_SIZE(vreg_reg_t);
+BQ25896_CHECK_SIZE(timer_reg_t);
+BQ25896_CHECK_SIZE(bat_comp_reg_t);
+BQ25896_CHECK_SIZE(ctrl1_reg_t);
+BQ25896_CHECK_SIZE(boost_ctrl_reg_t);
+BQ25896_CHECK_SIZE(vbus_stat_reg_t);
+BQ25896_CHECK_SIZE(fault_reg_t);
+BQ25896_CHECK_SIZE(vindpm_reg_t);
+BQ25896_CHECK_SIZE(batv_reg_t);
+BQ25896_CHECK_SIZE(sysv_reg_t);
+BQ25896_CHECK_SIZE(tspct_reg_t);
+BQ25896_CHECK_SIZE(vbusv_reg_t);
+BQ25896_CHECK_SIZE(ichgr_reg_t);
+BQ25896_CHECK_SIZE(idpm_lim_reg_t);
+BQ25896_CHECK_SIZE(ctrl2_reg_t);
+
+static_assert(sizeof(bq25896_regs_t) == BQ25896_REG_COUNT, "bq25896_regs_t must match the register file");
+
+#define BQ25896_CHECK_OFFSET(member, reg) \
+    static_assert(offsetof(bq25896_regs_t, member) == reg, #member " must sit at its register address")
+
+BQ25896_CHECK_OFFSET(ilim, ILIM);
+BQ25896_CHECK_OFFSET(vindpm_os, VINDPM_OS);
+BQ25896_CHECK_OFFSET(adc_ctrl, ADC_CTRL);
+BQ25896_CHECK_OFFSET(sys_ctrl, SYS_CTRL);
+BQ25896_CHECK_OFFSET(ichg, ICHG);
+BQ25896_CHECK_OFFSET(ipre_iterm, IPRE_ITERM);
+BQ25896_CHECK_OFFSET(vreg, VREG);
+BQ25896_CHECK_OFFSET(timer, TIMER);
+BQ25896_CHECK_OFFSET(bat_comp, BAT_COMP);
+BQ25896_CHECK_OFFSET(ctrl1, CTRL1);
+BQ25896_CHECK_OFFSET(boost_ctrl, BOOST_CTRL);
+BQ25896_CHECK_OFFSET(vbus_stat, VBUS_STAT);
+BQ25896_CHECK_OFFSET(fault, FAULT);
+BQ25896_CHECK_OFFSET(vindpm, VINDPM);
+BQ25896_CHECK_OFFSET(batv, BATV);
+BQ25896_CHECK_OFFSET(sysv, SYSV);
+BQ25896_CHECK_OFFSET(tspct, TSPCT);
+BQ25896_CHECK_OFFSET(vbusv, VBUSV);
+BQ25896_CHECK_OFFSET(ichgr, ICHGR);
+BQ25896_CHECK_OFFSET(idpm_lim, IDPM_LIM);
+BQ25896_CHECK_OFFSET(ctrl2, CTRL2);
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+#define BQ25896_HAS_CONSTEXPR_BIT_CAST 1
+#endif
+#endif
+
+#ifdef BQ25896_HAS_CONSTEXPR_BIT_CAST
+// Setting only the field bits must read back as all ones in the field,
+// setting every other bit must read back as zero
+#define BQ25896_CHECK_FIELD(type, field, shift, width) \
+    static_assert(__builtin_bit_cast(type, (uint8_t)(((1u << (width)) - 1) << (shift))).field == (1u << (width)) - 1 && \
+                  __builtin_bit_cast(type, (uint8_t)~(((1u << (width)) - 1) << (shift))).field == 0, \
+                  #type "." #field " must be bits [" #shift "+:" #width "]")
+#else
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "register views assume LSB first bit-field allocation");
+#define BQ25896_CHECK_FIELD(type, field, shift, width)
+#endif
+
+// The fields are checked against the register map in PMIC_BQ25896_regmap.h
+
+#endif
@@ -0,0 +1,185 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "PMIC_BQ25896_serialize.h"
+
+// TSPCT adds "temp_dc" and "jeita_zone"
+#define SER_ENTRY_COUNT (BQ25896_FIELD_COUNT + 2)
+// Name column of the text format
+#define SER_TEXT_NAME_WIDTH 16
+
+// Bounded writer, counts what did not fit
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    size_t pos;
+} ser_out_t;
+
+static inline void ser_put(ser_out_t &o, uint8_t c){
+    if(o.pos < o.len) o.buf[o.pos] = c;
+    o.pos++;
+}
+
+static void ser_put_str(ser_out_t &o, const char *s, size_t n){
+    if(o.pos < o.len){
+        size_t room = o.len - o.pos;
+        memcpy(o.buf + o.pos, s, n < room ? n : room);
+    }
+    o.pos += n;
+}
+
+static void json_int(ser_out_t &o, int32_t v){
+    char digits[11];
+    uint8_t n = 0;
+    uint32_t u = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+    do{
+        digits[n++] = '0' + u % 10;
+        u /= 10;
+    }while(u);
+    if(v < 0) ser_put(o, '-');
+    while(n) ser_put(o, digits[--n]);
+}
+
+static void json_key(ser_out_t &o, const char *name, bool first){
+    if(!first) ser_put(o, ',');
+    ser_put(o, '"');
+    ser_put_str(o, name, strlen(name));
+    ser_put(o, '"');
+    ser_put(o, ':');
+}
+
+// CBOR head: major type and argument in the shortest form
+static void cbor_head(ser_out_t &o, uint8_t major, uint32_t arg){
+    major <<= 5;
+    if(arg < 24){
+        ser_put(o, major | arg);
+    }else if(arg <= 0xFF){
+        ser_put(o, major | 24);
+        ser_put(o, arg);
+    }else if(arg <= 0xFFFF){
+        ser_put(o, major | 25);
+        ser_put(o, arg >> 8);
+        ser_put(o, arg);
+    }else{
+        ser_put(o, major | 26);
+        ser_put(o, arg >> 24);
+        ser_put(o, arg >> 16);
+        ser_put(o, arg >> 8);
+        ser_put(o, arg);
+    }
+}
+
+static void cbor_int(ser_out_t &o, int32_t v){
+    if(v < 0) cbor_head(o, 1, (uint32_t)(-1 - v));
+    else cbor_head(o, 0, (uint32_t)v);
+}
+
+static void cbor_key(ser_out_t &o, const char *name){
+    size_t n = strlen(name);
+    cbor_head(o, 3, n);
+    ser_put_str(o, name, n);
+}
+
+// Text line "REGxx name value", names padded to one column
+static void text_line(ser_out_t &o, uint8_t reg, const char *name){
+    static const char hex[] = "0123456789ABCDEF";
+    ser_put_str(o, "REG", 3);
+    ser_put(o, hex[reg >> 4]);
+    ser_put(o, hex[reg & 0x0F]);
+    ser_put(o, ' ');
+    size_t n = strlen(name);
+    ser_put_str(o, name, n);
+    do{
+        ser_put(o, ' ');
+    }while(++n < SER_TEXT_NAME_WIDTH);
+}
+
+static void ser_int(ser_out_t &o, bq25896_format_t format, uint8_t reg, const char *name, bool first, int32_t v){
+    if(format == BQ25896_FORMAT_JSON){
+        json_key(o, name, first);
+        json_int(o, v);
+    }else if(format == BQ25896_FORMAT_CBOR){
+        cbor_key(o, name);
+        cbor_int(o, v);
+    }else{
+        text_line(o, reg, name);
+        json_int(o, v);
+        ser_put(o, '\n');
+    }
+}
+
+static void ser_bool(ser_out_t &o, bq25896_format_t format, uint8_t reg, const char *name, bool first, bool v){
+    if(format == BQ25896_FORMAT_JSON){
+        json_key(o, name, first);
+        if(v) ser_put_str(o, "true", 4);
+        else ser_put_str(o, "false", 5);
+    }else if(format == BQ25896_FORMAT_CBOR){
+        cbor_key(o, name);
+        ser_put(o, v ? 0xF5 : 0xF4);
+    }else{
+        text_line(o, reg, name);
+        ser_put(o, v ? '1' : '0');
+        ser_put(o, '\n');
+    }
+}
+
+size_t bq25896_serialize(const bq25896_regs_t &regs, void *buf, size_t len, bq25896_format_t format,
+                         const bq25896_ntc_lut_t *ntc){
+    ser_out_t o = { (uint8_t*)buf, len, 0 };
+
+    if(format == BQ25896_FORMAT_JSON) ser_put(o, '{');
+    else if(format == BQ25896_FORMAT_CBOR) cbor_head(o, 5, SER_ENTRY_COUNT);
+
+    for(uint8_t i = 0; i < BQ25896_FIELD_COUNT; i++){
+        const bq25896_field_info_t &f = bq25896_fields[i];
+        bq25896_field_t id = (bq25896_field_t)i;
+        uint8_t code = bq25896_field_get(regs, id);
+        bool first = i == 0;
+        switch(f.kind){
+            case BQ25896_KIND_BOOL:
+            ser_bool(o, format, f.reg, f.name, first, code);
+            break;
+            case BQ25896_KIND_TSPCT:
+            ser_int(o, format, f.reg, f.name, first, bq25896_field_decode(id, code));
+            ser_int(o, format, f.reg, "temp_dc", false, ntc ? bq25896_ntc_decode(*ntc, code) : 0);
+            ser_int(o, format, f.reg, "jeita_zone", false, bq25896_jeita_zone(code));
+            break;
+            default:
+            ser_int(o, format, f.reg, f.name, first, bq25896_field_decode(id, code));
+            break;
+        }
+    }
+
+    if(format == BQ25896_FORMAT_JSON) ser_put(o, '}');
+    if(format != BQ25896_FORMAT_CBOR){
+        // Terminator only if it fits, it is not part of the length
+        if(o.pos < o.len) o.buf[o.pos] = '\0';
+    }
+    return o.pos;
+}
@@ -0,0 +1,62 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_SERIALIZE_H
+#define PMIC_BQ25896_SERIALIZE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_ntc.h"
+#include "PMIC_BQ25896_regmap.h"
+
+// Snapshot serialization without heap use
+// Every field of REG00 - REG14 is written decoded (mA, mV, flags and
+// status codes) as one flat object, keyed by the lower case field name
+// with the unit appended, e.g. "vreg_mv", "chrg_stat", "ntc_fault".
+// TSPCT is also written as "temp_dc" (0.1 degC) and "jeita_zone".
+// JSON is a single line object, CBOR a definite length map with text keys,
+// TEXT one "REGxx name value" line per field for reading on a console.
+// Runs in one pass over the register map (PMIC_BQ25896_regmap.h).
+
+typedef enum {
+    BQ25896_FORMAT_JSON = 0x00,
+    BQ25896_FORMAT_CBOR,
+    BQ25896_FORMAT_TEXT
+} bq25896_format_t;
+
+// Writes regs into buf[0] ... buf[len - 1] and returns the number of bytes
+// the complete output takes. The output is complete only if that is <= len,
+// otherwise it is cut at len and the call can be repeated with a buffer of
+// the returned size. Nothing is written past buf[len - 1], buf may be NULL
+// when len is 0. JSON and TEXT are NUL terminated if the return value is < len.
+// ntc converts TSPCT to "temp_dc", see PMIC_BQ25896_ntc.h
+size_t bq25896_serialize(const bq25896_regs_t &regs, void *buf, size_t len, bq25896_format_t format,
+                         const bq25896_ntc_lut_t *ntc = &bq25896_ntc_default_lut);
+
+#endif
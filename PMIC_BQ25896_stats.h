@@ -0,0 +1,185 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_STATS_H
+#define PMIC_BQ25896_STATS_H
+
+// Streaming statistics per ADC channel
+// Each channel keeps min, max, mean and variance over a tumbling window of
+// samples plus a continuous EWMA, in integer math and constant memory.
+// Feed it the ADC registers of every telemetry read; alerting then reads
+// a few numbers instead of scanning stored samples.
+// Values are accumulated relative to the first sample of the window, so
+// with at most 65535 samples per window the variance is exact in int64.
+
+#include <stdint.h>
+#include <string.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_ntc.h"
+#include "PMIC_BQ25896_channels.h"
+
+typedef struct {
+    // Samples in the window, 0 if the other values are not valid
+    uint16_t count;
+    int32_t min;
+    int32_t max;
+    // Rounded to the channel unit
+    int32_t mean;
+    // Population variance in unit^2
+    uint32_t variance;
+    // Exponentially weighted moving average over all samples, not windowed
+    int32_t ewma;
+} bq25896_stat_result_t;
+
+typedef struct {
+    int32_t ref;
+    int32_t sum;
+    int64_t sumsq;
+    uint16_t count;
+    int32_t min;
+    int32_t max;
+    // EWMA in Q16, valid once ewma_init is set
+    int32_t ewma_q16;
+    bool ewma_init;
+} bq25896_stat_acc_t;
+
+typedef struct {
+    // Samples per window, 0 = until read with reset (still closed at 65535)
+    uint16_t window;
+    // EWMA weight of a new sample is 1 / 2^ewma_shift
+    uint8_t ewma_shift;
+    // TSPCT to temperature table
+    const bq25896_ntc_lut_t *ntc;
+    // ADC calibration of the board
+    const bq25896_cal_t *cal;
+    bq25896_stat_acc_t acc[BQ25896_ADC_CHANNELS];
+    // Results of the last completed window
+    bq25896_stat_result_t last[BQ25896_ADC_CHANNELS];
+    // Completed windows since init
+    uint32_t windows;
+} bq25896_stats_t;
+
+static inline void bq25896_stat_acc_clear(bq25896_stat_acc_t &a){
+    a.sum = 0;
+    a.sumsq = 0;
+    a.count = 0;
+}
+
+// Sets up stats with a window of window samples and an EWMA weight of 1 / 2^ewma_shift
+static inline void bq25896_stats_init(bq25896_stats_t &stats, uint16_t window, uint8_t ewma_shift,
+                                      const bq25896_ntc_lut_t *ntc = &bq25896_ntc_default_lut,
+                                      const bq25896_cal_t *cal = &bq25896_cal_identity){
+    memset(&stats, 0, sizeof(stats));
+    stats.window = window;
+    stats.ewma_shift = ewma_shift;
+    stats.ntc = ntc;
+    stats.cal = cal;
+}
+
+static inline bq25896_stat_result_t bq25896_stat_acc_result(const bq25896_stat_acc_t &a){
+    bq25896_stat_result_t r;
+    r.count = a.count;
+    r.ewma = a.ewma_init ? (a.ewma_q16 + 0x8000) >> 16 : 0;
+    if(a.count == 0){
+        r.min = r.max = r.mean = 0;
+        r.variance = 0;
+        return r;
+    }
+    int32_t n = a.count;
+    r.min = a.min;
+    r.max = a.max;
+    // Round half away from zero
+    r.mean = a.ref + (a.sum >= 0 ? (a.sum + n / 2) / n : (a.sum - n / 2) / n);
+    // (n * sum(d^2) - sum(d)^2) / n^2 with d = x - ref, fits in int64
+    int64_t num = (int64_t)n * a.sumsq - (int64_t)a.sum * a.sum;
+    r.variance = (uint32_t)(num / ((int64_t)n * n));
+    return r;
+}
+
+static inline void bq25896_stat_acc_add(bq25896_stat_acc_t &a, int32_t x, uint8_t ewma_shift){
+    if(a.count == 0){
+        a.ref = x;
+        a.min = x;
+        a.max = x;
+    }
+    int32_t d = x - a.ref;
+    a.sum += d;
+    a.sumsq += (int64_t)d * d;
+    a.count++;
+    if(x < a.min) a.min = x;
+    if(x > a.max) a.max = x;
+    if(!a.ewma_init){
+        a.ewma_q16 = x * 65536;
+        a.ewma_init = true;
+    }else{
+        a.ewma_q16 += (x * 65536 - a.ewma_q16) >> ewma_shift;
+    }
+}
+
+// Adds one ADC sample (REG0E - REG13) to every channel
+static inline void bq25896_stats_feed(bq25896_stats_t &stats, const bq25896_adc_sample_t &s){
+    int32_t v[BQ25896_ADC_CHANNELS];
+    bq25896_adc_decode_channels(s, *stats.cal, *stats.ntc, v);
+    uint16_t limit = stats.window ? stats.window : 0xFFFF;
+    bool closed = false;
+    for(int c = 0; c < BQ25896_ADC_CHANNELS; c++){
+        bq25896_stat_acc_t &a = stats.acc[c];
+        bq25896_stat_acc_add(a, v[c], stats.ewma_shift);
+        if(a.count >= limit){
+            stats.last[c] = bq25896_stat_acc_result(a);
+            bq25896_stat_acc_clear(a);
+            closed = true;
+        }
+    }
+    if(closed) stats.windows++;
+}
+
+// Same from a register snapshot holding REG0E - REG13
+static inline void bq25896_stats_feed(bq25896_stats_t &stats, const bq25896_regs_t &regs){
+    bq25896_adc_sample_t s;
+    memcpy(s.raw, &regs.raw[BATV], BQ25896_ADC_SAMPLE_LEN);
+    bq25896_stats_feed(stats, s);
+}
+
+// Results of the open window for channel. With reset the window is
+// restarted, so consecutive reads cover disjoint sample ranges (the EWMA
+// keeps running)
+static inline bq25896_stat_result_t bq25896_stats_read(bq25896_stats_t &stats, bq25896_adc_channel_t channel,
+                                                       bool reset = false){
+    bq25896_stat_result_t r = bq25896_stat_acc_result(stats.acc[channel]);
+    if(reset) bq25896_stat_acc_clear(stats.acc[channel]);
+    return r;
+}
+
+// Results of the last completed window for channel, count is 0 before the first one
+static inline const bq25896_stat_result_t &bq25896_stats_last(const bq25896_stats_t &stats, bq25896_adc_channel_t channel){
+    return stats.last[channel];
+}
+
+#endif
@@ -0,0 +1,405 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#include <string.h>
+#include "PMIC_BQ25896_store.h"
+#include "PMIC_BQ25896_crc.h"
+
+#define STORE_HEADER_LEN ((uint32_t)sizeof(bq25896_store_sector_header_t))
+// Type byte, 64 bit varint and every tracked register
+#define STORE_RECORD_MAX (1 + 10 + BQ25896_STORE_TRACKED)
+#define STORE_FAULT  0x80
+#define STORE_ERASED 0xFF
+
+// Register of each change mask bit
+static const uint8_t store_tracked[BQ25896_STORE_TRACKED] = { VBUS_STAT, BATV, SYSV, TSPCT, VBUSV, ICHGR, IDPM_LIM };
+
+static bool store_header_valid(const bq25896_store_sector_header_t &h){
+    return h.magic == BQ25896_STORE_MAGIC && h.version == BQ25896_STORE_VERSION &&
+           h.crc == bq25896_crc16((const uint8_t*)&h, sizeof(h) - 2);
+}
+
+// Backend read with the not yet programmed part of the page buffer laid over it
+static bool store_read(const bq25896_store_t &s, uint32_t addr, void *buf, uint32_t len){
+    if(s.backend.read(s.backend.ctx, addr, buf, len) != 0){
+        return false;
+    }
+    uint32_t lo = s.page_addr + s.page_done;
+    uint32_t hi = s.page_addr + s.page_len;
+    uint32_t a = addr > lo ? addr : lo;
+    uint32_t b = addr + len < hi ? addr + len : hi;
+    if(a < b) memcpy((uint8_t*)buf + (a - addr), s.page + (a - s.page_addr), b - a);
+    return true;
+}
+
+// Programs the appended part of the page buffer
+static bool store_program(bq25896_store_t &s){
+    if(s.page_len == s.page_done){
+        return true;
+    }
+    s.stats.programs++;
+    s.stats.program_bytes += s.page_len - s.page_done;
+    if(s.backend.prog(s.backend.ctx, s.page_addr + s.page_done, s.page + s.page_done, s.page_len - s.page_done) != 0){
+        s.stats.errors++;
+        return false;
+    }
+    s.page_done = s.page_len;
+    return true;
+}
+
+static void store_page_reset(bq25896_store_t &s, uint32_t addr){
+    s.page_addr = addr;
+    s.page_len = 0;
+    s.page_done = 0;
+    memset(s.page, STORE_ERASED, sizeof(s.page));
+}
+
+// Appends bytes at write_addr, programming every page that fills up
+static bool store_put(bq25896_store_t &s, const uint8_t *p, uint32_t n){
+    const uint16_t page_size = s.backend.page_size;
+    while(n){
+        uint32_t room = page_size - s.page_len;
+        uint32_t k = n < room ? n : room;
+        memcpy(s.page + s.page_len, p, k);
+        s.page_len += k;
+        s.write_addr += k;
+        p += k;
+        n -= k;
+        if(s.page_len == page_size){
+            if(!store_program(s)) return false;
+            store_page_reset(s, s.page_addr + page_size);
+        }
+    }
+    return true;
+}
+
+// Erases the sector after the head and starts it with a header at time_ms
+static bool store_start_sector(bq25896_store_t &s, uint64_t time_ms){
+    if(s.head < s.sectors && !store_program(s)){
+        return false;
+    }
+    uint32_t next = s.head < s.sectors ? (s.head + 1) % s.sectors : 0;
+    uint32_t addr = next * s.backend.sector_size;
+    bq25896_store_sector_header_t h;
+    uint32_t erases = 1;
+    if(s.backend.read(s.backend.ctx, addr, &h, sizeof(h)) == 0 && store_header_valid(h)){
+        erases = h.erases + 1;
+    }
+    s.stats.erases++;
+    if(s.backend.erase(s.backend.ctx, addr) != 0){
+        s.stats.errors++;
+        return false;
+    }
+    if(erases > s.stats.max_sector_erases) s.stats.max_sector_erases = erases;
+
+    s.head = next;
+    s.head_seq++;
+    s.write_addr = addr;
+    store_page_reset(s, addr);
+    memset(s.last, 0, sizeof(s.last));
+    s.last_ms = time_ms;
+
+    h.magic = BQ25896_STORE_MAGIC;
+    h.seq = s.head_seq;
+    h.base_ms = time_ms;
+    h.erases = erases;
+    h.version = BQ25896_STORE_VERSION;
+    h.reserved = 0;
+    h.crc = bq25896_crc16((const uint8_t*)&h, sizeof(h) - 2);
+    return store_put(s, (const uint8_t*)&h, sizeof(h));
+}
+
+static uint8_t store_put_varint(uint8_t *p, uint64_t v){
+    uint8_t n = 0;
+    while(v >= 0x80){
+        p[n++] = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+// Decodes the record at buf, avail bytes long at most, against the delta
+// state time_ms / last and updates it. Returns the record length, 0 at the
+// end of the sector's records.
+static uint32_t store_decode(const uint8_t *buf, uint32_t avail, uint64_t &time_ms, uint8_t *last,
+                             bq25896_store_entry_t *e){
+    if(avail == 0 || buf[0] == STORE_ERASED || (buf[0] & 0x80 && buf[0] != STORE_FAULT)){
+        return 0;
+    }
+    uint32_t n = 1;
+    uint64_t dt = 0;
+    for(uint8_t shift = 0; ; shift += 7){
+        if(n >= avail || shift > 63) return 0;
+        uint8_t b = buf[n++];
+        dt |= (uint64_t)(b & 0x7F) << shift;
+        if(!(b & 0x80)) break;
+    }
+    if(buf[0] == STORE_FAULT){
+        if(n >= avail) return 0;
+        time_ms += dt;
+        if(e){
+            memset(e, 0, sizeof(*e));
+            e->type = BQ25896_STORE_FAULT;
+            e->time_ms = time_ms;
+            e->regs.raw[FAULT] = buf[n];
+        }
+        return n + 1;
+    }
+    uint8_t mask = buf[0];
+    uint32_t end = n;
+    for(uint8_t i = 0; i < BQ25896_STORE_TRACKED; i++){
+        if(mask & (1 << i)) end++;
+    }
+    if(end > avail){
+        return 0;
+    }
+    time_ms += dt;
+    for(uint8_t i = 0; i < BQ25896_STORE_TRACKED; i++){
+        if(mask & (1 << i)) last[i] = buf[n++];
+    }
+    if(e){
+        memset(e, 0, sizeof(*e));
+        e->type = BQ25896_STORE_TELEMETRY;
+        e->time_ms = time_ms;
+        for(uint8_t i = 0; i < BQ25896_STORE_TRACKED; i++){
+            e->regs.raw[store_tracked[i]] = last[i];
+        }
+    }
+    return end;
+}
+
+static void store_reset(bq25896_store_t &s){
+    s.head = s.sectors;
+    s.head_seq = 0;
+    s.write_addr = 0;
+    store_page_reset(s, 0);
+    memset(s.last, 0, sizeof(s.last));
+    s.last_ms = 0;
+}
+
+bq25896_error_t bq25896_store_mount(bq25896_store_t &s, const bq25896_store_backend_t &backend){
+    memset(&s.stats, 0, sizeof(s.stats));
+    s.backend = backend;
+    if(backend.page_size == 0 || backend.page_size > BQ25896_STORE_PAGE_MAX ||
+       backend.sector_size % backend.page_size != 0 || backend.sector_size < STORE_HEADER_LEN + STORE_RECORD_MAX ||
+       backend.size % backend.sector_size != 0 || backend.size / backend.sector_size < 2){
+        s.sectors = 0;
+        return BQ_RANGE_ERR;
+    }
+    s.sectors = backend.size / backend.sector_size;
+    store_reset(s);
+
+    // The newest sector is the one with the highest sequence number
+    bool found = false;
+    bq25896_store_sector_header_t newest;
+    for(uint32_t i = 0; i < s.sectors; i++){
+        bq25896_store_sector_header_t h;
+        if(backend.read(backend.ctx, i * backend.sector_size, &h, sizeof(h)) != 0){
+            return BQ_BUS_ERR;
+        }
+        if(!store_header_valid(h)) continue;
+        if(h.erases > s.stats.max_sector_erases) s.stats.max_sector_erases = h.erases;
+        if(!found || (int32_t)(h.seq - newest.seq) > 0){
+            newest = h;
+            s.head = i;
+            found = true;
+        }
+    }
+    if(!found){
+        return BQ_OK;
+    }
+
+    // Replay the head sector to its last record for the delta state
+    uint32_t base = s.head * backend.sector_size;
+    uint32_t offset = STORE_HEADER_LEN;
+    s.head_seq = newest.seq;
+    s.last_ms = newest.base_ms;
+    while(offset < backend.sector_size){
+        uint8_t buf[STORE_RECORD_MAX];
+        uint32_t avail = backend.sector_size - offset;
+        if(avail > sizeof(buf)) avail = sizeof(buf);
+        if(backend.read(backend.ctx, base + offset, buf, avail) != 0){
+            return BQ_BUS_ERR;
+        }
+        uint32_t n = store_decode(buf, avail, s.last_ms, s.last, NULL);
+        if(n == 0) break;
+        offset += n;
+    }
+    s.write_addr = base + offset;
+    store_page_reset(s, s.write_addr - s.write_addr % backend.page_size);
+    s.page_len = s.page_done = s.write_addr - s.page_addr;
+    if(s.page_len && backend.read(backend.ctx, s.page_addr, s.page, s.page_len) != 0){
+        return BQ_BUS_ERR;
+    }
+    return BQ_OK;
+}
+
+bq25896_error_t bq25896_store_format(bq25896_store_t &s){
+    if(s.sectors == 0){
+        return BQ_RANGE_ERR;
+    }
+    for(uint32_t i = 0; i < s.sectors; i++){
+        s.stats.erases++;
+        if(s.backend.erase(s.backend.ctx, i * s.backend.sector_size) != 0){
+            s.stats.errors++;
+            return BQ_BUS_ERR;
+        }
+    }
+    store_reset(s);
+    return BQ_OK;
+}
+
+// Encodes a record against the head sector's delta state
+static uint32_t store_encode(const bq25896_store_t &s, uint8_t *rec, uint64_t time_ms, const bq25896_regs_t *regs,
+                             uint8_t fault){
+    uint64_t dt = time_ms > s.last_ms ? time_ms - s.last_ms : 0;
+    uint32_t n = 1;
+    n += store_put_varint(rec + n, dt);
+    if(!regs){
+        rec[0] = STORE_FAULT;
+        rec[n++] = fault;
+        return n;
+    }
+    uint8_t mask = 0;
+    for(uint8_t i = 0; i < BQ25896_STORE_TRACKED; i++){
+        uint8_t v = regs->raw[store_tracked[i]];
+        if(v != s.last[i]){
+            mask |= 1 << i;
+            rec[n++] = v;
+        }
+    }
+    rec[0] = mask;
+    return n;
+}
+
+static bq25896_error_t store_append(bq25896_store_t &s, uint64_t time_ms, const bq25896_regs_t *regs, uint8_t fault){
+    if(s.sectors == 0){
+        return BQ_RANGE_ERR;
+    }
+    uint8_t rec[STORE_RECORD_MAX];
+    uint32_t n = store_encode(s, rec, time_ms, regs, fault);
+    uint32_t sector_end = (s.head + 1) * s.backend.sector_size;
+    if(s.head >= s.sectors || s.write_addr + n > sector_end){
+        if(!store_start_sector(s, time_ms > s.last_ms ? time_ms : s.last_ms)){
+            return BQ_BUS_ERR;
+        }
+        n = store_encode(s, rec, time_ms, regs, fault);
+    }
+    if(!store_put(s, rec, n)){
+        return BQ_BUS_ERR;
+    }
+    if(time_ms > s.last_ms) s.last_ms = time_ms;
+    if(regs){
+        for(uint8_t i = 0; i < BQ25896_STORE_TRACKED; i++){
+            s.last[i] = regs->raw[store_tracked[i]];
+        }
+    }
+    s.stats.records++;
+    s.stats.record_bytes += n;
+    return BQ_OK;
+}
+
+bq25896_error_t bq25896_store_append(bq25896_store_t &s, uint64_t time_ms, const bq25896_regs_t &regs){
+    return store_append(s, time_ms, &regs, 0);
+}
+
+bq25896_error_t bq25896_store_append_fault(bq25896_store_t &s, uint64_t time_ms, fault_reg_t fault){
+    return store_append(s, time_ms, NULL, bq25896_raw(fault));
+}
+
+bq25896_error_t bq25896_store_flush(bq25896_store_t &s){
+    if(s.head >= s.sectors){
+        return BQ_OK;
+    }
+    return store_program(s) ? BQ_OK : BQ_BUS_ERR;
+}
+
+// Sector at ring position pos, 0 is the one after the head (the oldest once the ring wrapped)
+static uint32_t store_sector_at(const bq25896_store_t &s, uint32_t pos){
+    return (s.head + 1 + pos) % s.sectors;
+}
+
+bool bq25896_store_next(const bq25896_store_t &s, bq25896_store_cursor_t &c, bq25896_store_entry_t &e){
+    while(c.pos < s.sectors && s.head < s.sectors){
+        uint32_t base = store_sector_at(s, c.pos) * s.backend.sector_size;
+        if(c.offset == 0){
+            bq25896_store_sector_header_t h;
+            if(!store_read(s, base, &h, sizeof(h)) || !store_header_valid(h)){
+                c.pos++;
+                continue;
+            }
+            c.offset = STORE_HEADER_LEN;
+            c.time_ms = h.base_ms;
+            memset(c.last, 0, sizeof(c.last));
+        }
+        uint8_t buf[STORE_RECORD_MAX];
+        uint32_t avail = s.backend.sector_size - c.offset;
+        if(avail > sizeof(buf)) avail = sizeof(buf);
+        if(avail && store_read(s, base + c.offset, buf, avail)){
+            uint32_t n = store_decode(buf, avail, c.time_ms, c.last, &e);
+            if(n){
+                c.offset += n;
+                return true;
+            }
+        }
+        c.pos++;
+        c.offset = 0;
+    }
+    return false;
+}
+
+void bq25896_store_seek(const bq25896_store_t &s, bq25896_store_cursor_t &c, uint64_t time_ms){
+    memset(&c, 0, sizeof(c));
+    if(s.head >= s.sectors){
+        c.pos = s.sectors;
+        return;
+    }
+    // First ring position whose sector starts after time_ms. Sectors never
+    // written sort first, they only precede the oldest one.
+    uint32_t lo = 0;
+    uint32_t hi = s.sectors;
+    while(lo < hi){
+        uint32_t mid = lo + (hi - lo) / 2;
+        bq25896_store_sector_header_t h;
+        bool before = !store_read(s, store_sector_at(s, mid) * s.backend.sector_size, &h, sizeof(h)) ||
+                      !store_header_valid(h) || h.base_ms <= time_ms;
+        if(before) lo = mid + 1;
+        else hi = mid;
+    }
+    c.pos = lo ? lo - 1 : 0;
+
+    // Then the first record at or after time_ms from the start of that sector
+    bq25896_store_cursor_t at = c;
+    bq25896_store_entry_t e;
+    while(bq25896_store_next(s, at, e)){
+        if(e.time_ms >= time_ms) return;
+        c = at;
+    }
+    c = at;
+}
@@ -0,0 +1,184 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_STORE_H
+#define PMIC_BQ25896_STORE_H
+
+// Circular telemetry history in flash
+// Appends telemetry (REG0B, REG0E - REG13) and fault (REG0C) records to a
+// region of erase sectors used as a ring, the oldest sector is erased
+// when the ring wraps. Every sector starts with a header holding its
+// sequence number, the time of its first record and its erase count, and
+// decodes on its own, so a reboot resumes after the last record and a
+// seek by time is a binary search over sector headers plus a scan of one
+// sector.
+//
+// Records are delta encoded against the previous record of the sector:
+//   telemetry  0b0mmmmmmm, varint dt_ms, then the registers whose bit is
+//              set in m (bit 0 REG0B, bits 1 - 6 REG0E - REG13)
+//   fault      0x80, varint dt_ms, REG0C
+// A steady charge sample takes 3 - 5 bytes instead of 21.
+//
+// Appends go to a page buffer in RAM and reach the flash one full page at
+// a time (or on bq25896_store_flush()), the flash only ever sees page
+// programs and sequential sector erases. Records still in the buffer are
+// lost on a reset, flush before sleeping or after faults as needed.
+//
+// The flash is reached through bq25896_store_backend_t: a raw partition or
+// a LittleFS file on the ESP32 (PMIC_BQ25896_store_esp32.h), a file on
+// Linux (extras/host/bq25896_store_posix.h).
+
+#include <stddef.h>
+#include <stdint.h>
+#include "PMIC_BQ25896_regs.h"
+
+// Largest page size a backend may report, sets the RAM buffer size
+#ifndef BQ25896_STORE_PAGE_MAX
+#define BQ25896_STORE_PAGE_MAX 256
+#endif
+
+#define BQ25896_STORE_MAGIC    0x54535142  // "BQST"
+#define BQ25896_STORE_VERSION  1
+// Registers of a telemetry record, bit i of the change mask is register i
+#define BQ25896_STORE_TRACKED  7
+
+typedef struct {
+    // Region size, a multiple of sector_size
+    uint32_t size;
+    // Erase unit, e.g. 4096 for SPI NOR
+    uint32_t sector_size;
+    // Program unit the writes are batched to, <= BQ25896_STORE_PAGE_MAX
+    uint16_t page_size;
+    // Callbacks with region offsets, return 0 on success. prog only ever
+    // writes to erased bytes; erase erases the sector starting at addr.
+    int (*read)(void *ctx, uint32_t addr, void *buf, uint32_t len);
+    int (*prog)(void *ctx, uint32_t addr, const void *buf, uint32_t len);
+    int (*erase)(void *ctx, uint32_t addr);
+    void *ctx;
+} bq25896_store_backend_t;
+
+typedef struct __attribute__((packed)) {
+    // BQ25896_STORE_MAGIC
+    uint32_t magic;
+    // Increments with every sector started, the highest is the newest
+    uint32_t seq;
+    // Time of the first record, the base of its dt
+    uint64_t base_ms;
+    // Times this sector was erased
+    uint32_t erases;
+    // BQ25896_STORE_VERSION
+    uint8_t version;
+    uint8_t reserved;
+    // CRC-16/CCITT-FALSE of the bytes above
+    uint16_t crc;
+} bq25896_store_sector_header_t;
+
+static_assert(sizeof(bq25896_store_sector_header_t) == 24, "bq25896_store_sector_header_t layout");
+
+typedef struct {
+    // Records appended and encoded bytes
+    uint32_t records;
+    uint32_t record_bytes;
+    // Backend calls and bytes programmed
+    uint32_t programs;
+    uint32_t program_bytes;
+    uint32_t erases;
+    // Highest erase count of a sector seen since mount
+    uint32_t max_sector_erases;
+    // Backend calls that failed
+    uint32_t errors;
+} bq25896_store_stats_t;
+
+typedef struct {
+    bq25896_store_backend_t backend;
+    uint32_t sectors;
+    // Sector being written and its sequence number, sectors if none yet
+    uint32_t head;
+    uint32_t head_seq;
+    // Region offset of the next record
+    uint32_t write_addr;
+    // Page holding write_addr: its start, bytes appended and bytes already programmed
+    uint32_t page_addr;
+    uint16_t page_len;
+    uint16_t page_done;
+    uint8_t page[BQ25896_STORE_PAGE_MAX];
+    // Delta state of the head sector
+    uint8_t last[BQ25896_STORE_TRACKED];
+    uint64_t last_ms;
+    bq25896_store_stats_t stats;
+} bq25896_store_t;
+
+typedef enum {
+    BQ25896_STORE_TELEMETRY = 0x00,
+    BQ25896_STORE_FAULT
+} bq25896_store_record_type_t;
+
+typedef struct {
+    bq25896_store_record_type_t type;
+    uint64_t time_ms;
+    // Telemetry: REG0B and REG0E - REG13, fault: REG0C, the rest 0
+    bq25896_regs_t regs;
+} bq25896_store_entry_t;
+
+// Read position, from bq25896_store_seek()
+typedef struct {
+    // Position in the ring from the oldest sector, sectors when done
+    uint32_t pos;
+    // Offset in the sector, 0 before its header is read
+    uint32_t offset;
+    // Delta state
+    uint64_t time_ms;
+    uint8_t last[BQ25896_STORE_TRACKED];
+} bq25896_store_cursor_t;
+
+// Attaches the backend and finds the newest record, an empty or foreign
+// region starts empty (sectors are erased as they are reached).
+// BQ_RANGE_ERR for a geometry the store cannot use, BQ_BUS_ERR if the
+// backend fails
+bq25896_error_t bq25896_store_mount(bq25896_store_t &s, const bq25896_store_backend_t &backend);
+
+// Erases the whole region
+bq25896_error_t bq25896_store_format(bq25896_store_t &s);
+
+// Appends a telemetry record of regs taken at time_ms, time must not go back
+bq25896_error_t bq25896_store_append(bq25896_store_t &s, uint64_t time_ms, const bq25896_regs_t &regs);
+
+// Appends a fault record of a REG0C value
+bq25896_error_t bq25896_store_append_fault(bq25896_store_t &s, uint64_t time_ms, fault_reg_t fault);
+
+// Programs the records still buffered
+bq25896_error_t bq25896_store_flush(bq25896_store_t &s);
+
+// Positions c at the first record at or after time_ms (0 for the oldest)
+void bq25896_store_seek(const bq25896_store_t &s, bq25896_store_cursor_t &c, uint64_t time_ms);
+
+// Reads the record at c and advances c, false at the end. Buffered
+// records are included.
+bool bq25896_store_next(const bq25896_store_t &s, bq25896_store_cursor_t &c, bq25896_store_entry_t &e);
+
+#endif
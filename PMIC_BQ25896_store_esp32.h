@@ -0,0 +1,126 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_STORE_ESP32_H
+#define PMIC_BQ25896_STORE_ESP32_H
+
+// ESP32 backends of the flash history (PMIC_BQ25896_store.h)
+//   partition  a raw data partition, written with page programs and 4k
+//              sector erases, the least flash traffic per record
+//   LittleFS   a fixed size file, for boards without a spare partition.
+//              An erase rewrites the sector with 0xFF; LittleFS spreads
+//              the wear itself.
+
+#include "PMIC_BQ25896_store.h"
+
+#if defined(ESP32)
+
+#include <esp_partition.h>
+#include <string.h>
+#include <FS.h>
+
+#define BQ25896_STORE_ESP32_SECTOR 4096
+
+static int bq25896_store_partition_read(void *ctx, uint32_t addr, void *buf, uint32_t len){
+    return esp_partition_read((const esp_partition_t*)ctx, addr, buf, len) == ESP_OK ? 0 : -1;
+}
+
+static int bq25896_store_partition_prog(void *ctx, uint32_t addr, const void *buf, uint32_t len){
+    return esp_partition_write((const esp_partition_t*)ctx, addr, buf, len) == ESP_OK ? 0 : -1;
+}
+
+static int bq25896_store_partition_erase(void *ctx, uint32_t addr){
+    return esp_partition_erase_range((const esp_partition_t*)ctx, addr, BQ25896_STORE_ESP32_SECTOR) == ESP_OK ? 0 : -1;
+}
+
+// Backend on a data partition, e.g. from partitions.csv:
+//     bqlog, data, 0x99, , 64K
+// and esp_partition_find_first((esp_partition_type_t)0x99, ESP_PARTITION_SUBTYPE_ANY, "bqlog")
+static inline bq25896_store_backend_t bq25896_store_partition_backend(const esp_partition_t *part){
+    bq25896_store_backend_t b = {
+        part->size - part->size % BQ25896_STORE_ESP32_SECTOR, BQ25896_STORE_ESP32_SECTOR, BQ25896_STORE_PAGE_MAX,
+        bq25896_store_partition_read, bq25896_store_partition_prog, bq25896_store_partition_erase, (void*)part
+    };
+    return b;
+}
+
+static int bq25896_store_file_read(void *ctx, uint32_t addr, void *buf, uint32_t len){
+    fs::File *f = (fs::File*)ctx;
+    return f->seek(addr) && f->read((uint8_t*)buf, len) == len ? 0 : -1;
+}
+
+static int bq25896_store_file_prog(void *ctx, uint32_t addr, const void *buf, uint32_t len){
+    fs::File *f = (fs::File*)ctx;
+    if(!f->seek(addr) || f->write((const uint8_t*)buf, len) != len) return -1;
+    f->flush();
+    return 0;
+}
+
+static int bq25896_store_file_erase(void *ctx, uint32_t addr){
+    fs::File *f = (fs::File*)ctx;
+    uint8_t blank[64];
+    memset(blank, 0xFF, sizeof(blank));
+    if(!f->seek(addr)) return -1;
+    for(uint32_t n = 0; n < BQ25896_STORE_ESP32_SECTOR; n += sizeof(blank)){
+        if(f->write(blank, sizeof(blank)) != sizeof(blank)) return -1;
+    }
+    f->flush();
+    return 0;
+}
+
+// Opens path on fs (e.g. LittleFS) as a region of size bytes, created
+// erased if missing or of another size. The file must stay open while
+// the store is used.
+static inline bool bq25896_store_file_open(fs::FS &fs, const char *path, uint32_t size, fs::File &file){
+    size -= size % BQ25896_STORE_ESP32_SECTOR;
+    file = fs.open(path, "r+");
+    if(file && file.size() == size){
+        return true;
+    }
+    if(file) file.close();
+    file = fs.open(path, "w+");
+    if(!file) return false;
+    for(uint32_t addr = 0; addr < size; addr += BQ25896_STORE_ESP32_SECTOR){
+        if(bq25896_store_file_erase(&file, addr) != 0) return false;
+    }
+    return true;
+}
+
+// Backend on a file opened with bq25896_store_file_open()
+static inline bq25896_store_backend_t bq25896_store_file_backend(fs::File &file){
+    uint32_t size = file.size();
+    bq25896_store_backend_t b = {
+        size - size % BQ25896_STORE_ESP32_SECTOR, BQ25896_STORE_ESP32_SECTOR, BQ25896_STORE_PAGE_MAX,
+        bq25896_store_file_read, bq25896_store_file_prog, bq25896_store_file_erase, &file
+    };
+    return b;
+}
+
+#endif
+
+#endif
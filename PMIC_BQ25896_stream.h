@@ -0,0 +1,195 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_STREAM_H
+#define PMIC_BQ25896_STREAM_H
+
+// Framed binary telemetry stream
+// One frame per sample, 32 bytes on the wire instead of the ~500 bytes of
+// text examples/readConfig prints. Frame before COBS encoding, little endian:
+//   [0]       BQ25896_FRAME_VERSION
+//   [1..2]    sequence number, +1 per frame, wraps at 65535
+//   [3..6]    timestamp, millis() of the snapshot
+//   [7..27]   REG00 - REG14 as read in one burst
+//   [28..29]  CRC-16/CCITT-FALSE of bytes 0 - 27
+// COBS removes every zero byte from the frame and a single 0x00 ends it,
+// so a receiver joining mid-stream or losing bytes resynchronises on the
+// next zero. Sequence gaps show dropped frames, the CRC corrupted ones.
+// A sequence number going back or jumping further than
+// BQ25896_FRAME_RESYNC_GAP (a sender reboot) restarts the count instead.
+// The same code decodes on the host, see extras/tools/bq25896_stream_decode.cpp.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "PMIC_BQ25896_regs.h"
+#include "PMIC_BQ25896_crc.h"
+
+#define BQ25896_FRAME_VERSION       1
+#define BQ25896_FRAME_PAYLOAD_LEN   (7 + BQ25896_REG_COUNT + 2)
+// COBS adds one byte per 254 and the 0x00 delimiter
+#define BQ25896_FRAME_MAX           (BQ25896_FRAME_PAYLOAD_LEN + 2)
+
+// Largest sequence gap counted as dropped frames
+#ifndef BQ25896_FRAME_RESYNC_GAP
+#define BQ25896_FRAME_RESYNC_GAP    1024
+#endif
+
+typedef struct {
+    uint16_t seq;
+    uint32_t timestamp_ms;
+    bq25896_regs_t regs;
+} bq25896_frame_t;
+
+// Receiver state and link statistics for bq25896_frame_feed()
+typedef struct {
+    uint8_t buf[BQ25896_FRAME_MAX];
+    uint8_t len;
+    // Frames seen so far, false until the first good frame
+    bool synced;
+    uint16_t last_seq;
+    // Good frames
+    uint32_t frames;
+    // Frames missing according to the sequence numbers, corrupt ones included
+    uint32_t dropped;
+    // Frames with a bad CRC, length, version or COBS code
+    uint32_t corrupt;
+    // Sequence restarts (sender reboots), not counted in dropped
+    uint32_t resyncs;
+} bq25896_frame_reader_t;
+
+// COBS encodes len bytes of in into out, no delimiter
+// out must hold len + len / 254 + 1 bytes. Returns the encoded length
+static inline size_t bq25896_cobs_encode(const uint8_t *in, size_t len, uint8_t *out){
+    size_t code_pos = 0;
+    size_t o = 1;
+    uint8_t code = 1;
+    for(size_t i = 0; i < len; i++){
+        if(in[i] == 0){
+            out[code_pos] = code;
+            code_pos = o++;
+            code = 1;
+        }else{
+            out[o++] = in[i];
+            if(++code == 0xFF){
+                out[code_pos] = code;
+                code_pos = o++;
+                code = 1;
+            }
+        }
+    }
+    out[code_pos] = code;
+    return o;
+}
+
+// Decodes a COBS block without delimiter into out (at most len bytes)
+// Returns the decoded length, or 0 if in is not valid COBS
+static inline size_t bq25896_cobs_decode(const uint8_t *in, size_t len, uint8_t *out){
+    size_t i = 0;
+    size_t o = 0;
+    while(i < len){
+        uint8_t code = in[i++];
+        if(code == 0 || i + code - 1 > len) return 0;
+        for(uint8_t k = 1; k < code; k++){
+            if(in[i] == 0) return 0;
+            out[o++] = in[i++];
+        }
+        if(code != 0xFF && i < len) out[o++] = 0;
+    }
+    return o;
+}
+
+// Encodes one sample into out including the 0x00 delimiter
+// Returns the number of bytes to send, at most BQ25896_FRAME_MAX
+static inline size_t bq25896_frame_encode(uint16_t seq, uint32_t timestamp_ms, const bq25896_regs_t &regs,
+                                          uint8_t out[BQ25896_FRAME_MAX]){
+    uint8_t p[BQ25896_FRAME_PAYLOAD_LEN];
+    p[0] = BQ25896_FRAME_VERSION;
+    p[1] = seq;
+    p[2] = seq >> 8;
+    p[3] = timestamp_ms;
+    p[4] = timestamp_ms >> 8;
+    p[5] = timestamp_ms >> 16;
+    p[6] = timestamp_ms >> 24;
+    memcpy(&p[7], regs.raw, BQ25896_REG_COUNT);
+    uint16_t crc = bq25896_crc16(p, BQ25896_FRAME_PAYLOAD_LEN - 2);
+    p[BQ25896_FRAME_PAYLOAD_LEN - 2] = crc;
+    p[BQ25896_FRAME_PAYLOAD_LEN - 1] = crc >> 8;
+    size_t n = bq25896_cobs_encode(p, BQ25896_FRAME_PAYLOAD_LEN, out);
+    out[n++] = 0;
+    return n;
+}
+
+// Decodes one COBS block (delimiter removed) into frame
+// Returns false on a COBS, length, version or CRC error
+static inline bool bq25896_frame_decode(const uint8_t *in, size_t len, bq25896_frame_t *frame){
+    uint8_t p[BQ25896_FRAME_MAX];
+    if(len == 0 || len > BQ25896_FRAME_MAX - 1) return false;
+    if(bq25896_cobs_decode(in, len, p) != BQ25896_FRAME_PAYLOAD_LEN) return false;
+    if(p[0] != BQ25896_FRAME_VERSION) return false;
+    uint16_t crc = p[BQ25896_FRAME_PAYLOAD_LEN - 2] | (p[BQ25896_FRAME_PAYLOAD_LEN - 1] << 8);
+    if(bq25896_crc16(p, BQ25896_FRAME_PAYLOAD_LEN - 2) != crc) return false;
+    frame->seq = p[1] | (p[2] << 8);
+    frame->timestamp_ms = (uint32_t)p[3] | ((uint32_t)p[4] << 8) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 24);
+    memcpy(frame->regs.raw, &p[7], BQ25896_REG_COUNT);
+    return true;
+}
+
+static inline void bq25896_frame_reader_init(bq25896_frame_reader_t *r){
+    memset(r, 0, sizeof(*r));
+}
+
+// Feeds one received byte. Returns true when it completed a good frame,
+// which is then in frame. Updates the link statistics in r
+static inline bool bq25896_frame_feed(bq25896_frame_reader_t *r, uint8_t c, bq25896_frame_t *frame){
+    if(c != 0){
+        // Overlong blocks are counted as corrupt once their delimiter arrives
+        if(r->len < sizeof(r->buf)) r->buf[r->len] = c;
+        if(r->len < 0xFF) r->len++;
+        return false;
+    }
+    uint8_t len = r->len;
+    r->len = 0;
+    // Back to back delimiters carry no frame
+    if(len == 0) return false;
+    if(len > sizeof(r->buf) || !bq25896_frame_decode(r->buf, len, frame)){
+        r->corrupt++;
+        return false;
+    }
+    if(r->synced){
+        uint16_t gap = (uint16_t)(frame->seq - r->last_seq - 1);
+        if(gap < BQ25896_FRAME_RESYNC_GAP) r->dropped += gap;
+        else r->resyncs++;
+    }
+    r->synced = true;
+    r->last_seq = frame->seq;
+    r->frames++;
+    return true;
+}
+
+#endif
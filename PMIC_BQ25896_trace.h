@@ -0,0 +1,114 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_TRACE_H
+#define PMIC_BQ25896_TRACE_H
+
+// I2C transaction trace format
+// The driver hands every register transaction to the hook set with
+// PMIC_BQ25896::setTRACE_HOOK(). bq25896_trace_encode() packs a record
+// into 8 header bytes plus the data bytes, so a trace is a
+// bq25896_trace_header_t followed by encoded records. Traces replay on
+// the host through extras/host/bq25896_replay.h.
+
+#include "PMIC_BQ25896_regs.h"
+
+#define BQ25896_TRACE_MAGIC   0x52545142  // "BQTR"
+#define BQ25896_TRACE_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    // BQ25896_TRACE_MAGIC
+    uint32_t magic;
+    // BQ25896_TRACE_VERSION
+    uint16_t version;
+    // I2C address of the traced device
+    uint8_t addr;
+    uint8_t reserved;
+} bq25896_trace_header_t;
+
+typedef enum {
+    BQ25896_TRACE_READ  = 0x00,
+    BQ25896_TRACE_WRITE = 0x01
+} bq25896_trace_dir_t;
+
+// Set in status when the device returned fewer bytes than requested
+#define BQ25896_TRACE_SHORT_READ 0x80
+
+// Encoded size of a record without data
+#define BQ25896_TRACE_RECORD_HEADER_LEN 8
+
+typedef struct {
+    // micros() when the transaction completed, wraps after ~71 minutes
+    uint32_t timestamp_us;
+    // First register of the transaction
+    uint8_t reg;
+    // bq25896_trace_dir_t
+    uint8_t dir;
+    // TwoWire::endTransmission() result of the register write, ORed with
+    // BQ25896_TRACE_SHORT_READ on short reads
+    uint8_t status;
+    // Number of data bytes transferred
+    uint8_t len;
+    uint8_t data[BQ25896_REG_COUNT];
+} bq25896_trace_record_t;
+
+// Packs rec into buf, which must hold BQ25896_TRACE_RECORD_HEADER_LEN + rec->len bytes.
+// Returns the number of bytes written.
+static inline size_t bq25896_trace_encode(const bq25896_trace_record_t *rec, uint8_t *buf){
+    buf[0] = rec->timestamp_us;
+    buf[1] = rec->timestamp_us >> 8;
+    buf[2] = rec->timestamp_us >> 16;
+    buf[3] = rec->timestamp_us >> 24;
+    buf[4] = rec->reg;
+    buf[5] = rec->dir;
+    buf[6] = rec->status;
+    buf[7] = rec->len;
+    memcpy(&buf[BQ25896_TRACE_RECORD_HEADER_LEN], rec->data, rec->len);
+    return BQ25896_TRACE_RECORD_HEADER_LEN + rec->len;
+}
+
+// Unpacks one record from buf holding avail bytes.
+// Returns the number of bytes consumed, 0 if buf holds no complete valid record.
+static inline size_t bq25896_trace_decode(const uint8_t *buf, size_t avail, bq25896_trace_record_t *rec){
+    if(avail < BQ25896_TRACE_RECORD_HEADER_LEN){
+        return 0;
+    }
+    uint8_t len = buf[7];
+    if(len > BQ25896_REG_COUNT || avail < (size_t)BQ25896_TRACE_RECORD_HEADER_LEN + len){
+        return 0;
+    }
+    rec->timestamp_us = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+    rec->reg = buf[4];
+    rec->dir = buf[5];
+    rec->status = buf[6];
+    rec->len = len;
+    memcpy(rec->data, &buf[BQ25896_TRACE_RECORD_HEADER_LEN], len);
+    return BQ25896_TRACE_RECORD_HEADER_LEN + len;
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_TRACEPOINT_H
+#define PMIC_BQ25896_TRACEPOINT_H
+
+// Compile-time tracepoints
+// Timing markers inside the driver, for profiling with a cycle counter,
+// a SystemView style event ring or perf on the host. Unlike the I2C trace
+// hook (BQ25896_ENABLE_INSTRUMENTATION) they carry no data and cost no
+// runtime check: with BQ25896_ENABLE_TRACEPOINTS=0 (the default) every
+// BQ25896_TRACEPOINT() compiles to nothing and its arguments are not
+// evaluated.
+//
+// With BQ25896_ENABLE_TRACEPOINTS=1 each one calls
+//     void bq25896_tracepoint(bq25896_tp_t id, uint32_t arg);
+// which the application defines once, stamping the event with its own
+// clock. To route them elsewhere without the call, define
+// BQ25896_TRACEPOINT(id, arg) in the build flags instead, e.g. to a
+// SEGGER_SYSVIEW_RecordU32x2() or a perf USDT probe.
+//
+// The INT pin interrupt is the application's, so it marks the ISR itself
+// with BQ25896_TRACEPOINT(BQ25896_TP_INT_ISR, 0); the handler side is
+// PMIC_BQ25896_LowPower::service().
+
+#include <stdint.h>
+#include "PMIC_BQ25896_config.h"
+
+typedef enum {
+    // Register transaction, arg = reg | dir << 8 | len << 16
+    // (dir is a bq25896_trace_dir_t)
+    BQ25896_TP_BUS_BEGIN = 0x00,
+    // arg = endTransmission() status | bytes transferred << 8
+    BQ25896_TP_BUS_END,
+    // Field setter entry, arg = bq25896_field_t of the field written
+    BQ25896_TP_SETTER,
+    // Cache block re-read on a miss, arg = bq25896_cache_group_t
+    BQ25896_TP_CACHE_REFRESH,
+    // INT pin interrupt, from the application's ISR
+    BQ25896_TP_INT_ISR,
+    // INT handled, arg = bq25896_wake_t of the wake-up
+    BQ25896_TP_INT_HANDLER,
+    BQ25896_TP_COUNT
+} bq25896_tp_t;
+
+#define BQ25896_TP_BUS_ARG(reg, dir, len) ((uint32_t)(reg) | (uint32_t)(dir) << 8 | (uint32_t)(len) << 16)
+#define BQ25896_TP_BUS_END_ARG(status, count) ((uint32_t)(status) | (uint32_t)(count) << 8)
+
+#if BQ25896_ENABLE_TRACEPOINTS
+#ifndef BQ25896_TRACEPOINT
+// Defined by the application
+void bq25896_tracepoint(bq25896_tp_t id, uint32_t arg);
+#define BQ25896_TRACEPOINT(id, arg) bq25896_tracepoint((id), (uint32_t)(arg))
+#endif
+#else
+#undef BQ25896_TRACEPOINT
+#define BQ25896_TRACEPOINT(id, arg) ((void)0)
+#endif
+
+static inline const char *bq25896_tp_name(uint8_t id){
+    static const char *const names[BQ25896_TP_COUNT] = {
+        "bus_begin", "bus_end", "setter", "cache_refresh", "int_isr", "int_handler"
+    };
+    return id < BQ25896_TP_COUNT ? names[id] : "?";
+}
+
+// Event ring for a sink, fixed size and single producer. The sink pushes
+// with its own stamp (e.g. ESP.getCycleCount()), a task drains it; when
+// full the oldest events are overwritten and counted in dropped. Push
+// and drain from different cores need a lock around them.
+#ifndef BQ25896_TP_RING_LEN
+#define BQ25896_TP_RING_LEN 256
+#endif
+
+static_assert((BQ25896_TP_RING_LEN & (BQ25896_TP_RING_LEN - 1)) == 0, "BQ25896_TP_RING_LEN must be a power of two");
+
+typedef struct {
+    uint32_t stamp;
+    uint32_t arg;
+    uint8_t id;
+} bq25896_tp_event_t;
+
+typedef struct {
+    bq25896_tp_event_t events[BQ25896_TP_RING_LEN];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t dropped;
+} bq25896_tp_ring_t;
+
+static inline void bq25896_tp_ring_push(bq25896_tp_ring_t &r, bq25896_tp_t id, uint32_t arg, uint32_t stamp){
+    uint32_t head = r.head;
+    bq25896_tp_event_t &e = r.events[head & (BQ25896_TP_RING_LEN - 1)];
+    e.stamp = stamp;
+    e.arg = arg;
+    e.id = id;
+    if(head - r.tail >= BQ25896_TP_RING_LEN){
+        r.tail = r.tail + 1;
+        r.dropped++;
+    }
+    r.head = head + 1;
+}
+
+// Takes the oldest event, false if the ring is empty
+static inline bool bq25896_tp_ring_pop(bq25896_tp_ring_t &r, bq25896_tp_event_t &e){
+    uint32_t tail = r.tail;
+    if(tail == r.head){
+        return false;
+    }
+    e = r.events[tail & (BQ25896_TP_RING_LEN - 1)];
+    r.tail = tail + 1;
+    return true;
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    Physical units and register field encoders
+
+    The voltage and current setters take Millivolts or Milliamps in
+    addition to int, so a current can't be passed where a voltage is
+    expected:
+
+        pmic.setVREG(bq25896::Millivolts(4208));    // checked at runtime
+        pmic.setVREG(BQ25896_CONST(Vreg, 4208));    // encoded at compile time
+
+    BQ25896_CONST() encodes a constant into the register field code while
+    compiling and is ill-formed if the value is out of the field's range.
+    The setter then only does the read-modify-write. Values only known at
+    runtime go through the Millivolts / Milliamps (or int) setters, which
+    return BQ_RANGE_ERR without writing if the value is out of range.
+
+    No Arduino dependency, usable on the host.
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_UNITS_H
+#define PMIC_BQ25896_UNITS_H
+
+#include <stdint.h>
+#include "PMIC_BQ25896_variant.h"
+
+namespace bq25896 {
+
+struct Millivolts {
+    uint16_t value;
+    constexpr explicit Millivolts(uint16_t v) : value(v) {}
+};
+
+struct Milliamps {
+    uint16_t value;
+    constexpr explicit Milliamps(uint16_t v) : value(v) {}
+};
+
+namespace literals {
+constexpr Millivolts operator"" _mV(unsigned long long v) { return Millivolts((uint16_t)v); }
+constexpr Milliamps operator"" _mA(unsigned long long v) { return Milliamps((uint16_t)v); }
+}
+
+// Register field holding (value - Offset) / Lsb for values Min - Max
+template <typename U, uint16_t Min, uint16_t Max, uint16_t Offset, uint16_t Lsb>
+struct Field {
+    typedef U unit_type;
+    static constexpr bool in_range(long long v) { return v >= Min && v <= Max; }
+    // Field code of v without a range check, check in_range() first
+    static constexpr uint8_t raw(long long v) { return (uint8_t)((v - Offset) / Lsb); }
+    static constexpr uint16_t decode(uint8_t code) { return Offset + code * Lsb; }
+};
+
+// REG00 Input Current Limit
+typedef Field<Milliamps, 100, 3250, 100, 50> Iinlim;
+// REG01 Input Voltage Limit Offset
+typedef Field<Millivolts, 0, 3100, 0, 100> VindpmOs;
+// REG03 Minimum System Voltage Limit
+typedef Field<Millivolts, 3000, 3700, 3000, 100> SysMin;
+// REG04 Fast Charge Current Limit, up to 3008mA on bq25896 and 5056mA on bq25890/bq25895
+typedef Field<Milliamps, 0, BQ25896_VARIANT_ICHG_MAX_MA, 0, 64> Ichg;
+// REG05 Precharge Current Limit
+typedef Field<Milliamps, 64, 1024, 64, 64> Iprechg;
+// REG05 Termination Current Limit
+typedef Field<Milliamps, 64, 1024, 64, 64> Iterm;
+// REG06 Charge Voltage Limit
+typedef Field<Millivolts, 3840, 4608, 3840, 16> Vreg;
+// REG08 IR Compensation Voltage Clamp
+typedef Field<Millivolts, 0, 224, 0, 32> Vclamp;
+// REG0A Boost Mode Voltage Regulation
+typedef Field<Millivolts, 4550, 5510, 4550, 64> Boostv;
+// REG0D Absolute VINDPM Threshold
+typedef Field<Millivolts, 3900, 15300, 2600, 100> Vindpm;
+
+// Field code of F, only made by the setters and BQ25896_CONST()
+template <typename F>
+struct Code {
+    uint8_t value;
+    constexpr explicit Code(uint8_t v) : value(v) {}
+};
+
+// Field code of the constant V, checked before anything narrows it
+template <typename F, long long V>
+constexpr Code<F> make_code() {
+    static_assert(F::in_range(V), "value out of range for this field");
+    return Code<F>(F::raw(V));
+}
+
+}
+
+// Encodes value for the field at compile time, ill-formed if out of range
+// e.g. pmic.setICHG(BQ25896_CONST(Ichg, 1024))
+#define BQ25896_CONST(field, value) (bq25896::make_code<bq25896::field, (value)>())
+
+#endif
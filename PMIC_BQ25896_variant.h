@@ -0,0 +1,105 @@
+/*
+
+    ESP32 Library for BQ25896 Power Management and Battery Charger IC from Texas Instrument
+
+    MIT License
+
+    Copyright (c) 2024 sqmsmu
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+*/
+
+#ifndef PMIC_BQ25896_VARIANT_H
+#define PMIC_BQ25896_VARIANT_H
+
+// BQ2589x family traits
+// The parts share the register map and differ in:
+//   bq25896  ICHG up to 3008mA, REG02[3:2] reserved (default 00)
+//   bq25890  ICHG up to 5056mA, REG02[3] HVDCP_EN and REG02[2] MAXC_EN
+//   bq25895  (both enabled by default)
+// BQ25896_VARIANT (PMIC_BQ25896_config.h) selects the traits at compile
+// time, so a build only carries the fields and limits of its part and no
+// access branches on it. A generic build carries the superset and checks
+// the limits against the part found by checkVARIANT().
+
+#include <stdint.h>
+#include "PMIC_BQ25896_config.h"
+
+// X(name, pn, ichg_max_ma, hvdcp)
+#define BQ25896_VARIANTS(X) \
+    X("bq25896", BQ25896_VARIANT_BQ25896, 3008, 0) \
+    X("bq25890", BQ25896_VARIANT_BQ25890, 5056, 1) \
+    X("bq25895", BQ25896_VARIANT_BQ25895, 5056, 1)
+
+#if BQ25896_VARIANT == BQ25896_VARIANT_BQ25896
+#define BQ25896_VARIANT_ICHG_MAX_MA 3008
+#define BQ25896_VARIANT_HAS_HVDCP 0
+#define BQ25896_VARIANT_PN BQ25896_VARIANT_BQ25896
+#elif BQ25896_VARIANT == BQ25896_VARIANT_BQ25890 || BQ25896_VARIANT == BQ25896_VARIANT_BQ25895
+#define BQ25896_VARIANT_ICHG_MAX_MA 5056
+#define BQ25896_VARIANT_HAS_HVDCP 1
+#define BQ25896_VARIANT_PN BQ25896_VARIANT
+#elif BQ25896_VARIANT == BQ25896_VARIANT_GENERIC
+// Widest limits, narrowed at runtime once the part is known
+#define BQ25896_VARIANT_ICHG_MAX_MA 5056
+#define BQ25896_VARIANT_HAS_HVDCP 1
+// The register map defaults (and the host simulator) are those of a bq25896
+#define BQ25896_VARIANT_PN BQ25896_VARIANT_BQ25896
+#else
+#error "BQ25896_VARIANT must be BQ25896_VARIANT_BQ25896, _BQ25890, _BQ25895 or _GENERIC"
+#endif
+
+// Power-on value of HVDCP_EN and MAXC_EN, 0 where the bits are reserved
+#define BQ25896_VARIANT_HVDCP_RESET (BQ25896_VARIANT_PN != BQ25896_VARIANT_BQ25896)
+
+// True for the PN codes of the family
+static inline bool bq25896_variant_known(uint8_t pn){
+#define BQ25896_VARIANT_CASE(name, p, ichg, hvdcp) if(pn == (p)) return true;
+    BQ25896_VARIANTS(BQ25896_VARIANT_CASE)
+#undef BQ25896_VARIANT_CASE
+    return false;
+}
+
+// Part name of pn, "bq2589x" for the generic variant and unknown codes
+static inline const char *bq25896_variant_name(uint8_t pn){
+#define BQ25896_VARIANT_CASE(name, p, ichg, hvdcp) if(pn == (p)) return name;
+    BQ25896_VARIANTS(BQ25896_VARIANT_CASE)
+#undef BQ25896_VARIANT_CASE
+    return "bq2589x";
+}
+
+// Fast charge current limit of pn in mA, the widest for unknown codes
+static inline uint16_t bq25896_variant_ichg_max(uint8_t pn){
+#define BQ25896_VARIANT_CASE(name, p, ichg, hvdcp) if(pn == (p)) return ichg;
+    BQ25896_VARIANTS(BQ25896_VARIANT_CASE)
+#undef BQ25896_VARIANT_CASE
+    return 5056;
+}
+
+// True if pn has HVDCP_EN and MAXC_EN, false for unknown codes and the
+// generic variant, so the bits are not written before the part is probed
+static inline bool bq25896_variant_has_hvdcp(uint8_t pn){
+#define BQ25896_VARIANT_CASE(name, p, ichg, hvdcp) if(pn == (p)) return hvdcp;
+    BQ25896_VARIANTS(BQ25896_VARIANT_CASE)
+#undef BQ25896_VARIANT_CASE
+    return false;
+}
+
+#endif
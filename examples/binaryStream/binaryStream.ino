@@ -0,0 +1,30 @@
+// Binary telemetry stream over Serial
+// Sends one 32 byte COBS frame (sequence number, millis(), REG00 - REG14, CRC)
+// per sample instead of text. Decode on the host with
+// extras/tools/bq25896_stream_decode, e.g.
+//   bq25896_stream_decode --baud 115200 /dev/ttyUSB0
+
+#include "PMIC_BQ25896.h"
+#include "PMIC_BQ25896_stream.h"
+
+PMIC_BQ25896 bq25896;
+
+static uint16_t seq = 0;
+
+void setup(){
+  Serial.begin(115200);
+  bq25896.begin();
+  if(!bq25896.isConnected()){
+      while(1);
+  }
+  bq25896.setWATCHDOG(0); //disable watchdog
+  bq25896.setCONV_RATE(true); //continuous adc 1s read
+}
+
+void loop(){
+  bq25896_regs_t regs = bq25896.getSNAPSHOT();
+  uint8_t frame[BQ25896_FRAME_MAX];
+  size_t len = bq25896_frame_encode(seq++, millis(), regs, frame);
+  Serial.write(frame, len);
+  delay(10); //100 samples/s, 3.2kB/s
+}
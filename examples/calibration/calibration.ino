@@ -0,0 +1,61 @@
+// Board calibration of BATV against a multimeter, kept in NVS
+// Measure the battery with the meter and type the reading in mV on the
+// serial monitor, e.g. "3812". Each line adds a point against the ADC
+// reading of the same moment; repeat at a few charge levels, then type
+// "s" to fit and store. The record is loaded again on every boot.
+
+#include <Preferences.h>
+#include "PMIC_BQ25896.h"
+
+PMIC_BQ25896 bq25896;
+Preferences prefs;
+bq25896_cal_t cal = bq25896_cal_identity;
+bq25896_cal_fit_t fit;
+
+void setup(){
+  Serial.begin(115200);
+  bq25896.begin();
+  if(!bq25896.isConnected()){
+      Serial.println("BQ25896 not found! Check connection and power");
+      while(1);
+  }
+  bq25896.setWATCHDOG(0); //disable watchdog
+  bq25896.setCONV_RATE(true); //continuous adc 1s read
+
+  uint8_t buf[BQ25896_CAL_PACKED_LEN];
+  prefs.begin("bq25896");
+  if(prefs.getBytes("cal", buf, sizeof(buf)) == sizeof(buf) && bq25896_cal_unpack(cal, buf)){
+      Serial.println("Calibration loaded");
+  }
+  bq25896.setCALIBRATION(&cal);
+  bq25896_cal_fit_init(fit);
+}
+
+void loop(){
+  if(Serial.available()){
+      String line = Serial.readStringUntil('\n');
+      line.trim();
+      if(line == "s"){
+          if(bq25896_cal_fit_solve(fit, cal.ch[BQ25896_CAL_BATV]) == BQ_OK){
+              uint8_t buf[BQ25896_CAL_PACKED_LEN];
+              bq25896_cal_pack(cal, buf);
+              prefs.putBytes("cal", buf, sizeof(buf));
+              Serial.println("BATV gain " + String(cal.ch[BQ25896_CAL_BATV].gain) + "/32768, offset " +
+                             String(cal.ch[BQ25896_CAL_BATV].offset) + "mV stored");
+          }else{
+              Serial.println("No usable points");
+          }
+          bq25896_cal_fit_init(fit);
+      }else if(line.toInt() > 0){
+          // The fit takes the uncalibrated reading
+          uint16_t nominal = bq25896_decode_batv(bq25896.getBATV_reg().batv);
+          bq25896_cal_fit_add(fit, nominal, line.toInt());
+          Serial.println("Point " + String(fit.n) + ": ADC " + String(nominal) + "mV, meter " + line + "mV");
+      }
+  }
+  static uint32_t last = 0;
+  if(millis() - last >= 2000){
+      last = millis();
+      Serial.println("BATV : " + String(bq25896.getBATV()) + "mV");
+  }
+}
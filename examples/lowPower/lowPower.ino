@@ -0,0 +1,45 @@
+// Battery powered node that sleeps between charger events
+// INT of the BQ25896 wakes the ESP32 on plug-in, charge state changes and
+// faults, a timer wakes it once a minute for telemetry. Every wake costs
+// one I2C burst read.
+
+#include "PMIC_BQ25896.h"
+#include "PMIC_BQ25896_LowPower.h"
+
+#define BQ25896_INT_PIN 4
+
+PMIC_BQ25896 bq25896;
+PMIC_BQ25896_LowPower lowPower(bq25896);
+
+void setup(){
+  Serial.begin(115200);
+  bq25896.begin();
+  bq25896.setWATCHDOG(0); //disable watchdog, the host sleeps longer than 40s
+
+  bq25896_lowpower_config_t config;
+  config.int_pin = BQ25896_INT_PIN;
+  config.continuous_adc = false; //one-shot conversion per wake
+  config.telemetry_period_ms = 60000;
+  config.sleep = BQ25896_SLEEP_DEEP;
+  lowPower.begin(config);
+
+  uint8_t events = lowPower.service();
+  const bq25896_regs_t &regs = lowPower.getSNAPSHOT();
+
+  if(events & BQ25896_EVENT_POWER_GOOD){
+      Serial.println(regs.vbus_stat.pg_stat ? "Adapter plugged in" : "Adapter removed");
+  }
+  if(events & BQ25896_EVENT_CHARGE){
+      Serial.print("CHRG STAT:"); Serial.println(regs.vbus_stat.chrg_stat);
+  }
+  if(events & BQ25896_EVENT_FAULT){
+      Serial.print("FAULT:"); Serial.println(regs.raw[FAULT], HEX);
+  }
+  Serial.print("BATV : "); Serial.println(String(bq25896_decode_batv(regs.batv.batv)) + "mV");
+  Serial.flush();
+
+  lowPower.sleep(); //deep sleep, restarts in setup()
+}
+
+void loop(){
+}
@@ -0,0 +1,29 @@
+// Minimal charger setup and status poll
+// Used by extras/size_report.sh to measure the driver footprint per feature set,
+// build with -DBQ25896_ENABLE_BOOST=0 etc. to see what each feature costs.
+
+#include "PMIC_BQ25896.h"
+
+PMIC_BQ25896 bq25896;
+
+void setup(){
+  Serial.begin(115200);
+  bq25896.begin();
+  if(!bq25896.isConnected()){
+      Serial.println("BQ25896 not found! Check connection and power");
+      while(1);
+  }
+  bq25896.setEN_ILIM(false); //disable hardware ilim pin
+  bq25896.setWATCHDOG(0); //disable watchdog
+  bq25896.setIINLIM(1500); //set input current limit to 1500mA
+  bq25896.setICHG(1024); //set charging current to 1024mA
+  bq25896.setVREG(4208); //set charge voltage to 4208mV
+}
+
+void loop(){
+  bq25896_regs_t regs = bq25896.getSNAPSHOT();
+  Serial.print("CHRG STAT:"); Serial.print(regs.vbus_stat.chrg_stat);
+  Serial.print(" PG STAT:"); Serial.print(regs.vbus_stat.pg_stat);
+  Serial.print(" FAULT:"); Serial.println(regs.raw[FAULT], HEX);
+  delay(1000);
+}
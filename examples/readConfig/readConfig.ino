@@ -44,15 +44,19 @@ void loop(){
     Serial.print("BATV : "); Serial.println(String(bq25896.getBATV()) + "mV");
     Serial.print("SYSV : "); Serial.println(String(bq25896.getSYSV()) + "mV");
     Serial.print("TSPCT : "); Serial.println(String(bq25896.getTSPCT()) + "%");
+    int16_t temp = bq25896.getBatteryTemperature();
+    Serial.print("TEMP : "); Serial.println(String(temp < 0 ? "-" : "") + String(abs(temp) / 10) + "." + String(abs(temp) % 10) + "C");
     Serial.print("VBUSV : "); Serial.println(String(bq25896.getVBUSV()) + "mV");
     Serial.print("ICHGR : "); Serial.println(String(bq25896.getICHGR()) + "mA");
     
+    // REG0C clears on read, so read it once and use the copy
+    fault_reg_t fault = bq25896.getFAULT_reg();
     Serial.print("Fault -> "); 
-    Serial.print("NTC:" + String(bq25896.getFAULT_reg().ntc_fault));
-    Serial.print(" ,BAT:" + String(bq25896.getFAULT_reg().bat_fault));
-    Serial.print(" ,CHGR:" + String(bq25896.getFAULT_reg().chrg_fault));
-    Serial.print(" ,BOOST:" + String(bq25896.getFAULT_reg().boost_fault));
-    Serial.println(" ,WATCHDOG:" + String(bq25896.getFAULT_reg().watchdog_fault));
+    Serial.print("NTC:" + String(fault.ntc_fault));
+    Serial.print(" ,BAT:" + String(fault.bat_fault));
+    Serial.print(" ,CHGR:" + String(fault.chrg_fault));
+    Serial.print(" ,BOOST:" + String(fault.boost_fault));
+    Serial.println(" ,WATCHDOG:" + String(fault.watchdog_fault));
 
     Serial.print("Charging Status -> "); 
     Serial.print("CHG_EN:" + String(bq25896.getSYS_CTRL_reg().chg_config));
@@ -0,0 +1,34 @@
+// Telemetry as JSON or CBOR without heap allocation
+// The whole snapshot is serialized into a static buffer once per second,
+// ready to hand to an MQTT client's publish(topic, payload, length).
+
+#include "PMIC_BQ25896.h"
+#include "PMIC_BQ25896_serialize.h"
+
+PMIC_BQ25896 bq25896;
+
+// Holds the JSON of a full snapshot (about 1.2kB), CBOR takes about 830 bytes
+static char payload[1536];
+
+void setup(){
+  Serial.begin(115200);
+  bq25896.begin();
+  if(!bq25896.isConnected()){
+      Serial.println("BQ25896 not found! Check connection and power");
+      while(1);
+  }
+  bq25896.setWATCHDOG(0); //disable watchdog
+  bq25896.setCONV_RATE(true); //continuous adc 1s read
+}
+
+void loop(){
+  bq25896_regs_t regs = bq25896.getSNAPSHOT();
+  size_t len = bq25896_serialize(regs, payload, sizeof(payload), BQ25896_FORMAT_JSON);
+  if(len < sizeof(payload)){
+      Serial.println(payload);
+      // mqtt.publish("charger/telemetry", (const uint8_t*)payload, len);
+  }else{
+      Serial.print("payload buffer too small, need "); Serial.println(len + 1);
+  }
+  delay(1000);
+}
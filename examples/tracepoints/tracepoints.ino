@@ -0,0 +1,97 @@
+// Driver timing from the compile-time tracepoints
+// Build with -DBQ25896_ENABLE_TRACEPOINTS=1 (platformio.ini build_flags or
+// the arduino-cli compiler.cpp.extra_flags property), without it the
+// tracepoints compile to nothing and this sketch only polls.
+// The sink stamps each event with the CPU cycle counter into a ring,
+// loop() drains it and prints bus transaction and setter times and the
+// INT pin ISR to handler latency in cycles.
+
+#include "PMIC_BQ25896.h"
+#include "PMIC_BQ25896_LowPower.h"
+
+#define INT_PIN 4
+
+PMIC_BQ25896 bq25896;
+PMIC_BQ25896_LowPower lowpower(bq25896);
+bq25896_tp_ring_t ring;
+portMUX_TYPE ring_mux = portMUX_INITIALIZER_UNLOCKED;
+volatile bool int_pending = false;
+
+// The sink, called by every tracepoint of the driver and from onInt(), so
+// it lives in IRAM and pushes under the lock that loop() pops with
+void IRAM_ATTR bq25896_tracepoint(bq25896_tp_t id, uint32_t arg){
+  portENTER_CRITICAL_ISR(&ring_mux);
+  bq25896_tp_ring_push(ring, id, arg, ESP.getCycleCount());
+  portEXIT_CRITICAL_ISR(&ring_mux);
+}
+
+bool ringPop(bq25896_tp_event_t &e){
+  portENTER_CRITICAL(&ring_mux);
+  bool ok = bq25896_tp_ring_pop(ring, e);
+  portEXIT_CRITICAL(&ring_mux);
+  return ok;
+}
+
+void IRAM_ATTR onInt(){
+  BQ25896_TRACEPOINT(BQ25896_TP_INT_ISR, 0);
+  int_pending = true;
+}
+
+void setup(){
+  Serial.begin(115200);
+  bq25896.begin();
+  if(!bq25896.isConnected()){
+      Serial.println("BQ25896 not found! Check connection and power");
+      while(1);
+  }
+  if(!BQ25896_ENABLE_TRACEPOINTS){
+      Serial.println("Tracepoints are off, build with -DBQ25896_ENABLE_TRACEPOINTS=1");
+  }
+  bq25896.setWATCHDOG(0); //disable watchdog
+  bq25896_lowpower_config_t config = { INT_PIN, true, 0, BQ25896_SLEEP_LIGHT };
+  lowpower.begin(config);
+  attachInterrupt(INT_PIN, onInt, FALLING);
+}
+
+void loop(){
+  if(int_pending){
+      int_pending = false;
+      lowpower.service();
+  }
+  static uint32_t last = 0;
+  if(millis() - last >= 1000){
+      last = millis();
+      bq25896.setICHG(1024); //one setter and a register read per second
+      bq25896.getBATV();
+  }
+
+  // Pair begin and end events, print the spans in cycles
+  static uint32_t bus_start = 0, bus_arg = 0, setter_start = 0, isr_start = 0;
+  bq25896_tp_event_t e;
+  while(ringPop(e)){
+      switch(e.id){
+          case BQ25896_TP_BUS_BEGIN:
+          bus_start = e.stamp;
+          bus_arg = e.arg;
+          break;
+          case BQ25896_TP_BUS_END:
+          Serial.println(String(((bus_arg >> 8) & 0xFF) == BQ25896_TRACE_WRITE ? "write" : "read") + " REG" +
+                         String(bus_arg & 0xFF, HEX) + " " + String(e.stamp - bus_start) + " cycles");
+          // A setter ends with its write
+          if(setter_start && ((bus_arg >> 8) & 0xFF) == BQ25896_TRACE_WRITE){
+              Serial.println("setter " + String(e.stamp - setter_start) + " cycles");
+              setter_start = 0;
+          }
+          break;
+          case BQ25896_TP_SETTER:
+          setter_start = e.stamp;
+          break;
+          case BQ25896_TP_INT_ISR:
+          isr_start = e.stamp;
+          break;
+          case BQ25896_TP_INT_HANDLER:
+          Serial.println("INT latency " + String(e.stamp - isr_start) + " cycles");
+          break;
+      }
+  }
+}
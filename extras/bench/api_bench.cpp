@@ -0,0 +1,247 @@
+/*
+
+    Microbenchmarks for every public PMIC_BQ25896 call on the host
+
+    Runs each call against the simulated charger (extras/host/bq25896_sim.h)
+    and reports ns/op, I2C transactions/op and bytes/op. A transaction is
+    one endTransmission() or requestFrom(), so a single register read
+    costs two (register pointer write, data read) and a read-modify-write
+    setter costs three.
+
+    Build and run from the library root:
+        g++ -O2 -I. -Iextras/host extras/bench/api_bench.cpp PMIC_BQ25896.cpp PMIC_BQ25896_serialize.cpp extras/host/host_arduino.cpp -o api_bench
+        ./api_bench [--json] [--filter TEXT] [--baseline FILE] [--write-baseline FILE]
+
+    setHVDCP_EN() and setMAXC_EN() only exist in bq25890/bq25895 builds,
+    add -DBQ25896_VARIANT=BQ25896_VARIANT_BQ25890 to measure them. The
+    checked in baseline is written by such a build, the other calls cost
+    the same in every variant.
+
+    --json prints one JSON object per call for tracking over time.
+    --baseline compares transactions/op and bytes/op against a file written
+    by --write-baseline and exits with 1 if any call got more expensive
+    on the bus. extras/bench/api_bench_baseline.csv is the checked in one.
+
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "PMIC_BQ25896.h"
+#include "PMIC_BQ25896_serialize.h"
+#include "PMIC_BQ25896_stats.h"
+#include "PMIC_BQ25896_power.h"
+#include "PMIC_BQ25896_cycle.h"
+#include "PMIC_BQ25896_filter.h"
+#include "bq25896_sim.h"
+
+// Keeps results alive without adding work to the measured call
+template <typename T>
+static inline void keep(const T &v){
+    asm volatile("" : : "g"(&v) : "memory");
+}
+
+struct Bench {
+    PMIC_BQ25896 &pmic;
+    TwoWire &bus;
+    BQ25896Sim &sim;
+};
+
+typedef void (*bench_fn)(Bench &b, uint32_t i);
+
+struct Case {
+    const char *name;
+    bench_fn fn;
+};
+
+#define GET(call) { #call, [](Bench &b, uint32_t i){ (void)i; keep(b.pmic.call()); } }
+#define SET_BOOL(call) { #call, [](Bench &b, uint32_t i){ b.pmic.call(i & 1); } }
+#define SET_BOOL_ERR(call) { #call, [](Bench &b, uint32_t i){ keep(b.pmic.call(i & 1)); } }
+#define SET_INT(call, lo, hi) { #call, [](Bench &b, uint32_t i){ keep(b.pmic.call(lo + (int)(i % ((hi) - (lo) + 1)))); } }
+
+static const Case cases[] = {
+    { "isConnected", [](Bench &b, uint32_t i){ (void)i; keep(b.pmic.isConnected()); } },
+    { "reset", [](Bench &b, uint32_t i){ (void)i; b.pmic.reset(); } },
+    GET(checkVARIANT), GET(getVARIANT),
+    GET(getSNAPSHOT),
+    { "readSNAPSHOT(ADC)", [](Bench &b, uint32_t i){ (void)i; bq25896_regs_t r; keep(b.pmic.readSNAPSHOT(r, BATV, BQ25896_ADC_SAMPLE_LEN)); keep(r); } },
+    { "applyPROFILE", [](Bench &b, uint32_t i){ bq25896_profile_t p = { 500, 3500, (uint16_t)(i & 1 ? 2048 : 1024), 128, 256, 4208 }; keep(b.pmic.applyPROFILE(p)); } },
+    GET(getPROFILE),
+    { "getBATV(cached)", [](Bench &b, uint32_t i){ (void)i; static PMIC_BQ25896 cached; static bool init = false; if(!init){ cached.begin(&b.bus); cached.setCACHE(true); cached.setCACHE_AGE(BQ25896_CACHE_ADC, BQ25896_CACHE_FOREVER); init = true; } keep(cached.getBATV()); } },
+    { "serialize(JSON)", [](Bench &b, uint32_t i){ (void)b; (void)i; static bq25896_regs_t r; static char out[1536]; keep(bq25896_serialize(r, out, sizeof(out), BQ25896_FORMAT_JSON)); } },
+    { "getFIELD", [](Bench &b, uint32_t i){ (void)i; keep(b.pmic.getFIELD(BQ25896_F_CHRG_STAT)); } },
+    { "setFIELD", [](Bench &b, uint32_t i){ keep(b.pmic.setFIELD(BQ25896_F_ICHG, (uint8_t)(i & 0x3F))); } },
+    { "serialize(TEXT)", [](Bench &b, uint32_t i){ (void)b; (void)i; static bq25896_regs_t r; static char out[2048]; keep(bq25896_serialize(r, out, sizeof(out), BQ25896_FORMAT_TEXT)); } },
+    { "serialize(CBOR)", [](Bench &b, uint32_t i){ (void)b; (void)i; static bq25896_regs_t r; static uint8_t out[1024]; keep(bq25896_serialize(r, out, sizeof(out), BQ25896_FORMAT_CBOR)); } },
+    { "stats_feed", [](Bench &b, uint32_t i){ (void)b; static bq25896_stats_t st; static bool init = false; if(!init){ bq25896_stats_init(st, 64, 4); init = true; } bq25896_regs_t r; memset(&r, 0, sizeof(r)); r.raw[BATV] = i & 0x7F; bq25896_stats_feed(st, r); keep(st); } },
+    { "filter_feed", [](Bench &b, uint32_t i){ (void)b; static bq25896_filter_t fl; static bool init = false; if(!init){ bq25896_filter_init(fl); init = true; } bq25896_regs_t r; memset(&r, 0, sizeof(r)); r.raw[BATV] = i & 0x7F; bq25896_filter_feed(fl, r); keep(fl); } },
+    { "power_update", [](Bench &b, uint32_t i){ (void)b; static bq25896_power_t pw; static bool init = false; if(!init){ bq25896_power_init(pw); init = true; } bq25896_regs_t r; memset(&r, 0, sizeof(r)); r.raw[BATV] = i & 0x7F; r.raw[VBUSV] = 0x98; keep(bq25896_power_update(pw, r, i * 10)); } },
+    { "cycle_update", [](Bench &b, uint32_t i){ (void)b; static bq25896_cycle_t cy; static bool init = false; if(!init){ bq25896_cycle_init(cy); init = true; } bq25896_regs_t r; memset(&r, 0, sizeof(r)); r.raw[VBUS_STAT] = (uint8_t)(((i >> 6) & 3) << 3); r.raw[BATV] = i & 0x7F; keep(bq25896_cycle_update(cy, r, i * 10)); } },
+
+    GET(getILIM_reg), SET_BOOL(setEN_HIZ), SET_BOOL(setEN_ILIM), SET_INT(setIINLIM, 100, 3250), GET(getIINLIM),
+    GET(getVINDPM_OS_reg), SET_INT(setBHOT, 0, 3), SET_BOOL(setBCOLD), SET_INT(setVINDPM_OS, 0, 3100), GET(getVINDPM_OS),
+    GET(getADC_CTRL_reg), SET_BOOL(setCONV_START), SET_BOOL(setCONV_RATE), SET_BOOL(setBOOST_FREQ), SET_BOOL(setICO_EN),
+    SET_BOOL(setFORCE_DPDM), SET_BOOL(setAUTO_DPDM_EN),
+#if BQ25896_VARIANT_HAS_HVDCP
+    SET_BOOL_ERR(setHVDCP_EN), SET_BOOL_ERR(setMAXC_EN),
+#endif
+    GET(getSYS_CTRL_reg), SET_BOOL(setBAT_LOADEN), SET_BOOL(setWD_RST), SET_BOOL(setOTG_CONFIG), SET_BOOL(setCHG_CONFIG),
+    SET_INT(setSYS_MIN, 3000, 3700), GET(getSYS_MIN), SET_BOOL(setMIN_VBAT_SEL),
+    GET(getICHG_reg), SET_BOOL(setEN_PUMPX), SET_INT(setICHG, 0, 3008), GET(getICHG),
+    GET(getIPRE_ITERM_reg), SET_INT(setIPRECHG, 64, 1024), GET(getIPRECHG), SET_INT(setITERM, 64, 1024), GET(getITERM),
+    GET(getVREG_reg), SET_INT(setVREG, 3840, 4608),
+    { "setVREG(mV)", [](Bench &b, uint32_t i){ keep(b.pmic.setVREG(bq25896::Millivolts(3840 + (i % 49) * 16))); } },
+    { "setVREG(const)", [](Bench &b, uint32_t i){ (void)i; b.pmic.setVREG(BQ25896_CONST(Vreg, 4208)); } },
+    GET(getVREG), SET_BOOL(setBATLOWV), SET_BOOL(setVRECHG),
+    GET(getTIMER_reg), SET_BOOL(setEN_TERM), SET_BOOL(setSTAT_DIS), SET_INT(setWATCHDOG, 0, 3), SET_BOOL(setEN_TIMER),
+    SET_INT(setCHG_TIMER, 0, 3), SET_BOOL(setJEITA_ISET),
+    GET(getBAT_COMP_reg), SET_INT(setBAT_COMP, 0, 140), GET(getBAT_COMP), SET_INT(setVCLAMP, 0, 224), GET(getVCLAMP),
+    SET_INT(setTREG, 0, 3),
+    GET(getCTRL1_reg), SET_BOOL(setFORCE_ICO), SET_BOOL(setTMR2X_EN), SET_BOOL(setBATFET_DIS), SET_BOOL(setJEITA_VSET),
+    SET_BOOL(setBATFET_DLY), SET_BOOL(setBATFET_RST_EN), SET_BOOL(setPUMPX_UP), SET_BOOL(setPUMPX_DN),
+    GET(getBOOST_CTRL_reg), SET_INT(setBOOSTV, 4550, 5510), GET(getBOOSTV), SET_BOOL(setPFM_OTG_DIS),
+    SET_INT(setBOOST_LIM, 0, 6), GET(getBOOST_LIM),
+    GET(get_VBUS_STAT_reg),
+    GET(getFAULT_reg), GET(serviceFAULT), { "clearFAULT_record", [](Bench &b, uint32_t i){ (void)i; b.pmic.clearFAULT_record(); } },
+    GET(getVINDPM_reg), SET_BOOL(setFORCE_VINDPM), SET_INT(setVINDPM, 3900, 15300), GET(getVINDPM),
+    GET(getBATV_reg), GET(getBATV), GET(getSYSV_reg), GET(getSYSV), GET(getTSPCT_reg), GET(getTSPCT), GET(getBatteryTemperature), GET(getJEITA_ZONE),
+    GET(getVBUSV_reg), GET(getVBUSV), GET(getICHGR_reg), GET(getICHGR), GET(getIDPM_LIM_reg), GET(getIDPM_LIM),
+    GET(getCTRL2_reg), SET_BOOL(setREG_RST),
+};
+
+struct Result {
+    double ns_per_op;
+    double transactions_per_op;
+    double bytes_per_op;
+};
+
+static Result measure(const Case &c, Bench &b){
+    // Bus cost is deterministic, take it from a short counted run
+    const uint32_t counted = 64;
+    b.bus.resetStats();
+    for(uint32_t i = 0; i < counted; i++) c.fn(b, i);
+    const host_wire_stats_t &s = b.bus.stats();
+    Result r;
+    r.transactions_per_op = (double)(s.write_transactions + s.read_transactions) / counted;
+    r.bytes_per_op = (double)(s.bytes_written + s.bytes_read) / counted;
+
+    // Time: grow the batch until it runs long enough, keep the best of a few
+    uint32_t iters = 1024;
+    double best = 1e30;
+    for(int rep = 0; rep < 5; rep++){
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for(uint32_t i = 0; i < iters; i++) c.fn(b, i);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        if(ns < 2e6 && rep == 0){
+            iters *= 8;
+            rep = -1;
+            continue;
+        }
+        if(ns / iters < best) best = ns / iters;
+    }
+    r.ns_per_op = best;
+    return r;
+}
+
+typedef std::map<std::string, std::pair<double, double> > Baseline;
+
+static bool read_baseline(const char *path, Baseline &base){
+    FILE *f = fopen(path, "r");
+    if(!f) return false;
+    char name[128];
+    double t, bytes;
+    // Skip the header line
+    fscanf(f, "%*[^\n]\n");
+    while(fscanf(f, "%127[^,],%lf,%lf\n", name, &t, &bytes) == 3){
+        base[name] = std::make_pair(t, bytes);
+    }
+    fclose(f);
+    return true;
+}
+
+// Baseline values are stored rounded up to 4 decimals, so an amortized
+// cost like 2/64 never reads back below what was measured. Clamped at 0,
+// ceil() of a small negative value would print as -0.0000
+static double baseline_round(double v){
+    double r = ceil(v * 10000 - 1e-6) / 10000;
+    return r > 0 ? r : 0;
+}
+
+int main(int argc, char **argv){
+    bool json = false;
+    const char *filter = NULL;
+    const char *baseline_path = NULL;
+    const char *write_path = NULL;
+    for(int i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "--json")) json = true;
+        else if(!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if(!strcmp(argv[i], "--baseline") && i + 1 < argc) baseline_path = argv[++i];
+        else if(!strcmp(argv[i], "--write-baseline") && i + 1 < argc) write_path = argv[++i];
+        else{
+            fprintf(stderr, "usage: %s [--json] [--filter TEXT] [--baseline FILE] [--write-baseline FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Baseline base;
+    if(baseline_path && !read_baseline(baseline_path, base)){
+        fprintf(stderr, "%s: cannot read baseline\n", baseline_path);
+        return 2;
+    }
+    FILE *out_base = NULL;
+    if(write_path){
+        out_base = fopen(write_path, "w");
+        if(!out_base){
+            fprintf(stderr, "%s: cannot write baseline\n", write_path);
+            return 2;
+        }
+        fprintf(out_base, "name,transactions_per_op,bytes_per_op\n");
+    }
+
+    BQ25896Sim sim;
+    TwoWire bus(&sim);
+    PMIC_BQ25896 pmic;
+    pmic.begin(&bus);
+    host_clock_use_virtual(true);
+    Bench b = { pmic, bus, sim };
+
+    if(!json) printf("%-22s %10s %10s %10s\n", "call", "ns/op", "xfers/op", "bytes/op");
+
+    int regressions = 0;
+    for(size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++){
+        if(filter && !strstr(cases[c].name, filter)) continue;
+        sim.reset();
+        Result r = measure(cases[c], b);
+
+        const char *flag = "";
+        Baseline::const_iterator it = base.find(cases[c].name);
+        if(it != base.end() && (r.transactions_per_op > it->second.first + 1e-9 || r.bytes_per_op > it->second.second + 1e-9)){
+            flag = "REGRESSION";
+            regressions++;
+        }
+
+        if(json){
+            printf("{\"name\":\"%s\",\"ns_per_op\":%.1f,\"transactions_per_op\":%.2f,\"bytes_per_op\":%.2f%s}\n",
+                   cases[c].name, r.ns_per_op, r.transactions_per_op, r.bytes_per_op, *flag ? ",\"regression\":true" : "");
+        }else{
+            printf("%-22s %10.1f %10.2f %10.2f %s\n", cases[c].name, r.ns_per_op, r.transactions_per_op, r.bytes_per_op, flag);
+        }
+        if(out_base) fprintf(out_base, "%s,%.4f,%.4f\n", cases[c].name, baseline_round(r.transactions_per_op),
+                             baseline_round(r.bytes_per_op));
+    }
+
+    if(out_base) fclose(out_base);
+    if(regressions){
+        fprintf(stderr, "%d call(s) use more bus transactions or bytes than the baseline\n", regressions);
+        return 1;
+    }
+    return 0;
+}
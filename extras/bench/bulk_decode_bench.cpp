@@ -0,0 +1,137 @@
+/*
+
+    Host benchmark for the BQ25896 bulk ADC decoder
+
+    Decodes N random REG0E - REG13 samples once through the per-sample
+    decoders used by the device getters and once through
+    bq25896_decode_bulk(), both without and with a board calibration,
+    checks that they agree and reports samples/s.
+
+    Build and run on Linux from the library root:
+        g++ -O3 -march=native -I. extras/bench/bulk_decode_bench.cpp -o bulk_decode_bench
+        ./bulk_decode_bench [samples]
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#include "PMIC_BQ25896_decode.h"
+
+// Reference path: one sample at a time through the register views, the
+// way getBATV() & co decode. Kept scalar so it shows the per-sample cost.
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((noinline, optimize("no-tree-vectorize")))
+#else
+__attribute__((noinline))
+#endif
+static void decode_scalar_cal(const bq25896_adc_sample_t *samples, size_t n, const bq25896_adc_soa_t &out,
+                              const bq25896_cal_t &cal){
+    for(size_t i = 0; i < n; i++){
+        const bq25896_adc_sample_t &s = samples[i];
+        out.batv_mv[i] = bq25896_decode_batv(s.batv.batv, cal);
+        out.sysv_mv[i] = bq25896_decode_sysv(s.sysv.sysv, cal);
+        out.tspct_pct[i] = bq25896_decode_tspct(s.tspct.tspct);
+        out.vbusv_mv[i] = bq25896_decode_vbusv(s.vbusv.vbusv, cal);
+        out.ichgr_ma[i] = bq25896_decode_ichgr(s.ichgr.ichgr, cal);
+        out.idpm_lim_ma[i] = bq25896_decode_idpm_lim(s.idpm_lim.idpm_lim);
+        out.flags[i] = (s.batv.therm_stat ? BQ25896_ADC_FLAG_THERM_STAT : 0) |
+                       (s.vbusv.vbus_gd ? BQ25896_ADC_FLAG_VBUS_GD : 0) |
+                       (s.idpm_lim.idpm_stat ? BQ25896_ADC_FLAG_IDPM_STAT : 0) |
+                       (s.idpm_lim.vdpm_stat ? BQ25896_ADC_FLAG_VDPM_STAT : 0);
+    }
+}
+
+// Gain and offset errors of a typical board
+static const bq25896_cal_t board_cal = { { { 328, -12 }, { 328, -12 }, { -655, 40 }, { 983, -25 } } };
+
+static void decode_scalar(const bq25896_adc_sample_t *samples, size_t n, const bq25896_adc_soa_t &out){
+    decode_scalar_cal(samples, n, out, bq25896_cal_identity);
+}
+
+static void decode_scalar_board(const bq25896_adc_sample_t *samples, size_t n, const bq25896_adc_soa_t &out){
+    decode_scalar_cal(samples, n, out, board_cal);
+}
+
+__attribute__((noinline))
+static void decode_bulk(const bq25896_adc_sample_t *samples, size_t n, const bq25896_adc_soa_t &out){
+    bq25896_decode_bulk(samples[0].raw, sizeof(bq25896_adc_sample_t), n, out);
+}
+
+__attribute__((noinline))
+static void decode_bulk_board(const bq25896_adc_sample_t *samples, size_t n, const bq25896_adc_soa_t &out){
+    bq25896_decode_bulk(samples[0].raw, sizeof(bq25896_adc_sample_t), n, out, &board_cal);
+}
+
+struct Columns {
+    std::vector<uint16_t> batv, sysv, vbusv, ichgr, idpm_lim;
+    std::vector<uint8_t> tspct, flags;
+
+    explicit Columns(size_t n) : batv(n), sysv(n), vbusv(n), ichgr(n), idpm_lim(n), tspct(n), flags(n) {}
+
+    bq25896_adc_soa_t soa(){
+        bq25896_adc_soa_t out = { batv.data(), sysv.data(), tspct.data(), vbusv.data(), ichgr.data(), idpm_lim.data(), flags.data() };
+        return out;
+    }
+    bool operator==(const Columns &o) const {
+        return batv == o.batv && sysv == o.sysv && tspct == o.tspct && vbusv == o.vbusv &&
+               ichgr == o.ichgr && idpm_lim == o.idpm_lim && flags == o.flags;
+    }
+};
+
+typedef void (*decode_fn)(const bq25896_adc_sample_t *, size_t, const bq25896_adc_soa_t &);
+
+// Returns the best of a few runs in samples/s
+static double run(decode_fn fn, const std::vector<bq25896_adc_sample_t> &samples, Columns &cols){
+    bq25896_adc_soa_t out = cols.soa();
+    double best = 0;
+    for(int rep = 0; rep < 5; rep++){
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        fn(samples.data(), samples.size(), out);
+        std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+        double rate = samples.size() / dt.count();
+        if(rate > best) best = rate;
+    }
+    return best;
+}
+
+int main(int argc, char **argv){
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 0) : 10000000;
+    if(n == 0){
+        fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<bq25896_adc_sample_t> samples(n);
+    srand(1);
+    for(size_t i = 0; i < n; i++){
+        for(size_t b = 0; b < BQ25896_ADC_SAMPLE_LEN; b++){
+            samples[i].raw[b] = rand() & 0xFF;
+        }
+    }
+
+    Columns scalar(n), bulk(n);
+    double scalar_rate = run(decode_scalar, samples, scalar);
+    double bulk_rate = run(decode_bulk, samples, bulk);
+
+    if(!(scalar == bulk)){
+        fprintf(stderr, "bulk decode does not match the scalar decode\n");
+        return 1;
+    }
+    double scalar_cal_rate = run(decode_scalar_board, samples, scalar);
+    double bulk_cal_rate = run(decode_bulk_board, samples, bulk);
+    if(!(scalar == bulk)){
+        fprintf(stderr, "calibrated bulk decode does not match the scalar decode\n");
+        return 1;
+    }
+
+    printf("samples      : %zu\n", n);
+    printf("scalar       : %.1f Msamples/s\n", scalar_rate / 1e6);
+    printf("bulk         : %.1f Msamples/s\n", bulk_rate / 1e6);
+    printf("speedup      : %.2fx\n", bulk_rate / scalar_rate);
+    printf("scalar + cal : %.1f Msamples/s\n", scalar_cal_rate / 1e6);
+    printf("bulk + cal   : %.1f Msamples/s\n", bulk_cal_rate / 1e6);
+    return 0;
+}
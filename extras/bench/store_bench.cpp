@@ -0,0 +1,198 @@
+/*
+
+    Host benchmark for the BQ25896 flash history
+
+    Logs a simulated charge/discharge profile at a fixed sample period
+    into a file backed store (extras/host/bq25896_store_posix.h) that
+    behaves like SPI NOR, with a fault record now and then, and reports:
+      - encoded bytes per record against the 21 byte raw sample
+      - programs and erases, the most worn sector
+      - append latency percentiles
+      - remount time, and that the remounted store continues the history
+      - seek latency and that every record still in the ring reads back
+
+    Build and run on Linux from the library root:
+        g++ -O2 -I. -Iextras/host extras/bench/store_bench.cpp PMIC_BQ25896_store.cpp -o store_bench
+        ./store_bench [--days D] [--period-ms MS] [--size-kb KB] [--file PATH]
+
+    Exits with 1 if anything read back differs from what was appended.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#include "PMIC_BQ25896_store.h"
+#include "bq25896_store_posix.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double ns_since(bench_clock::time_point t0){
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - t0).count();
+}
+
+static bool same(const bq25896_store_entry_t &a, const bq25896_store_entry_t &b){
+    return a.type == b.type && a.time_ms == b.time_ms && memcmp(a.regs.raw, b.regs.raw, sizeof(a.regs.raw)) == 0;
+}
+
+// Slow charge and discharge cycles with ADC noise, the shape a real log has
+static void sample(uint64_t t_ms, bq25896_regs_t &regs){
+    double phase = (double)(t_ms % (6 * 3600000ULL)) / (6 * 3600000.0);
+    bool charging = phase < 0.5;
+    double soc = charging ? phase * 2 : 2 - phase * 2;
+    int noise = rand() % 3 - 1;
+    memset(&regs, 0, sizeof(regs));
+    regs.raw[VBUS_STAT] = charging ? 0x96 : 0x00;
+    regs.raw[BATV] = (uint8_t)(35 + soc * 33 + noise) & 0x7F;
+    regs.raw[SYSV] = (uint8_t)(42 + soc * 25) & 0x7F;
+    regs.raw[TSPCT] = (uint8_t)(0x4A + (rand() % 8 == 0 ? noise : 0));
+    regs.raw[VBUSV] = charging ? (0x80 | 0x1B) : 0x00;
+    regs.raw[ICHGR] = charging ? (uint8_t)(40 - soc * 30 + noise) & 0x7F : 0;
+    regs.raw[IDPM_LIM] = 0x3F;
+}
+
+int main(int argc, char **argv){
+    double days = 30;
+    uint32_t period_ms = 1000;
+    uint32_t size_kb = 256;
+    const char *path = "/tmp/bq25896_store_bench.bin";
+    for(int i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "--days") && i + 1 < argc) days = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--period-ms") && i + 1 < argc) period_ms = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--size-kb") && i + 1 < argc) size_kb = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--file") && i + 1 < argc) path = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--days D] [--period-ms MS] [--size-kb KB] [--file PATH]\n", argv[0]);
+            return 2;
+        }
+    }
+    remove(path);
+    srand(1);
+
+    BQ25896StoreFile file;
+    if(!file.open(path, size_kb * 1024)){
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    bq25896_store_backend_t backend = file.backend();
+    bq25896_store_t *store = new bq25896_store_t;
+    if(bq25896_store_mount(*store, backend) != BQ_OK){
+        fprintf(stderr, "mount failed\n");
+        return 1;
+    }
+
+    // Everything appended, trimmed to a bit more than the ring can hold
+    std::deque<bq25896_store_entry_t> appended;
+    std::vector<float> latency;
+    uint64_t samples = (uint64_t)(days * 86400000.0 / period_ms);
+    uint64_t t_ms = 1700000000000ULL;
+    latency.reserve(samples);
+    for(uint64_t i = 0; i < samples; i++, t_ms += period_ms){
+        bq25896_store_entry_t e;
+        memset(&e, 0, sizeof(e));
+        e.time_ms = t_ms;
+        bq25896_error_t err;
+        bench_clock::time_point t0 = bench_clock::now();
+        if(i % 5000 == 4999){
+            e.type = BQ25896_STORE_FAULT;
+            e.regs.raw[FAULT] = 0x10;
+            fault_reg_t fault;
+            memcpy(&fault, &e.regs.raw[FAULT], 1);
+            err = bq25896_store_append_fault(*store, t_ms, fault);
+        }else{
+            e.type = BQ25896_STORE_TELEMETRY;
+            sample(t_ms, e.regs);
+            err = bq25896_store_append(*store, t_ms, e.regs);
+        }
+        latency.push_back(ns_since(t0));
+        if(err != BQ_OK){
+            fprintf(stderr, "append %llu failed\n", (unsigned long long)i);
+            return 1;
+        }
+        appended.push_back(e);
+        if(appended.size() > (size_t)size_kb * 1024) appended.pop_front();
+    }
+    bq25896_store_flush(*store);
+
+    bq25896_store_stats_t st = store->stats;
+    std::sort(latency.begin(), latency.end());
+    uint32_t worn = 0;
+    for(uint32_t i = 0; i < file.sectors(); i++) worn = std::max(worn, file.erases(i));
+
+    printf("region           %u KiB, %u sectors of %u bytes, page %u\n", size_kb, store->sectors,
+           backend.sector_size, backend.page_size);
+    printf("records          %llu over %.1f days at %u ms\n", (unsigned long long)samples, days, period_ms);
+    printf("bytes/record     %.2f (raw sample %u)\n", (double)st.record_bytes / st.records, BQ25896_REG_COUNT);
+    printf("programs         %u, %.1f bytes each\n", st.programs, (double)st.program_bytes / st.programs);
+    printf("erases           %u, most worn sector %u\n", st.erases, worn);
+    printf("append ns        p50 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n", latency[latency.size() / 2],
+           latency[latency.size() * 99 / 100], latency[latency.size() * 999 / 1000], latency.back());
+
+    // A reboot: append one more record unflushed, remount and check it is
+    // the unflushed record that is lost and nothing else
+    int failures = 0;
+    bq25896_store_entry_t lost = appended.back();
+    lost.time_ms = t_ms;
+    bq25896_store_append(*store, t_ms, lost.regs);
+    bench_clock::time_point t0 = bench_clock::now();
+    if(bq25896_store_mount(*store, backend) != BQ_OK){
+        fprintf(stderr, "remount failed\n");
+        return 1;
+    }
+    printf("remount us       %.1f\n", ns_since(t0) / 1000);
+
+    // Read the whole ring back and check it is the tail of what was appended
+    bq25896_store_cursor_t c;
+    bq25896_store_entry_t e;
+    std::vector<bq25896_store_entry_t> stored;
+    t0 = bench_clock::now();
+    bq25896_store_seek(*store, c, 0);
+    while(bq25896_store_next(*store, c, e)) stored.push_back(e);
+    double scan_ns = ns_since(t0);
+    printf("full scan        %zu records, %.1f ms, %.1f ns/record\n", stored.size(), scan_ns / 1e6,
+           scan_ns / std::max<size_t>(stored.size(), 1));
+    if(stored.empty() || stored.size() > appended.size()){
+        failures++;
+    }else{
+        size_t first = appended.size() - stored.size();
+        for(size_t i = 0; i < stored.size(); i++){
+            if(!same(stored[i], appended[first + i])){
+                if(!failures) fprintf(stderr, "record %zu differs\n", i);
+                failures++;
+            }
+        }
+    }
+    printf("history          %.1f days retained\n",
+           stored.empty() ? 0.0 : (stored.back().time_ms - stored.front().time_ms) / 86400000.0);
+
+    // Continue after the remount, then seek to random retained times
+    sample(t_ms, e.regs);
+    e.type = BQ25896_STORE_TELEMETRY;
+    e.time_ms = t_ms + period_ms;
+    if(bq25896_store_append(*store, e.time_ms, e.regs) != BQ_OK) failures++;
+    stored.push_back(e);
+    const int seeks = 1000;
+    double seek_ns = 0;
+    for(int i = 0; i < seeks && !stored.empty(); i++){
+        const bq25896_store_entry_t &want = stored[(size_t)rand() % stored.size()];
+        t0 = bench_clock::now();
+        bq25896_store_seek(*store, c, want.time_ms);
+        bool found = bq25896_store_next(*store, c, e);
+        seek_ns += ns_since(t0);
+        if(!found || e.time_ms != want.time_ms){
+            if(!failures) fprintf(stderr, "seek to %llu failed\n", (unsigned long long)want.time_ms);
+            failures++;
+        }
+    }
+    printf("seek us          %.1f\n", seek_ns / seeks / 1000);
+
+    printf("%s\n", failures ? "FAIL" : "OK");
+    delete store;
+    remove(path);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,40 @@
+/*
+
+    Minimal Arduino core for building PMIC_BQ25896 on a Linux host
+
+    Provides just what the library uses: fixed width types, millis(),
+    micros(), delay() and a pinMode() that does nothing. Time comes from the monotonic clock, or from a
+    virtual clock that only moves when told to (host_clock_*), which
+    keeps simulations and trace replays deterministic.
+
+*/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+// No pins on the host
+static inline void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+// Switches millis()/micros() between the monotonic clock and the virtual clock
+void host_clock_use_virtual(bool enable);
+// Current virtual time in microseconds
+uint64_t host_clock_us();
+// Sets or advances the virtual clock. delay() advances it as well while it is in use.
+void host_clock_set_us(uint64_t us);
+void host_clock_advance_us(uint64_t us);
+
+#endif
@@ -0,0 +1,106 @@
+/*
+
+    Host TwoWire for building PMIC_BQ25896 on Linux
+
+    Same calls as the Arduino TwoWire the library uses. Transactions go
+    to a TwoWireBackend: a simulated device (bq25896_sim.h), a trace
+    replay (bq25896_replay.h) or anything else implementing it. Every
+    transaction is counted so tests and benchmarks can check bus cost.
+
+*/
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+#define HOST_WIRE_BUFFER_LENGTH 128
+
+class TwoWireBackend {
+public:
+    virtual ~TwoWireBackend() {}
+    // Write transaction to addr, returns the endTransmission() status
+    // (0 success, 2 address NACK, 3 data NACK, 4 other error)
+    virtual uint8_t i2cWrite(uint8_t addr, const uint8_t *data, size_t len, bool stop) = 0;
+    // Read transaction from addr, returns the number of bytes placed in data
+    virtual size_t i2cRead(uint8_t addr, uint8_t *data, size_t len) = 0;
+};
+
+typedef struct {
+    // Completed endTransmission() and requestFrom() calls
+    uint32_t write_transactions;
+    uint32_t read_transactions;
+    // Payload bytes moved, address bytes not counted
+    uint32_t bytes_written;
+    uint32_t bytes_read;
+} host_wire_stats_t;
+
+class TwoWire {
+    TwoWireBackend *_backend;
+    uint8_t _addr;
+    uint8_t _tx[HOST_WIRE_BUFFER_LENGTH];
+    size_t _tx_len;
+    uint8_t _rx[HOST_WIRE_BUFFER_LENGTH];
+    size_t _rx_len;
+    size_t _rx_pos;
+    host_wire_stats_t _stats;
+
+public:
+    TwoWire(TwoWireBackend *backend = NULL) : _backend(backend), _addr(0), _tx_len(0), _rx_len(0), _rx_pos(0) {
+        resetStats();
+    }
+
+    void setBackend(TwoWireBackend *backend) { _backend = backend; }
+    TwoWireBackend *backend() const { return _backend; }
+
+    const host_wire_stats_t &stats() const { return _stats; }
+    void resetStats() { memset(&_stats, 0, sizeof(_stats)); }
+
+    bool begin() { return true; }
+    bool begin(int sda, int scl, uint32_t frequency = 0) { (void)sda; (void)scl; (void)frequency; return true; }
+    bool setClock(uint32_t frequency) { (void)frequency; return true; }
+
+    void beginTransmission(uint8_t addr) {
+        _addr = addr;
+        _tx_len = 0;
+    }
+    void beginTransmission(int addr) { beginTransmission((uint8_t)addr); }
+
+    size_t write(uint8_t data) {
+        if(_tx_len >= sizeof(_tx)) return 0;
+        _tx[_tx_len++] = data;
+        return 1;
+    }
+    size_t write(const uint8_t *data, size_t len) {
+        size_t n = 0;
+        while(n < len && write(data[n])) n++;
+        return n;
+    }
+
+    uint8_t endTransmission(bool stop = true) {
+        _stats.write_transactions++;
+        _stats.bytes_written += _tx_len;
+        uint8_t status = _backend ? _backend->i2cWrite(_addr, _tx, _tx_len, stop) : 2;
+        _tx_len = 0;
+        return status;
+    }
+
+    uint8_t requestFrom(uint8_t addr, uint8_t len) {
+        if(len > sizeof(_rx)) len = sizeof(_rx);
+        _stats.read_transactions++;
+        _rx_len = _backend ? _backend->i2cRead(addr, _rx, len) : 0;
+        _rx_pos = 0;
+        _stats.bytes_read += _rx_len;
+        return _rx_len;
+    }
+    uint8_t requestFrom(int addr, int len) { return requestFrom((uint8_t)addr, (uint8_t)len); }
+
+    int available() { return _rx_len - _rx_pos; }
+    int read() { return _rx_pos < _rx_len ? _rx[_rx_pos++] : -1; }
+    int peek() { return _rx_pos < _rx_len ? _rx[_rx_pos] : -1; }
+};
+
+// Default bus, starts without a backend so every transaction NACKs
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,257 @@
+/*
+
+    Simulated BQ25896 charging a simulated battery, for host builds
+
+    BQ25896Sim plus an electro-thermal model of the charger and a Li-ion
+    cell. The battery has an OCV curve over state of charge, internal
+    resistance, capacity, a thermal mass with a thermal resistance to
+    ambient and an NTC on the TS pin. The charger follows its registers:
+    pre-charge below BATLOWV at IPRECHG, constant current at ICHG and
+    constant voltage at VREG (both after JEITA), termination at ITERM with
+    EN_TERM, recharge VRECHG below VREG, input current limited by IINLIM
+    and input voltage by VINDPM against an adapter with source resistance,
+    HIZ and CHG_CONFIG. BATV, SYSV, TSPCT, VBUSV and ICHGR follow the model
+    through the ADC, CHRG_STAT, PG_STAT, VSYS_STAT, VBUS_GD, VDPM_STAT,
+    IDPM_STAT, IDPM_LIM and the NTC fault bits directly.
+
+    The model advances with the virtual clock (host_clock_use_virtual),
+    in steps of at most setStep() (default 1s) before every bus
+    transaction, so a driver loop around delay() runs a full charge in
+    seconds of real time. step() advances it explicitly.
+
+    Not modelled: the ILIM pin, input source detection, ICO, the safety
+    timer, thermal regulation of the die and boost mode.
+
+*/
+
+#ifndef BQ25896_BATTERY_SIM_H
+#define BQ25896_BATTERY_SIM_H
+
+#include <math.h>
+
+#include "bq25896_sim.h"
+#include "PMIC_BQ25896_ntc.h"
+#include "PMIC_BQ25896_units.h"
+
+#define BQ25896_SIM_OCV_POINTS 11
+
+typedef struct {
+    uint16_t capacity_mah;
+    uint16_t r_int_mohm;
+    // Open circuit voltage at 0%, 10%, ... 100% state of charge
+    uint16_t ocv_mv[BQ25896_SIM_OCV_POINTS];
+    // Heat capacity in J/K and thermal resistance to ambient in K/W
+    uint16_t heat_capacity_j_k;
+    uint16_t thermal_res_k_w;
+    int16_t ambient_dc;
+    bq25896_ntc_config_t ntc;
+    // System load on VSYS
+    uint16_t sys_load_ma;
+    // Adapter open circuit voltage, 0 when unplugged, and source resistance
+    uint16_t adapter_mv;
+    uint16_t adapter_r_mohm;
+    // Buck converter efficiency in percent
+    uint8_t efficiency_pct;
+} bq25896_sim_battery_t;
+
+// 3000mAh 18650 class cell on a 5V 2A adapter, EVM NTC network
+static const bq25896_sim_battery_t bq25896_sim_battery_default = {
+    3000, 80,
+    { 3000, 3450, 3600, 3680, 3740, 3790, 3860, 3940, 4020, 4100, 4190 },
+    45, 20, 250,
+    { 10000, 3435, 5230, 30100 },
+    100,
+    5000, 200,
+    90
+};
+
+class BQ25896BatterySim : public BQ25896Sim {
+protected:
+    bq25896_sim_battery_t _bat;
+    // State of charge, 1 full at the top of the OCV curve, and cell temperature in degC
+    double _soc;
+    double _temp_c;
+    // Battery current in mA, positive charging
+    double _ibat_ma;
+    // Charge terminated, waiting for recharge
+    bool _done;
+    uint64_t _model_us;
+    uint32_t _step_us;
+
+    double _ocv(double soc) const {
+        double x = soc * (BQ25896_SIM_OCV_POINTS - 1);
+        if(x <= 0) return _bat.ocv_mv[0];
+        // Past full the last segment continues, so an overcharged cell keeps rising
+        int i = x < BQ25896_SIM_OCV_POINTS - 2 ? (int)x : BQ25896_SIM_OCV_POINTS - 2;
+        return _bat.ocv_mv[i] + (x - i) * (_bat.ocv_mv[i + 1] - _bat.ocv_mv[i]);
+    }
+
+    // TS pin in 0.001% of REGN at temp_c
+    uint32_t _tspct(double temp_c) const {
+        const bq25896_ntc_config_t &n = _bat.ntc;
+        double r = n.r25 * exp(n.beta * (1.0 / (temp_c + 273.15) - 1.0 / 298.15));
+        double rp = n.rt2 ? r * n.rt2 / (r + n.rt2) : r;
+        return (uint32_t)(rp / (n.rt1 + rp) * 100000.0 + 0.5);
+    }
+
+    // One model step of dt seconds
+    void _model(double dt){
+        bq25896_regs_t r;
+        memcpy(r.raw, _regs, sizeof(r.raw));
+
+        double ocv = _ocv(_soc);
+        double rint = _bat.r_int_mohm / 1000.0;
+        double rsrc = _bat.adapter_r_mohm / 1000.0;
+        double voc = _bat.adapter_mv;
+        double eff = _bat.efficiency_pct / 100.0;
+        uint16_t sys_min = bq25896::SysMin::decode(r.sys_ctrl.sys_min);
+        uint32_t ts = _tspct(_temp_c);
+        bq25896_jeita_zone_t zone = bq25896_jeita_zone(_code(ts, BQ25896_TSPCT_OFFSET_MPCT, BQ25896_TSPCT_LSB_MPCT, 0x7F));
+        bq25896_jeita_limits_t lim = bq25896_jeita_limits(zone, r.timer.jeita_iset, r.ctrl1.jeita_vset,
+                                                          bq25896::Ichg::decode(r.ichg.ichg), bq25896::Vreg::decode(r.vreg.vreg));
+
+        bool vbus_gd = voc >= 3900;
+        bool powered = vbus_gd && !r.ilim.en_hiz;
+        uint8_t chrg = 0;
+        bool vdpm = false, idpm = false;
+        double iin = 0, ibat = 0;
+        double ilim = bq25896::Iinlim::decode(r.ilim.iinlim);
+        double vsys;
+
+        if(powered){
+            // Input limit: IINLIM, and the current at which the adapter sags to VINDPM
+            double vindpm = r.vindpm.force_vindpm ? bq25896::Vindpm::decode(r.vindpm.vindpm)
+                                                  : voc - bq25896::VindpmOs::decode(r.vindpm_os.vindpm_os);
+            if(vindpm < 3900) vindpm = 3900;
+            double imax = ilim;
+            if(rsrc > 0 && (voc - vindpm) / rsrc < imax){
+                imax = (voc - vindpm) / rsrc;
+                if(imax < 0) imax = 0;
+            }
+
+            if(_done && ocv < lim.vreg_mv - (r.vreg.vrechg ? 200 : 100)) _done = false;
+            bool charging = r.sys_ctrl.chg_config && !_done && lim.ichg_ma > 0;
+            bool pre = ocv < (r.vreg.batlowv ? 3000 : 2800);
+            if(charging){
+                double icc = pre ? bq25896::Iprechg::decode(r.ipre_iterm.iprechg) : lim.ichg_ma;
+                double icv = (lim.vreg_mv - ocv) / rint;
+                ibat = icv < icc ? icv : icc;
+                if(ibat < 0) ibat = 0;
+                if(!pre && icv < icc && r.timer.en_term && ibat < bq25896::Iterm::decode(r.ipre_iterm.iterm)){
+                    _done = true;
+                    ibat = 0;
+                }
+            }
+            double vbat = ocv + ibat * rint;
+            vsys = (vbat > sys_min ? vbat : sys_min) + 50;
+            // Input power needed, then the input current drawing it from the sagging adapter
+            double p = (vsys * _bat.sys_load_ma + vbat * ibat) / eff;
+            double disc = voc * voc - 4 * rsrc * p;
+            iin = rsrc > 0 ? (disc > 0 ? (voc - sqrt(disc)) / (2 * rsrc) : imax + 1) : p / voc;
+            if(iin > imax){
+                // Regulating the input, the battery gets what is left
+                if(imax < ilim) vdpm = true;
+                else idpm = true;
+                iin = imax;
+                double pin = (voc - rsrc * iin) * iin * eff;
+                ibat = (pin - vsys * _bat.sys_load_ma) / vbat;
+            }
+            if(ibat > 0) chrg = _done ? 3 : (pre ? 1 : 2);
+            else if(_done) chrg = 3;
+        }else{
+            ibat = -(double)_bat.sys_load_ma;
+            vsys = ocv + ibat * rint;
+        }
+        _ibat_ma = ibat;
+
+        // Charge and heat
+        _soc += ibat * dt / 3600.0 / _bat.capacity_mah;
+        if(_soc < 0) _soc = 0;
+        double heat_w = (ibat / 1000.0) * (ibat / 1000.0) * rint;
+        _temp_c += (heat_w - (_temp_c - _bat.ambient_dc / 10.0) / _bat.thermal_res_k_w) / _bat.heat_capacity_j_k * dt;
+
+        // Analog state for the ADC
+        _analog.batv_mv = (uint16_t)(ocv + ibat * rint);
+        _analog.sysv_mv = (uint16_t)vsys;
+        _analog.tspct_mpct = ts;
+        _analog.vbusv_mv = (uint16_t)(vbus_gd ? voc - rsrc * iin : 0);
+        _analog.ichgr_ma = (uint16_t)(ibat > 0 ? ibat : 0);
+
+        // Status registers
+        r.vbus_stat.vbus_stat = vbus_gd ? 3 : 0;
+        r.vbus_stat.chrg_stat = chrg;
+        r.vbus_stat.pg_stat = vbus_gd;
+        r.vbus_stat.vsys_stat = _analog.batv_mv < sys_min;
+        r.vbusv.vbus_gd = vbus_gd;
+        r.idpm_lim.vdpm_stat = vdpm;
+        r.idpm_lim.idpm_stat = idpm;
+        r.idpm_lim.idpm_lim = _code(powered ? (uint32_t)(vdpm ? iin : ilim) : 0,
+                                    BQ25896_IDPM_LIM_OFFSET_MA, BQ25896_IDPM_LIM_LSB_MA, 0x3F);
+        _regs[VBUS_STAT] = r.raw[VBUS_STAT];
+        _regs[VBUSV] = r.raw[VBUSV];
+        _regs[IDPM_LIM] = r.raw[IDPM_LIM];
+
+        // TS faults in buck mode: 010 warm, 011 cool, 101 cold, 110 hot
+        static const uint8_t ntc_fault[] = { 0x05, 0x03, 0x00, 0x02, 0x06 };
+        uint8_t ntc = powered ? ntc_fault[zone] : 0;
+        _fault_now = (_fault_now & ~0x07) | ntc;
+        _fault_latched |= ntc;
+    }
+
+    // Runs the model up to the virtual clock
+    void _advance(){
+        uint64_t now = host_clock_us();
+        while(_model_us < now){
+            uint64_t dt = now - _model_us;
+            if(dt > _step_us) dt = _step_us;
+            _model(dt / 1e6);
+            _model_us += dt;
+        }
+    }
+
+public:
+    BQ25896BatterySim(const bq25896_sim_battery_t &bat = bq25896_sim_battery_default, uint8_t addr = BQ25896_ADDR)
+        : BQ25896Sim(addr), _bat(bat), _soc(0.2), _temp_c(bat.ambient_dc / 10.0), _ibat_ma(0),
+          _done(false), _model_us(host_clock_us()), _step_us(1000000) {
+        _model(0);
+    }
+
+    // Longest model step, shorter steps follow fast transients more closely
+    void setStep(uint32_t us) { _step_us = us ? us : 1; }
+
+    const bq25896_sim_battery_t &battery() const { return _bat; }
+    // Takes effect from the next step, e.g. plugging (adapter_mv) or ambient
+    void setBattery(const bq25896_sim_battery_t &bat) { _bat = bat; }
+
+    double soc() const { return _soc; }
+    // Open circuit voltage at the present SoC in mV
+    double ocv() const { return _ocv(_soc); }
+    void setSOC(double soc) { _soc = soc < 0 ? 0 : soc; _done = false; }
+    double temperature() const { return _temp_c; }
+    void setTemperature(double temp_c) { _temp_c = temp_c; }
+    // Battery current in mA, positive charging
+    double batteryCurrent() const { return _ibat_ma; }
+    bool terminated() const { return _done; }
+
+    // The model runs up to now before every transaction and settles to
+    // register writes right away
+    uint8_t i2cWrite(uint8_t addr, const uint8_t *data, size_t len, bool stop){
+        _advance();
+        uint8_t status = BQ25896Sim::i2cWrite(addr, data, len, stop);
+        _model(0);
+        return status;
+    }
+
+    size_t i2cRead(uint8_t addr, uint8_t *data, size_t len){
+        _advance();
+        return BQ25896Sim::i2cRead(addr, data, len);
+    }
+
+    // Advances the virtual clock and the model by us
+    void step(uint64_t us){
+        host_clock_advance_us(us);
+        _advance();
+    }
+};
+
+#endif
@@ -0,0 +1,238 @@
+/*
+
+    Deterministic replay of recorded BQ25896 I2C traces on the host
+
+    Serves a trace captured with PMIC_BQ25896::setTRACE_HOOK() back to
+    the driver through the host TwoWire. The virtual clock follows the
+    trace timestamps so millis()/micros() seen by the driver match the
+    capture.
+
+    STRICT replay expects the exact transaction sequence of the capture
+    and counts every divergence, which makes a recorded field failure a
+    regression test for the code that produced it. BY_REGISTER replay
+    serves each register its recorded values in order and accepts any
+    writes, so different polling code can run against the same data; the
+    clock moves to the timestamp of the newest record a read was served
+    from.
+
+*/
+
+#ifndef BQ25896_REPLAY_H
+#define BQ25896_REPLAY_H
+
+#include <stdio.h>
+#include <vector>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "PMIC_BQ25896_trace.h"
+
+// Writes a trace file on the host, pass BQ25896TraceFile::hook and the
+// writer to PMIC_BQ25896::setTRACE_HOOK()
+class BQ25896TraceFile {
+    FILE *_f;
+
+public:
+    BQ25896TraceFile() : _f(NULL) {}
+    ~BQ25896TraceFile() { close(); }
+
+    bool open(const char *path, uint8_t addr = BQ25896_ADDR){
+        close();
+        _f = fopen(path, "wb");
+        if(!_f) return false;
+        bq25896_trace_header_t header = { BQ25896_TRACE_MAGIC, BQ25896_TRACE_VERSION, addr, 0 };
+        return fwrite(&header, sizeof(header), 1, _f) == 1;
+    }
+    void close(){
+        if(_f) fclose(_f);
+        _f = NULL;
+    }
+
+    static void hook(const bq25896_trace_record_t &rec, void *ctx){
+        BQ25896TraceFile *self = (BQ25896TraceFile *)ctx;
+        uint8_t buf[BQ25896_TRACE_RECORD_HEADER_LEN + BQ25896_REG_COUNT];
+        size_t n = bq25896_trace_encode(&rec, buf);
+        if(self->_f) fwrite(buf, 1, n, self->_f);
+    }
+};
+
+class BQ25896ReplayBackend : public TwoWireBackend {
+public:
+    enum Mode {
+        STRICT,
+        BY_REGISTER
+    };
+
+private:
+    Mode _mode;
+    uint8_t _addr;
+    std::vector<bq25896_trace_record_t> _records;
+    size_t _pos;
+    // Register pointer set by the last one byte write
+    uint8_t _pointer;
+    // BY_REGISTER: recorded values with the index of their record, and the
+    // read cursor per register
+    struct Value {
+        uint8_t data;
+        uint32_t record;
+    };
+    std::vector<Value> _values[BQ25896_REG_COUNT];
+    size_t _cursor[BQ25896_REG_COUNT];
+    // BY_REGISTER: latest record whose timestamp the clock has reached, -1 for none
+    long _served;
+    // Unwrapped trace time
+    uint64_t _time_us;
+    uint32_t _last_stamp;
+    uint32_t _mismatches;
+    size_t _first_mismatch;
+    bool _exhausted;
+
+    void _mismatch(){
+        if(_mismatches++ == 0) _first_mismatch = _pos;
+    }
+
+    void _advanceClock(uint32_t stamp){
+        _time_us += (uint32_t)(stamp - _last_stamp);
+        _last_stamp = stamp;
+        host_clock_set_us(_time_us);
+    }
+
+    // STRICT: returns the next record if it matches, else counts a mismatch
+    const bq25896_trace_record_t *_next(uint8_t dir, uint8_t reg){
+        if(_pos >= _records.size()){
+            _exhausted = true;
+            _mismatch();
+            return NULL;
+        }
+        const bq25896_trace_record_t *rec = &_records[_pos];
+        if(rec->dir != dir || rec->reg != reg){
+            _mismatch();
+            return NULL;
+        }
+        return rec;
+    }
+
+public:
+    BQ25896ReplayBackend(Mode mode = STRICT) : _mode(mode), _addr(BQ25896_ADDR) { rewind(); }
+
+    // Loads a trace file (bq25896_trace_header_t followed by encoded records)
+    bool load(const char *path){
+        FILE *f = fopen(path, "rb");
+        if(!f) return false;
+        std::vector<uint8_t> buf;
+        uint8_t chunk[4096];
+        size_t n;
+        while((n = fread(chunk, 1, sizeof(chunk), f)) > 0) buf.insert(buf.end(), chunk, chunk + n);
+        fclose(f);
+        return load(buf.data(), buf.size());
+    }
+
+    // Loads a trace from memory
+    bool load(const uint8_t *buf, size_t len){
+        bq25896_trace_header_t header;
+        if(len < sizeof(header)) return false;
+        memcpy(&header, buf, sizeof(header));
+        if(header.magic != BQ25896_TRACE_MAGIC || header.version != BQ25896_TRACE_VERSION) return false;
+        _addr = header.addr;
+        _records.clear();
+        size_t off = sizeof(header);
+        bq25896_trace_record_t rec;
+        size_t used;
+        while((used = bq25896_trace_decode(buf + off, len - off, &rec)) > 0){
+            _records.push_back(rec);
+            off += used;
+        }
+        for(int r = 0; r < BQ25896_REG_COUNT; r++) _values[r].clear();
+        for(size_t i = 0; i < _records.size(); i++){
+            const bq25896_trace_record_t &t = _records[i];
+            if(t.dir != BQ25896_TRACE_READ) continue;
+            for(uint8_t b = 0; b < t.len && t.reg + b < BQ25896_REG_COUNT; b++){
+                Value v = { t.data[b], (uint32_t)i };
+                _values[t.reg + b].push_back(v);
+            }
+        }
+        rewind();
+        return off == len;
+    }
+
+    // Starts the replay over, including the virtual clock
+    void rewind(){
+        _pos = 0;
+        _pointer = 0;
+        memset(_cursor, 0, sizeof(_cursor));
+        _served = -1;
+        _time_us = 0;
+        _last_stamp = _records.empty() ? 0 : _records[0].timestamp_us;
+        _mismatches = 0;
+        _first_mismatch = 0;
+        _exhausted = false;
+        host_clock_use_virtual(true);
+        host_clock_set_us(0);
+    }
+
+    void setMode(Mode mode) { _mode = mode; rewind(); }
+    const std::vector<bq25896_trace_record_t> &records() const { return _records; }
+    // Records consumed so far (STRICT)
+    size_t position() const { return _pos; }
+    // Transactions that did not match the trace, and the record index of the first
+    uint32_t mismatches() const { return _mismatches; }
+    size_t firstMismatch() const { return _first_mismatch; }
+    // True once the code asked for more than the trace holds
+    bool exhausted() const { return _exhausted; }
+
+    uint8_t i2cWrite(uint8_t addr, const uint8_t *data, size_t len, bool stop){
+        (void)stop;
+        if(addr != _addr) return 2;
+        if(len == 0) return 0;
+        if(len == 1){
+            // Register pointer write of a read transaction, status comes from its record
+            _pointer = data[0];
+            if(_mode == BY_REGISTER) return 0;
+            const bq25896_trace_record_t *rec = _next(BQ25896_TRACE_READ, _pointer);
+            return rec ? rec->status & ~BQ25896_TRACE_SHORT_READ : 4;
+        }
+        if(_mode == BY_REGISTER) return 0;
+        const bq25896_trace_record_t *rec = _next(BQ25896_TRACE_WRITE, data[0]);
+        if(!rec) return 4;
+        if(rec->len != len - 1 || memcmp(rec->data, data + 1, rec->len) != 0) _mismatch();
+        _advanceClock(rec->timestamp_us);
+        _pos++;
+        return rec->status;
+    }
+
+    size_t i2cRead(uint8_t addr, uint8_t *data, size_t len){
+        if(addr != _addr) return 0;
+        if(_mode == BY_REGISTER){
+            size_t n = 0;
+            long latest = -1;
+            for(; n < len && _pointer + n < BQ25896_REG_COUNT; n++){
+                std::vector<Value> &v = _values[_pointer + n];
+                size_t &c = _cursor[_pointer + n];
+                if(c >= v.size()){
+                    _exhausted = true;
+                    data[n] = v.empty() ? 0 : v.back().data;
+                }else{
+                    data[n] = v[c].data;
+                    if((long)v[c].record > latest) latest = v[c].record;
+                    c++;
+                }
+            }
+            // The clock moves forward to the newest record served, never back
+            if(latest > _served){
+                _advanceClock(_records[latest].timestamp_us);
+                _served = latest;
+            }
+            return n;
+        }
+        const bq25896_trace_record_t *rec = _next(BQ25896_TRACE_READ, _pointer);
+        if(!rec) return 0;
+        if(!(rec->status & BQ25896_TRACE_SHORT_READ) && rec->len != len) _mismatch();
+        size_t n = rec->len < len ? rec->len : len;
+        memcpy(data, rec->data, n);
+        _advanceClock(rec->timestamp_us);
+        _pos++;
+        return n;
+    }
+};
+
+#endif
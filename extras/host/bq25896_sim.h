@@ -0,0 +1,170 @@
+/*
+
+    Simulated BQ25896 register file for host builds
+
+    A TwoWireBackend that answers like the charger: power-on defaults,
+    write masks and self-clearing control bits from the register map
+    (PMIC_BQ25896_regmap.h), read-only status and ADC registers,
+    REG_RST, latched faults that clear on read and one-shot or
+    continuous ADC conversions. ADC results come from the analog state
+    set with setAnalog(), faults are injected with setFault().
+
+*/
+
+#ifndef BQ25896_SIM_H
+#define BQ25896_SIM_H
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_regmap.h"
+
+// Bits outside the register map that read 1, REG0B bit 1 is reserved
+static const uint8_t bq25896_sim_reserved_ones[BQ25896_REG_COUNT] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// Analog state the ADC converts, in the units of the getters
+typedef struct {
+    uint16_t batv_mv;
+    uint16_t sysv_mv;
+    uint32_t tspct_mpct;    // 0.001% of REGN
+    uint16_t vbusv_mv;
+    uint16_t ichgr_ma;
+} bq25896_sim_analog_t;
+
+class BQ25896Sim : public TwoWireBackend {
+protected:
+    uint8_t _addr;
+    uint8_t _regs[BQ25896_REG_COUNT];
+    uint8_t _pointer;
+    // Fault conditions present now, and latched since the last REG0C read
+    uint8_t _fault_now;
+    uint8_t _fault_latched;
+    bq25896_sim_analog_t _analog;
+    // Virtual time of the last continuous conversion
+    uint64_t _last_conv_us;
+    // One-shot conversion time, 0 converts on the CONV_START write
+    uint32_t _conv_time_us;
+    // Virtual time a pending one-shot conversion completes
+    uint64_t _conv_due_us;
+
+    static uint8_t _code(uint32_t value, uint32_t offset, uint32_t lsb, uint8_t max){
+        if(value <= offset) return 0;
+        uint32_t code = (value - offset + lsb / 2) / lsb;
+        return code > max ? max : code;
+    }
+
+    // Latches the analog state into the ADC registers, status bits are kept
+    void _convert(){
+        _regs[BATV] = (_regs[BATV] & 0x80) | _code(_analog.batv_mv, BQ25896_BATV_OFFSET_MV, BQ25896_BATV_LSB_MV, 0x7F);
+        _regs[SYSV] = _code(_analog.sysv_mv, BQ25896_SYSV_OFFSET_MV, BQ25896_SYSV_LSB_MV, 0x7F);
+        _regs[TSPCT] = _code(_analog.tspct_mpct, BQ25896_TSPCT_OFFSET_MPCT, BQ25896_TSPCT_LSB_MPCT, 0x7F);
+        _regs[VBUSV] = (_regs[VBUSV] & 0x80) | _code(_analog.vbusv_mv, BQ25896_VBUSV_OFFSET_MV, BQ25896_VBUSV_LSB_MV, 0x7F);
+        _regs[ICHGR] = _code(_analog.ichgr_ma, 0, BQ25896_ICHGR_LSB_MA, 0x7F);
+        _regs[ADC_CTRL] &= ~0x80;
+    }
+
+    // Called after the host wrote reg, applies the side effects of control bits
+    virtual void _written(uint8_t reg){
+        switch(reg){
+            case ADC_CTRL:
+            if(_regs[ADC_CTRL] & 0x80){
+                if(_conv_time_us == 0) _convert();
+                else _conv_due_us = host_clock_us() + _conv_time_us;
+            }
+            break;
+            case CTRL2:
+            if(_regs[CTRL2] & 0x80) reset();
+            break;
+        }
+        // Self-clearing bits act at once, CONV_START clears when the conversion is done
+        _regs[reg] &= ~(bq25896_reg_sc_mask[reg] & ~(reg == ADC_CTRL ? 0x80 : 0x00));
+    }
+
+    // Called before the host reads reg
+    virtual void _reading(uint8_t reg){
+        if((_regs[ADC_CTRL] & 0x80) && _conv_time_us && host_clock_us() >= _conv_due_us){
+            _convert();
+        }
+        if(reg == FAULT){
+            _regs[FAULT] = _fault_latched | _fault_now;
+            _fault_latched = 0;
+        }
+        if(reg >= BATV && reg <= IDPM_LIM && (_regs[ADC_CTRL] & 0x40)){
+            // Continuous conversion every second
+            uint64_t now = host_clock_us();
+            if(now - _last_conv_us >= 1000000){
+                _last_conv_us = now;
+                _convert();
+            }
+        }
+    }
+
+public:
+    BQ25896Sim(uint8_t addr = BQ25896_ADDR) : _addr(addr) {
+        memset(&_analog, 0, sizeof(_analog));
+        _analog.batv_mv = 3700;
+        _analog.sysv_mv = 3750;
+        _analog.tspct_mpct = 50000;
+        _conv_time_us = 0;
+        reset();
+    }
+    virtual ~BQ25896Sim() {}
+
+    // Power-on reset, analog state is kept
+    void reset(){
+        for(uint8_t i = 0; i < BQ25896_REG_COUNT; i++){
+            _regs[i] = bq25896_reg_reset[i] | bq25896_sim_reserved_ones[i];
+        }
+        _pointer = 0;
+        _fault_now = 0;
+        _fault_latched = 0;
+        _last_conv_us = 0;
+        _conv_due_us = 0;
+    }
+
+    // Makes one-shot conversions take us of virtual time, CONV_START
+    // reads back high until then. 0 (default) converts immediately
+    void setConversionTime(uint32_t us) { _conv_time_us = us; }
+
+    // Direct register access for tests, bypasses masks and side effects
+    uint8_t peek(uint8_t reg) const { return _regs[reg]; }
+    void poke(uint8_t reg, uint8_t value) { _regs[reg] = value; }
+
+    void setAnalog(const bq25896_sim_analog_t &analog) { _analog = analog; }
+    const bq25896_sim_analog_t &analog() const { return _analog; }
+
+    // Sets the faults present now (REG0C layout), they latch until read
+    void setFault(uint8_t fault){
+        _fault_now = fault;
+        _fault_latched |= fault;
+    }
+
+    uint8_t i2cWrite(uint8_t addr, const uint8_t *data, size_t len, bool stop){
+        (void)stop;
+        if(addr != _addr) return 2;
+        if(len == 0) return 0;
+        _pointer = data[0];
+        for(size_t i = 1; i < len; i++, _pointer++){
+            if(_pointer >= BQ25896_REG_COUNT) return 3;
+            uint8_t mask = bq25896_reg_write_mask[_pointer];
+            _regs[_pointer] = (_regs[_pointer] & ~mask) | (data[i] & mask);
+            _written(_pointer);
+        }
+        return 0;
+    }
+
+    size_t i2cRead(uint8_t addr, uint8_t *data, size_t len){
+        if(addr != _addr) return 0;
+        size_t n = 0;
+        for(; n < len; n++, _pointer++){
+            if(_pointer >= BQ25896_REG_COUNT) _pointer = 0;
+            _reading(_pointer);
+            data[n] = _regs[_pointer];
+        }
+        return n;
+    }
+};
+
+#endif
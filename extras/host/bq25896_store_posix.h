@@ -0,0 +1,89 @@
+/*
+
+    File backend of the BQ25896 flash history on the host
+
+    Keeps the store region in a regular file and behaves like SPI NOR:
+    an erase sets a sector to 0xFF, a program can only clear bits (the
+    new bytes are ANDed into the old ones). Counts the erases of every
+    sector, so wear can be checked after a long simulated run, and can
+    be reopened to test remounting.
+
+*/
+
+#ifndef BQ25896_STORE_POSIX_H
+#define BQ25896_STORE_POSIX_H
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string.h>
+#include <vector>
+
+#include "PMIC_BQ25896_store.h"
+
+class BQ25896StoreFile {
+    int _fd;
+    uint32_t _size;
+    uint32_t _sector_size;
+    uint16_t _page_size;
+    std::vector<uint32_t> _erases;
+
+    static int read_cb(void *ctx, uint32_t addr, void *buf, uint32_t len){
+        BQ25896StoreFile *self = (BQ25896StoreFile *)ctx;
+        if(addr + len > self->_size) return -1;
+        return pread(self->_fd, buf, len, addr) == (ssize_t)len ? 0 : -1;
+    }
+    static int prog_cb(void *ctx, uint32_t addr, const void *buf, uint32_t len){
+        BQ25896StoreFile *self = (BQ25896StoreFile *)ctx;
+        if(addr + len > self->_size) return -1;
+        std::vector<uint8_t> cell(len);
+        if(pread(self->_fd, cell.data(), len, addr) != (ssize_t)len) return -1;
+        for(uint32_t i = 0; i < len; i++) cell[i] &= ((const uint8_t *)buf)[i];
+        return pwrite(self->_fd, cell.data(), len, addr) == (ssize_t)len ? 0 : -1;
+    }
+    static int erase_cb(void *ctx, uint32_t addr){
+        BQ25896StoreFile *self = (BQ25896StoreFile *)ctx;
+        if(addr % self->_sector_size || addr >= self->_size) return -1;
+        self->_erases[addr / self->_sector_size]++;
+        std::vector<uint8_t> blank(self->_sector_size, 0xFF);
+        return pwrite(self->_fd, blank.data(), blank.size(), addr) == (ssize_t)blank.size() ? 0 : -1;
+    }
+
+public:
+    BQ25896StoreFile() : _fd(-1), _size(0), _sector_size(0), _page_size(0) {}
+    ~BQ25896StoreFile() { close(); }
+
+    // Opens path as a region of size bytes, a new or differently sized
+    // file starts erased
+    bool open(const char *path, uint32_t size, uint32_t sector_size = 4096, uint16_t page_size = 256){
+        close();
+        _fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if(_fd < 0) return false;
+        _size = size;
+        _sector_size = sector_size;
+        _page_size = page_size;
+        _erases.assign(size / sector_size, 0);
+        struct stat st;
+        if(fstat(_fd, &st) != 0) return false;
+        if((uint64_t)st.st_size != size){
+            std::vector<uint8_t> blank(size, 0xFF);
+            if(ftruncate(_fd, 0) != 0 || pwrite(_fd, blank.data(), size, 0) != (ssize_t)size) return false;
+        }
+        return true;
+    }
+    void close(){
+        if(_fd >= 0) ::close(_fd);
+        _fd = -1;
+    }
+
+    bq25896_store_backend_t backend(){
+        bq25896_store_backend_t b = { _size, _sector_size, _page_size, read_cb, prog_cb, erase_cb, this };
+        return b;
+    }
+
+    // Erases of sector i since open
+    uint32_t erases(uint32_t i) const { return _erases[i]; }
+    uint32_t sectors() const { return _erases.size(); }
+};
+
+#endif
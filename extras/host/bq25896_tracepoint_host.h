@@ -0,0 +1,46 @@
+/*
+
+    Host sink for the BQ25896 tracepoints
+
+    Defines bq25896_tracepoint() for builds with
+    -DBQ25896_ENABLE_TRACEPOINTS=1: every event goes into
+    bq25896_tp_host_ring stamped with CLOCK_MONOTONIC nanoseconds (low 32
+    bits, so spans up to ~4s), and where <sys/sdt.h> is available it also
+    fires the USDT probe sdt_bq25896:tracepoint(id, arg) for perf:
+        perf buildid-cache --add ./prog
+        perf record -e sdt_bq25896:tracepoint ./prog
+
+    Include it in exactly one source file of the program.
+
+*/
+
+#ifndef BQ25896_TRACEPOINT_HOST_H
+#define BQ25896_TRACEPOINT_HOST_H
+
+#include <time.h>
+
+#include "PMIC_BQ25896_tracepoint.h"
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define BQ25896_TP_HOST_USDT 1
+#endif
+#endif
+
+bq25896_tp_ring_t bq25896_tp_host_ring;
+
+static inline uint32_t bq25896_tp_host_now_ns(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+void bq25896_tracepoint(bq25896_tp_t id, uint32_t arg){
+#ifdef BQ25896_TP_HOST_USDT
+    DTRACE_PROBE2(bq25896, tracepoint, (int)id, arg);
+#endif
+    bq25896_tp_ring_push(bq25896_tp_host_ring, id, arg, bq25896_tp_host_now_ns());
+}
+
+#endif
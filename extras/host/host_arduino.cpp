@@ -0,0 +1,63 @@
+/*
+
+    Host implementation of the Arduino clock and the default Wire bus
+
+*/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Arduino.h"
+#include "Wire.h"
+
+TwoWire Wire;
+
+static std::atomic<bool> use_virtual(false);
+static std::atomic<uint64_t> virtual_us(0);
+
+static uint64_t now_us(){
+    if(use_virtual) return virtual_us;
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis(){
+    return now_us() / 1000;
+}
+
+unsigned long micros(){
+    return now_us();
+}
+
+static void sleep_us(uint64_t us){
+    if(use_virtual){
+        virtual_us += us;
+    }else{
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+void delay(unsigned long ms){
+    sleep_us((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us){
+    sleep_us(us);
+}
+
+void host_clock_use_virtual(bool enable){
+    use_virtual = enable;
+}
+
+uint64_t host_clock_us(){
+    return virtual_us;
+}
+
+void host_clock_set_us(uint64_t us){
+    virtual_us = us;
+}
+
+void host_clock_advance_us(uint64_t us){
+    virtual_us += us;
+}
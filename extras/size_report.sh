@@ -0,0 +1,79 @@
+#!/bin/sh
+#
+# Reports the flash/RAM footprint of the driver per feature set
+#
+# Builds examples/minimal once per feature set with arduino-cli and prints
+# the program (flash) and global variable (RAM) sizes. With --host it
+# compiles PMIC_BQ25896.cpp alone with $CXX instead, which needs no board
+# package but reports object sizes before the linker drops unused code,
+# and sizeof(PMIC_BQ25896) as RAM.
+#
+# Usage (from the library root):
+#   extras/size_report.sh [--fqbn FQBN] [--budget BYTES] [--host]
+#
+# --budget fails (exit 1) if the smallest feature set's flash exceeds BYTES.
+
+set -u
+
+FQBN="esp32:esp32:esp32s3"
+BUDGET=""
+HOST=0
+CXX="${CXX:-g++}"
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --fqbn) FQBN="$2"; shift 2 ;;
+        --budget) BUDGET="$2"; shift 2 ;;
+        --host) HOST=1; shift ;;
+        *) echo "usage: $0 [--fqbn FQBN] [--budget BYTES] [--host]" >&2; exit 2 ;;
+    esac
+done
+
+LIB="$(cd "$(dirname "$0")/.." && pwd)"
+TMP="$(mktemp -d)"
+trap 'rm -rf "$TMP"' EXIT
+
+OFF_ALL="-DBQ25896_ENABLE_BOOST=0 -DBQ25896_ENABLE_PUMPX=0 -DBQ25896_ENABLE_ICO=0 -DBQ25896_ENABLE_ADC=0 -DBQ25896_ENABLE_CACHE=0 -DBQ25896_ENABLE_INSTRUMENTATION=0"
+
+# name|flags, the last set is the smallest one checked against --budget
+SETS="full|
+no-boost|-DBQ25896_ENABLE_BOOST=0
+no-pumpx|-DBQ25896_ENABLE_PUMPX=0
+no-ico|-DBQ25896_ENABLE_ICO=0
+no-adc|-DBQ25896_ENABLE_ADC=0
+no-cache|-DBQ25896_ENABLE_CACHE=0
+no-instrumentation|-DBQ25896_ENABLE_INSTRUMENTATION=0
+bq25890|-DBQ25896_VARIANT=BQ25896_VARIANT_BQ25890
+generic|-DBQ25896_VARIANT=BQ25896_VARIANT_GENERIC
+minimal|$OFF_ALL"
+
+printf "%-20s %10s %10s\n" "feature set" "flash" "ram"
+
+last_flash=0
+echo "$SETS" | while IFS='|' read -r name flags; do
+    if [ "$HOST" = 1 ]; then
+        "$CXX" -std=gnu++11 -Os -ffunction-sections -fdata-sections $flags \
+            -I"$LIB" -I"$LIB/extras/host" -c "$LIB/PMIC_BQ25896.cpp" -o "$TMP/$name.o" || exit 1
+        set -- $(size "$TMP/$name.o" | tail -n 1)
+        flash=$(($1 + $2))
+        printf '#include "PMIC_BQ25896.h"\n#include <stdio.h>\nint main(){ printf("%%zu", sizeof(PMIC_BQ25896)); }\n' > "$TMP/sizeof.cpp"
+        "$CXX" -std=gnu++11 $flags -I"$LIB" -I"$LIB/extras/host" "$TMP/sizeof.cpp" -o "$TMP/sizeof" || exit 1
+        ram=$("$TMP/sizeof")
+    else
+        out=$(arduino-cli compile --fqbn "$FQBN" --library "$LIB" \
+            --build-property "compiler.cpp.extra_flags=$flags" \
+            --build-path "$TMP/$name" "$LIB/examples/minimal" 2>&1) || { echo "$out" >&2; exit 1; }
+        flash=$(echo "$out" | sed -n 's/.*Sketch uses \([0-9]*\) bytes.*/\1/p')
+        ram=$(echo "$out" | sed -n 's/.*Global variables use \([0-9]*\) bytes.*/\1/p')
+    fi
+    printf "%-20s %10s %10s\n" "$name" "$flash" "$ram"
+    echo "$flash" > "$TMP/last_flash"
+done || exit 1
+
+if [ -n "$BUDGET" ]; then
+    last_flash=$(cat "$TMP/last_flash")
+    if [ "$last_flash" -gt "$BUDGET" ]; then
+        echo "minimal feature set uses $last_flash bytes of flash, budget is $BUDGET" >&2
+        exit 1
+    fi
+fi
@@ -0,0 +1,137 @@
+/*
+
+    Full charge cycle of a simulated battery through the driver on Linux
+
+    Build from the library root:
+        g++ -O2 -I. -Iextras/host extras/tools/bq25896_charge_sim.cpp PMIC_BQ25896.cpp extras/host/host_arduino.cpp -o bq25896_charge_sim
+
+    Usage:
+        bq25896_charge_sim [--soc PCT] [--ambient DEGC] [--ichg MA] [--iinlim MA]
+                           [--every S] [--hours H]
+
+    Configures the charger through PMIC_BQ25896 like an application would,
+    then polls it once per second of virtual time (start conversion,
+    delay(1000), snapshot) against BQ25896BatterySim until the charge
+    terminates. Prints a CSV row every --every seconds (default 60), the
+    phases seen by the cycle profiler and how much faster than real time it
+    ran. Checks BATV against the model on the way: OCV + ICHG * R_int in
+    constant current, VREG in constant voltage, within two ADC steps.
+    Exits with 1 if a check failed or the charge did not terminate within
+    --hours (default 6).
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "PMIC_BQ25896.h"
+#include "PMIC_BQ25896_cycle.h"
+#include "bq25896_battery_sim.h"
+
+static const char *phase_names[BQ25896_PHASE_COUNT] = { "not charging", "pre-charge", "fast charge", "done" };
+
+int main(int argc, char **argv){
+    long soc_pct = 20, ambient = 25, ichg = 1536, iinlim = 2000, every = 60, hours = 6;
+    for(int i = 1; i < argc; i++){
+        long *target = NULL;
+        if(strcmp(argv[i], "--soc") == 0) target = &soc_pct;
+        else if(strcmp(argv[i], "--ambient") == 0) target = &ambient;
+        else if(strcmp(argv[i], "--ichg") == 0) target = &ichg;
+        else if(strcmp(argv[i], "--iinlim") == 0) target = &iinlim;
+        else if(strcmp(argv[i], "--every") == 0) target = &every;
+        else if(strcmp(argv[i], "--hours") == 0) target = &hours;
+        if(!target || i + 1 >= argc){
+            fprintf(stderr, "usage: %s [--soc PCT] [--ambient DEGC] [--ichg MA] [--iinlim MA] [--every S] [--hours H]\n", argv[0]);
+            return 2;
+        }
+        *target = strtol(argv[++i], NULL, 0);
+    }
+
+    host_clock_use_virtual(true);
+    bq25896_sim_battery_t bat = bq25896_sim_battery_default;
+    bat.ambient_dc = ambient * 10;
+    BQ25896BatterySim sim(bat);
+    sim.setSOC(soc_pct / 100.0);
+    TwoWire bus(&sim);
+    PMIC_BQ25896 pmic;
+    pmic.begin(&bus);
+
+    pmic.setWATCHDOG(0);
+    pmic.setEN_ILIM(false);
+    if(pmic.setIINLIM((int)iinlim) != BQ_OK || pmic.setICHG((int)ichg) != BQ_OK){
+        fprintf(stderr, "ICHG or IINLIM out of range\n");
+        return 2;
+    }
+    pmic.setITERM(128);
+
+    bq25896_cycle_t cycle;
+    bq25896_cycle_init(cycle);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    uint32_t end_s = hours * 3600;
+    uint32_t s = 0;
+    bool done = false;
+    uint16_t vreg = pmic.getVREG();
+    uint32_t cc_checks = 0, cv_checks = 0, check_failures = 0;
+
+    printf("time_s,soc_pct,batv_mv,sysv_mv,vbusv_mv,ichgr_ma,temp_c,chrg_stat,vdpm,idpm\n");
+    for(; s <= end_s && !done; s++){
+        pmic.setCONV_START(true);
+        delay(1000);
+        bq25896_regs_t regs;
+        if(!pmic.readSNAPSHOT(regs)){
+            fprintf(stderr, "bus error at %us\n", s);
+            return 1;
+        }
+        bq25896_cycle_update(cycle, regs, millis());
+        done = regs.vbus_stat.chrg_stat == BQ25896_PHASE_DONE;
+
+        // BATV carries the IR drop of the charge current. Only checked in
+        // the normal JEITA zone without input limiting, where ICHG and VREG
+        // apply as set
+        if(regs.vbus_stat.chrg_stat == BQ25896_PHASE_FAST_CHARGE && !regs.fault.ntc_fault &&
+           !regs.idpm_lim.vdpm_stat && !regs.idpm_lim.idpm_stat){
+            double ibat = sim.batteryCurrent();
+            double expect = -1;
+            if(ibat >= ichg - 1){
+                expect = sim.ocv() + ichg * bat.r_int_mohm / 1000.0;
+                cc_checks++;
+            }else if(ibat > 0 && ibat < ichg * 0.9){
+                expect = vreg;
+                cv_checks++;
+            }
+            double batv = bq25896_decode_batv(regs.batv.batv);
+            if(expect >= 0 && (batv > expect + 2 * BQ25896_BATV_LSB_MV || batv < expect - 2 * BQ25896_BATV_LSB_MV)){
+                if(!check_failures) fprintf(stderr, "BATV %.0f mV at %us, expected %.0f mV (%s)\n", batv, s, expect,
+                                            ibat >= ichg - 1 ? "CC" : "CV");
+                check_failures++;
+            }
+        }
+        if(every > 0 && (s % every == 0 || done)){
+            printf("%u,%.1f,%u,%u,%u,%u,%.1f,%u,%u,%u\n", s, sim.soc() * 100.0,
+                   bq25896_decode_batv(regs.batv.batv), bq25896_decode_sysv(regs.sysv.sysv),
+                   bq25896_decode_vbusv(regs.vbusv.vbusv), bq25896_decode_ichgr(regs.ichgr.ichgr),
+                   sim.temperature(), regs.vbus_stat.chrg_stat, regs.idpm_lim.vdpm_stat, regs.idpm_lim.idpm_stat);
+        }
+    }
+    double real = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    // Close the phase in progress so it shows in the history
+    bq25896_regs_t last = pmic.getSNAPSHOT();
+    last.vbus_stat.chrg_stat = BQ25896_PHASE_NOT_CHARGING;
+    if(cycle.current.phase != BQ25896_PHASE_NOT_CHARGING) bq25896_cycle_update(cycle, last, millis());
+    for(uint8_t i = 0; i < cycle.history_len; i++){
+        const bq25896_phase_record_t &p = bq25896_cycle_record(cycle, i);
+        printf("# %-12s %6.1f min  VBAT %4u -> %4u mV  ICHGR avg %4u mA  VINDPM %u s  IINDPM %u s  faults %u\n",
+               phase_names[p.phase], p.duration_ms / 60000.0, p.vbat_entry_mv, p.vbat_exit_mv, p.ichgr_avg_ma,
+               p.vdpm_ms / 1000, p.idpm_ms / 1000, p.faults);
+    }
+    printf("# %s after %u s of virtual time in %.2f s, %.0fx real time\n", done ? "terminated" : "NOT terminated",
+           s, real, real > 0 ? s / real : 0.0);
+    printf("# BATV checks: %u CC, %u CV, %u failed\n", cc_checks, cv_checks, check_failures);
+    return done && !check_failures ? 0 : 1;
+}
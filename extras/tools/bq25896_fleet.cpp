@@ -0,0 +1,281 @@
+/*
+
+    Load test of many simulated BQ25896 chargers polled from a thread pool
+
+    Build from the library root:
+        g++ -O2 -pthread -I. -Iextras/host extras/tools/bq25896_fleet.cpp PMIC_BQ25896.cpp extras/host/host_arduino.cpp -o bq25896_fleet
+
+    Usage:
+        bq25896_fleet [--devices N] [--threads N] [--seconds S] [--period-ms MS]
+                      [--bus-khz KHZ] [--jitter PCT] [--spin] [--seed N]
+
+    Every device is a BQ25896Sim on its own TwoWire with its own analog
+    state, behind a bus that takes as long as the transaction would on the
+    wire: start, address and stop plus 9 bit times per byte at --bus-khz
+    (default 400), each device slower by up to --jitter percent (default
+    20). Bus time is slept, or burnt with --spin to model a polled I2C
+    peripheral. Devices are sharded over --threads workers (default one per
+    CPU), each driving its shard's PMIC_BQ25896 instances. A poll reads a
+    full snapshot and starts the next ADC conversion.
+
+    With --period-ms (default 1000) every device is polled once per period,
+    staggered over the period; 0 polls back to back for peak throughput.
+    Reports snapshots/s, poll latency and scheduling lateness percentiles,
+    deadline misses and process CPU time per device.
+
+    Runs on the monotonic clock: the virtual clock is global and is not
+    used here, so the simulators convert immediately.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "PMIC_BQ25896.h"
+#include "bq25896_sim.h"
+
+typedef std::chrono::steady_clock fleet_clock;
+
+// BQ25896Sim behind a bus that takes wire time per transaction
+class FleetDevice : public BQ25896Sim {
+    // Start, address byte and stop, and one data byte, in ns
+    uint32_t _frame_ns;
+    uint32_t _byte_ns;
+    bool _spin;
+
+    void _wait(size_t bytes){
+        std::chrono::nanoseconds t(_frame_ns + bytes * _byte_ns);
+        if(_spin){
+            fleet_clock::time_point end = fleet_clock::now() + t;
+            while(fleet_clock::now() < end) {}
+        }else{
+            std::this_thread::sleep_for(t);
+        }
+    }
+
+public:
+    FleetDevice() : _frame_ns(0), _byte_ns(0), _spin(false) {}
+
+    void setBus(uint32_t khz, uint32_t slowdown_pct, bool spin){
+        uint32_t bit_ns = 1000000 / khz * (100 + slowdown_pct) / 100;
+        _byte_ns = 9 * bit_ns;
+        _frame_ns = 2 * bit_ns + _byte_ns;
+        _spin = spin;
+    }
+
+    uint8_t i2cWrite(uint8_t addr, const uint8_t *data, size_t len, bool stop){
+        _wait(len);
+        return BQ25896Sim::i2cWrite(addr, data, len, stop);
+    }
+
+    size_t i2cRead(uint8_t addr, uint8_t *data, size_t len){
+        _wait(len);
+        return BQ25896Sim::i2cRead(addr, data, len);
+    }
+};
+
+struct Device {
+    FleetDevice sim;
+    TwoWire bus;
+    PMIC_BQ25896 pmic;
+    fleet_clock::time_point due;
+};
+
+struct Options {
+    uint32_t devices;
+    uint32_t threads;
+    uint32_t seconds;
+    uint32_t period_ms;
+    uint32_t bus_khz;
+    uint32_t jitter_pct;
+    bool spin;
+    uint32_t seed;
+};
+
+struct WorkerResult {
+    // Poll latency and lateness against the schedule, us
+    std::vector<uint32_t> latency_us;
+    std::vector<uint32_t> late_us;
+    uint32_t errors;
+    uint32_t missed;
+};
+
+static double cpu_seconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Small deterministic generator so runs are comparable
+static uint32_t next_rand(uint32_t &state){
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static void worker(std::vector<Device *> shard, const Options &opt, fleet_clock::time_point end,
+                   WorkerResult &res){
+    std::chrono::microseconds period(opt.period_ms * 1000);
+    size_t next = 0;
+    res.errors = 0;
+    res.missed = 0;
+    while(!shard.empty()){
+        // Shard devices share the period, so due times stay in ring order
+        Device &d = *shard[next];
+        next = (next + 1) % shard.size();
+        fleet_clock::time_point now = fleet_clock::now();
+        if(now >= end) break;
+        if(opt.period_ms){
+            if(d.due >= end) break;
+            if(d.due > now){
+                std::this_thread::sleep_until(d.due);
+                now = fleet_clock::now();
+            }
+        }
+
+        bq25896_regs_t regs;
+        if(!d.pmic.readSNAPSHOT(regs)) res.errors++;
+        d.pmic.setCONV_START(true);
+        fleet_clock::time_point done = fleet_clock::now();
+
+        res.latency_us.push_back(std::chrono::duration_cast<std::chrono::microseconds>(done - now).count());
+        if(opt.period_ms){
+            uint32_t late = std::chrono::duration_cast<std::chrono::microseconds>(now - d.due).count();
+            res.late_us.push_back(late);
+            if(late >= (uint32_t)opt.period_ms * 1000) res.missed++;
+            d.due += period;
+        }
+    }
+}
+
+static uint32_t percentile(const std::vector<uint32_t> &sorted, double p){
+    if(sorted.empty()) return 0;
+    size_t i = (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static void print_distribution(const char *name, std::vector<uint32_t> &v){
+    std::sort(v.begin(), v.end());
+    printf("%-10s p50 %7u us  p90 %7u us  p99 %7u us  p99.9 %7u us  max %7u us\n", name,
+           percentile(v, 50), percentile(v, 90), percentile(v, 99), percentile(v, 99.9),
+           v.empty() ? 0 : v.back());
+}
+
+static bool parse_uint(const char *s, uint32_t &out){
+    char *e;
+    unsigned long v = strtoul(s, &e, 0);
+    if(*s == '\0' || *e != '\0') return false;
+    out = v;
+    return true;
+}
+
+int main(int argc, char **argv){
+    Options opt;
+    opt.devices = 1000;
+    opt.threads = std::thread::hardware_concurrency();
+    if(opt.threads == 0) opt.threads = 4;
+    opt.seconds = 5;
+    opt.period_ms = 1000;
+    opt.bus_khz = 400;
+    opt.jitter_pct = 20;
+    opt.spin = false;
+    opt.seed = 1;
+
+    for(int i = 1; i < argc; i++){
+        const char *a = argv[i];
+        uint32_t *target = NULL;
+        if(strcmp(a, "--devices") == 0) target = &opt.devices;
+        else if(strcmp(a, "--threads") == 0) target = &opt.threads;
+        else if(strcmp(a, "--seconds") == 0) target = &opt.seconds;
+        else if(strcmp(a, "--period-ms") == 0) target = &opt.period_ms;
+        else if(strcmp(a, "--bus-khz") == 0) target = &opt.bus_khz;
+        else if(strcmp(a, "--jitter") == 0) target = &opt.jitter_pct;
+        else if(strcmp(a, "--seed") == 0) target = &opt.seed;
+        else if(strcmp(a, "--spin") == 0){ opt.spin = true; continue; }
+        if(!target || i + 1 >= argc || !parse_uint(argv[++i], *target)){
+            fprintf(stderr, "usage: %s [--devices N] [--threads N] [--seconds S] [--period-ms MS]\n"
+                            "          [--bus-khz KHZ] [--jitter PCT] [--spin] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(opt.devices == 0 || opt.threads == 0 || opt.seconds == 0 || opt.bus_khz == 0 || opt.seed == 0){
+        fprintf(stderr, "devices, threads, seconds, bus-khz and seed must be non-zero\n");
+        return 2;
+    }
+    if(opt.threads > opt.devices) opt.threads = opt.devices;
+
+    std::vector<Device *> devices(opt.devices);
+    uint32_t rng = opt.seed;
+    for(uint32_t i = 0; i < opt.devices; i++){
+        Device *d = new Device();
+        d->sim.setBus(opt.bus_khz, opt.jitter_pct ? next_rand(rng) % (opt.jitter_pct + 1) : 0, opt.spin);
+        bq25896_sim_analog_t analog = d->sim.analog();
+        analog.batv_mv = 3300 + next_rand(rng) % 900;
+        analog.sysv_mv = analog.batv_mv + 50;
+        analog.vbusv_mv = 4800 + next_rand(rng) % 400;
+        analog.ichgr_ma = next_rand(rng) % 2000;
+        analog.tspct_mpct = 40000 + next_rand(rng) % 30000;
+        d->sim.setAnalog(analog);
+        d->bus.setBackend(&d->sim);
+        d->pmic.begin(&d->bus);
+        devices[i] = d;
+    }
+
+    std::vector<std::vector<Device *> > shards(opt.threads);
+    for(uint32_t i = 0; i < opt.devices; i++) shards[i % opt.threads].push_back(devices[i]);
+
+    std::vector<WorkerResult> results(opt.threads);
+    fleet_clock::time_point start = fleet_clock::now();
+    fleet_clock::time_point end = start + std::chrono::seconds(opt.seconds);
+    for(uint32_t i = 0; i < opt.devices; i++){
+        devices[i]->due = start + std::chrono::microseconds((uint64_t)opt.period_ms * 1000 * i / opt.devices);
+    }
+
+    double cpu0 = cpu_seconds();
+    std::vector<std::thread> pool;
+    for(uint32_t t = 0; t < opt.threads; t++){
+        pool.push_back(std::thread(worker, shards[t], std::cref(opt), end, std::ref(results[t])));
+    }
+    for(size_t t = 0; t < pool.size(); t++) pool[t].join();
+    double wall = std::chrono::duration<double>(fleet_clock::now() - start).count();
+    double cpu = cpu_seconds() - cpu0;
+
+    std::vector<uint32_t> latency, late;
+    uint32_t errors = 0, missed = 0;
+    for(size_t t = 0; t < results.size(); t++){
+        latency.insert(latency.end(), results[t].latency_us.begin(), results[t].latency_us.end());
+        late.insert(late.end(), results[t].late_us.begin(), results[t].late_us.end());
+        errors += results[t].errors;
+        missed += results[t].missed;
+    }
+    uint64_t transactions = 0;
+    for(uint32_t i = 0; i < opt.devices; i++){
+        const host_wire_stats_t &s = devices[i]->bus.stats();
+        transactions += s.write_transactions + s.read_transactions;
+    }
+
+    printf("devices %u  threads %u  period %u ms  bus %u kHz%s  %.2f s\n", opt.devices, opt.threads,
+           opt.period_ms, opt.bus_khz, opt.spin ? " spin" : "", wall);
+    printf("snapshots %lu  %.0f /s  %.1f transactions each  errors %u\n", (unsigned long)latency.size(),
+           latency.size() / wall, latency.empty() ? 0.0 : (double)transactions / latency.size(), errors);
+    print_distribution("latency", latency);
+    if(opt.period_ms){
+        print_distribution("lateness", late);
+        printf("missed periods %u\n", missed);
+    }
+    printf("cpu %.2f s  %.1f us/s per device  %.3f%% of a core per device\n", cpu,
+           cpu / wall / opt.devices * 1e6, cpu / wall / opt.devices * 100.0);
+
+    for(uint32_t i = 0; i < opt.devices; i++) delete devices[i];
+    return errors ? 1 : 0;
+}
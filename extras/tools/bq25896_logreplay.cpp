@@ -0,0 +1,494 @@
+/*
+
+    Replay and aggregate BQ25896 binary telemetry logs on Linux
+
+    Memory maps a log written in the PMIC_BQ25896_log.h format, splits it
+    into chunks and decodes them on all cores with the library's register
+    views and bulk decoder. Produces per-device statistics, a fault
+    timeline and CSV and/or columnar output.
+
+    Build from the library root:
+        g++ -O3 -march=native -pthread -I. extras/tools/bq25896_logreplay.cpp -o bq25896_logreplay
+
+    Usage:
+        bq25896_logreplay [-j threads] [--faults FILE] [--csv FILE] [--columns DIR] LOG
+        bq25896_logreplay --generate LOG records devices
+
+    --columns writes one raw little endian file per column into DIR
+    (timestamp_us.u64, device_id.u32, batv_mv.u16, ...) plus schema.txt,
+    ready to be loaded with numpy.fromfile() or converted to Parquet.
+
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_log.h"
+
+// Records per work item
+static const size_t CHUNK_RECORDS = 1 << 18;
+
+struct Channel {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+
+    Channel() : min(UINT32_MAX), max(0), sum(0) {}
+    void add(uint32_t v){
+        if(v < min) min = v;
+        if(v > max) max = v;
+        sum += v;
+    }
+    void merge(const Channel &o){
+        if(o.min < min) min = o.min;
+        if(o.max > max) max = o.max;
+        sum += o.sum;
+    }
+};
+
+struct DeviceStats {
+    uint64_t samples;
+    uint64_t first_us;
+    uint64_t last_us;
+    Channel batv, sysv, vbusv, ichgr, tspct;
+    // Samples per REG0B CHRG_STAT value
+    uint64_t chrg_stat[4];
+    // Samples with any REG0C bit set
+    uint64_t faults;
+
+    DeviceStats() : samples(0), first_us(UINT64_MAX), last_us(0), faults(0) {
+        memset(chrg_stat, 0, sizeof(chrg_stat));
+    }
+    void merge(const DeviceStats &o){
+        samples += o.samples;
+        first_us = std::min(first_us, o.first_us);
+        last_us = std::max(last_us, o.last_us);
+        batv.merge(o.batv);
+        sysv.merge(o.sysv);
+        vbusv.merge(o.vbusv);
+        ichgr.merge(o.ichgr);
+        tspct.merge(o.tspct);
+        for(int i = 0; i < 4; i++) chrg_stat[i] += o.chrg_stat[i];
+        faults += o.faults;
+    }
+};
+
+struct FaultEvent {
+    uint64_t timestamp_us;
+    uint32_t device_id;
+    uint8_t fault;
+
+    bool operator<(const FaultEvent &o) const {
+        return device_id != o.device_id ? device_id < o.device_id : timestamp_us < o.timestamp_us;
+    }
+};
+
+// One output column, memory mapped so every worker writes its slice in place
+struct Column {
+    const char *name;
+    const char *type;
+    size_t width;
+    uint8_t *data;
+};
+
+enum {
+    COL_TIMESTAMP, COL_DEVICE, COL_BATV, COL_SYSV, COL_TSPCT, COL_VBUSV, COL_ICHGR, COL_IDPM_LIM,
+    COL_ADC_FLAGS, COL_VBUS_STAT, COL_FAULT, COL_COUNT
+};
+
+static Column columns[COL_COUNT] = {
+    { "timestamp_us", "u64", 8, NULL },
+    { "device_id",    "u32", 4, NULL },
+    { "batv_mv",      "u16", 2, NULL },
+    { "sysv_mv",      "u16", 2, NULL },
+    { "tspct_pct",    "u8",  1, NULL },
+    { "vbusv_mv",     "u16", 2, NULL },
+    { "ichgr_ma",     "u16", 2, NULL },
+    { "idpm_lim_ma",  "u16", 2, NULL },
+    { "adc_flags",    "u8",  1, NULL },
+    { "vbus_stat",    "u8",  1, NULL },
+    { "fault",        "u8",  1, NULL },
+};
+
+struct Log {
+    const uint8_t *base;
+    size_t size;
+    size_t stride;
+    size_t records;
+
+    const bq25896_log_record_t *record(size_t i) const {
+        return (const bq25896_log_record_t *)(base + sizeof(bq25896_log_header_t) + i * stride);
+    }
+};
+
+// Hands out chunks to workers and writes their CSV text back in log order
+class CsvWriter {
+    FILE *_out;
+    std::mutex _lock;
+    std::condition_variable _cv;
+    size_t _next;
+
+public:
+    explicit CsvWriter(FILE *out) : _out(out), _next(0) {}
+
+    void write(size_t chunk, const std::string &text){
+        std::unique_lock<std::mutex> guard(_lock);
+        _cv.wait(guard, [&]{ return _next == chunk; });
+        fwrite(text.data(), 1, text.size(), _out);
+        _next++;
+        _cv.notify_all();
+    }
+};
+
+struct Worker {
+    std::unordered_map<uint32_t, DeviceStats> stats;
+    std::vector<FaultEvent> faults;
+};
+
+struct Options {
+    unsigned threads;
+    const char *faults_path;
+    const char *csv_path;
+    const char *columns_dir;
+    const char *log_path;
+};
+
+static void process_chunk(const Log &log, size_t chunk, Worker &w, CsvWriter *csv){
+    size_t first = chunk * CHUNK_RECORDS;
+    size_t n = std::min(CHUNK_RECORDS, log.records - first);
+
+    // Decode straight into the mapped columns when writing them, else into scratch
+    static thread_local std::vector<uint16_t> scratch16;
+    static thread_local std::vector<uint8_t> scratch8;
+    bq25896_adc_soa_t soa;
+    if(columns[COL_BATV].data){
+        soa.batv_mv = (uint16_t *)columns[COL_BATV].data + first;
+        soa.sysv_mv = (uint16_t *)columns[COL_SYSV].data + first;
+        soa.tspct_pct = columns[COL_TSPCT].data + first;
+        soa.vbusv_mv = (uint16_t *)columns[COL_VBUSV].data + first;
+        soa.ichgr_ma = (uint16_t *)columns[COL_ICHGR].data + first;
+        soa.idpm_lim_ma = (uint16_t *)columns[COL_IDPM_LIM].data + first;
+        soa.flags = columns[COL_ADC_FLAGS].data + first;
+    }else{
+        scratch16.resize(5 * CHUNK_RECORDS);
+        scratch8.resize(2 * CHUNK_RECORDS);
+        soa.batv_mv = &scratch16[0];
+        soa.sysv_mv = &scratch16[CHUNK_RECORDS];
+        soa.vbusv_mv = &scratch16[2 * CHUNK_RECORDS];
+        soa.ichgr_ma = &scratch16[3 * CHUNK_RECORDS];
+        soa.idpm_lim_ma = &scratch16[4 * CHUNK_RECORDS];
+        soa.tspct_pct = &scratch8[0];
+        soa.flags = &scratch8[CHUNK_RECORDS];
+    }
+    bq25896_decode_bulk(log.record(first)->regs.raw + BATV, log.stride, n, soa);
+
+    std::string text;
+    if(csv) text.reserve(n * 64);
+
+    DeviceStats *dev = NULL;
+    uint32_t dev_id = 0;
+    for(size_t i = 0; i < n; i++){
+        const bq25896_log_record_t *rec = log.record(first + i);
+        uint64_t ts;
+        uint32_t id;
+        memcpy(&ts, &rec->timestamp_us, sizeof(ts));
+        memcpy(&id, &rec->device_id, sizeof(id));
+        uint8_t vbus_stat = rec->regs.raw[VBUS_STAT];
+        uint8_t fault = rec->regs.raw[FAULT];
+
+        if(!dev || id != dev_id){
+            dev = &w.stats[id];
+            dev_id = id;
+        }
+        dev->samples++;
+        dev->first_us = std::min(dev->first_us, ts);
+        dev->last_us = std::max(dev->last_us, ts);
+        dev->batv.add(soa.batv_mv[i]);
+        dev->sysv.add(soa.sysv_mv[i]);
+        dev->vbusv.add(soa.vbusv_mv[i]);
+        dev->ichgr.add(soa.ichgr_ma[i]);
+        dev->tspct.add(soa.tspct_pct[i]);
+        dev->chrg_stat[rec->regs.vbus_stat.chrg_stat]++;
+        if(fault){
+            dev->faults++;
+            FaultEvent ev = { ts, id, fault };
+            w.faults.push_back(ev);
+        }
+
+        if(columns[COL_TIMESTAMP].data){
+            memcpy(columns[COL_TIMESTAMP].data + (first + i) * 8, &ts, 8);
+            memcpy(columns[COL_DEVICE].data + (first + i) * 4, &id, 4);
+            columns[COL_VBUS_STAT].data[first + i] = vbus_stat;
+            columns[COL_FAULT].data[first + i] = fault;
+        }
+
+        if(csv){
+            char line[160];
+            int len = snprintf(line, sizeof(line), "%llu,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n",
+                (unsigned long long)ts, id, soa.batv_mv[i], soa.sysv_mv[i], soa.tspct_pct[i],
+                soa.vbusv_mv[i], soa.ichgr_ma[i], soa.idpm_lim_ma[i],
+                rec->regs.vbus_stat.vbus_stat, rec->regs.vbus_stat.chrg_stat, rec->regs.vbus_stat.pg_stat, fault);
+            text.append(line, len);
+        }
+    }
+
+    if(csv) csv->write(chunk, text);
+}
+
+static bool map_columns(const char *dir, size_t records){
+    if(mkdir(dir, 0755) != 0 && errno != EEXIST){
+        fprintf(stderr, "%s: %s\n", dir, strerror(errno));
+        return false;
+    }
+    std::string schema_path = std::string(dir) + "/schema.txt";
+    FILE *schema = fopen(schema_path.c_str(), "w");
+    if(!schema){
+        fprintf(stderr, "%s: %s\n", schema_path.c_str(), strerror(errno));
+        return false;
+    }
+    fprintf(schema, "rows %zu\n", records);
+    for(int c = 0; c < COL_COUNT; c++){
+        std::string path = std::string(dir) + "/" + columns[c].name + "." + columns[c].type;
+        size_t bytes = records * columns[c].width;
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0 || ftruncate(fd, bytes) != 0){
+            fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+            fclose(schema);
+            return false;
+        }
+        if(bytes){
+            void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if(p == MAP_FAILED){
+                fprintf(stderr, "%s: %s\n", path.c_str(), strerror(errno));
+                close(fd);
+                fclose(schema);
+                return false;
+            }
+            columns[c].data = (uint8_t *)p;
+        }
+        close(fd);
+        fprintf(schema, "%s %s\n", columns[c].name, columns[c].type);
+    }
+    fclose(schema);
+    return true;
+}
+
+static void unmap_columns(size_t records){
+    for(int c = 0; c < COL_COUNT; c++){
+        if(columns[c].data) munmap(columns[c].data, records * columns[c].width);
+        columns[c].data = NULL;
+    }
+}
+
+static void print_stats(const std::map<uint32_t, DeviceStats> &stats){
+    printf("device,samples,first_us,last_us,batv_min,batv_mean,batv_max,sysv_min,sysv_mean,sysv_max,"
+           "vbusv_min,vbusv_mean,vbusv_max,ichgr_min,ichgr_mean,ichgr_max,tspct_min,tspct_mean,tspct_max,"
+           "not_charging,pre_charge,fast_charge,charge_done,fault_samples\n");
+    for(std::map<uint32_t, DeviceStats>::const_iterator it = stats.begin(); it != stats.end(); ++it){
+        const DeviceStats &d = it->second;
+        const Channel *ch[] = { &d.batv, &d.sysv, &d.vbusv, &d.ichgr, &d.tspct };
+        printf("%u,%llu,%llu,%llu", it->first, (unsigned long long)d.samples,
+               (unsigned long long)d.first_us, (unsigned long long)d.last_us);
+        for(size_t c = 0; c < sizeof(ch) / sizeof(ch[0]); c++){
+            printf(",%u,%llu,%u", ch[c]->min, (unsigned long long)(ch[c]->sum / d.samples), ch[c]->max);
+        }
+        printf(",%llu,%llu,%llu,%llu,%llu\n", (unsigned long long)d.chrg_stat[0], (unsigned long long)d.chrg_stat[1],
+               (unsigned long long)d.chrg_stat[2], (unsigned long long)d.chrg_stat[3], (unsigned long long)d.faults);
+    }
+}
+
+static bool write_faults(const char *path, std::vector<FaultEvent> &faults){
+    FILE *out = fopen(path, "w");
+    if(!out){
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    std::sort(faults.begin(), faults.end());
+    fprintf(out, "device,timestamp_us,ntc_fault,bat_fault,chrg_fault,boost_fault,watchdog_fault\n");
+    for(size_t i = 0; i < faults.size(); i++){
+        fault_reg_t f = bq25896_view<fault_reg_t>(faults[i].fault);
+        fprintf(out, "%u,%llu,%u,%u,%u,%u,%u\n", faults[i].device_id, (unsigned long long)faults[i].timestamp_us,
+                f.ntc_fault, f.bat_fault, f.chrg_fault, f.boost_fault, f.watchdog_fault);
+    }
+    fclose(out);
+    return true;
+}
+
+static int replay(const Options &opt){
+    int fd = open(opt.log_path, O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0){
+        fprintf(stderr, "%s: %s\n", opt.log_path, strerror(errno));
+        return 1;
+    }
+    if((size_t)st.st_size < sizeof(bq25896_log_header_t)){
+        fprintf(stderr, "%s: not a BQ25896 log\n", opt.log_path);
+        return 1;
+    }
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED){
+        fprintf(stderr, "%s: %s\n", opt.log_path, strerror(errno));
+        return 1;
+    }
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    bq25896_log_header_t header;
+    memcpy(&header, map, sizeof(header));
+    if(header.magic != BQ25896_LOG_MAGIC || header.version != BQ25896_LOG_VERSION ||
+       header.record_size < sizeof(bq25896_log_record_t)){
+        fprintf(stderr, "%s: unsupported log (magic %08x version %u record %u)\n",
+                opt.log_path, header.magic, header.version, header.record_size);
+        munmap(map, st.st_size);
+        return 1;
+    }
+
+    Log log;
+    log.base = (const uint8_t *)map;
+    log.size = st.st_size;
+    log.stride = header.record_size;
+    log.records = (log.size - sizeof(header)) / log.stride;
+
+    if(opt.columns_dir && !map_columns(opt.columns_dir, log.records)){
+        munmap(map, st.st_size);
+        return 1;
+    }
+
+    FILE *csv_file = NULL;
+    CsvWriter *csv = NULL;
+    if(opt.csv_path){
+        csv_file = fopen(opt.csv_path, "w");
+        if(!csv_file){
+            fprintf(stderr, "%s: %s\n", opt.csv_path, strerror(errno));
+            unmap_columns(log.records);
+            munmap(map, st.st_size);
+            return 1;
+        }
+        fprintf(csv_file, "timestamp_us,device_id,batv_mv,sysv_mv,tspct_pct,vbusv_mv,ichgr_ma,idpm_lim_ma,vbus_stat,chrg_stat,pg_stat,fault\n");
+        csv = new CsvWriter(csv_file);
+    }
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    size_t chunks = (log.records + CHUNK_RECORDS - 1) / CHUNK_RECORDS;
+    std::atomic<size_t> next(0);
+    std::vector<Worker> workers(opt.threads);
+    std::vector<std::thread> threads;
+    for(unsigned t = 0; t < opt.threads; t++){
+        threads.push_back(std::thread([&, t]{
+            for(size_t chunk; (chunk = next++) < chunks;){
+                process_chunk(log, chunk, workers[t], csv);
+            }
+        }));
+    }
+    for(size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+    std::map<uint32_t, DeviceStats> stats;
+    std::vector<FaultEvent> faults;
+    for(size_t t = 0; t < workers.size(); t++){
+        for(std::unordered_map<uint32_t, DeviceStats>::const_iterator it = workers[t].stats.begin(); it != workers[t].stats.end(); ++it){
+            stats[it->first].merge(it->second);
+        }
+        faults.insert(faults.end(), workers[t].faults.begin(), workers[t].faults.end());
+    }
+
+    std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+
+    print_stats(stats);
+    int ret = 0;
+    if(opt.faults_path && !write_faults(opt.faults_path, faults)) ret = 1;
+
+    if(csv){
+        delete csv;
+        fclose(csv_file);
+    }
+    unmap_columns(log.records);
+    munmap(map, st.st_size);
+
+    fprintf(stderr, "%zu records, %zu devices, %zu faults in %.3fs (%.1f Mrecords/s, %u threads)\n",
+            log.records, stats.size(), faults.size(), dt.count(), log.records / dt.count() / 1e6, opt.threads);
+    return ret;
+}
+
+// Writes a synthetic log, records interleaved round robin across devices
+static int generate(const char *path, size_t records, uint32_t devices){
+    FILE *out = fopen(path, "wb");
+    if(!out){
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    bq25896_log_header_t header;
+    bq25896_log_init_header(&header);
+    fwrite(&header, sizeof(header), 1, out);
+
+    srand(1);
+    bq25896_log_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    for(size_t i = 0; i < records; i++){
+        rec.timestamp_us = (uint64_t)(i / devices) * 1000000;
+        rec.device_id = i % devices;
+        for(size_t r = 0; r < BQ25896_REG_COUNT; r++){
+            rec.regs.raw[r] = rand() & 0xFF;
+        }
+        // Faults are rare in real logs
+        if(rand() % 1000) rec.regs.raw[FAULT] = 0;
+        fwrite(&rec, sizeof(rec), 1, out);
+    }
+    fclose(out);
+    return 0;
+}
+
+static void usage(const char *argv0){
+    fprintf(stderr,
+        "usage: %s [-j threads] [--faults FILE] [--csv FILE] [--columns DIR] LOG\n"
+        "       %s --generate LOG records devices\n", argv0, argv0);
+}
+
+int main(int argc, char **argv){
+    Options opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--generate" && i + 3 < argc){
+            return generate(argv[i + 1], strtoull(argv[i + 2], NULL, 0), std::max(1ul, strtoul(argv[i + 3], NULL, 0)));
+        }else if(arg == "-j" && i + 1 < argc){
+            opt.threads = std::max(1ul, strtoul(argv[++i], NULL, 0));
+        }else if(arg == "--faults" && i + 1 < argc){
+            opt.faults_path = argv[++i];
+        }else if(arg == "--csv" && i + 1 < argc){
+            opt.csv_path = argv[++i];
+        }else if(arg == "--columns" && i + 1 < argc){
+            opt.columns_dir = argv[++i];
+        }else if(arg[0] != '-' && !opt.log_path){
+            opt.log_path = argv[i];
+        }else{
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if(!opt.log_path){
+        usage(argv[0]);
+        return 2;
+    }
+    return replay(opt);
+}
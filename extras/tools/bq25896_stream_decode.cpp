@@ -0,0 +1,210 @@
+/*
+
+    Decode the framed binary telemetry stream (PMIC_BQ25896_stream.h) on Linux
+
+    Build from the library root:
+        g++ -O2 -I. extras/tools/bq25896_stream_decode.cpp -o bq25896_stream_decode
+
+    Usage:
+        bq25896_stream_decode [--baud N] [--log OUT] [--quiet] SOURCE
+        bq25896_stream_decode --generate OUT frames [drop_every]
+
+    SOURCE is a serial port (set to raw mode at --baud, default 115200),
+    a capture file or - for stdin. Every good frame is printed as one CSV
+    line. --log also writes the frames as a BQLG log (PMIC_BQ25896_log.h)
+    for bq25896_logreplay, with the millis() timestamps unwrapped.
+    Link statistics go to stderr at the end and on SIGINT.
+
+    --generate writes a test capture with every drop_every-th frame left
+    out and the one after it corrupted.
+
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "PMIC_BQ25896_decode.h"
+#include "PMIC_BQ25896_log.h"
+#include "PMIC_BQ25896_stream.h"
+
+static volatile sig_atomic_t stop = 0;
+
+static void on_sigint(int sig){
+    (void)sig;
+    stop = 1;
+}
+
+static speed_t baud_constant(long baud){
+    switch(baud){
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return 0;
+    }
+}
+
+static int open_source(const char *path, long baud){
+    if(!strcmp(path, "-")) return STDIN_FILENO;
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if(fd < 0){
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if(isatty(fd)){
+        speed_t speed = baud_constant(baud);
+        if(!speed){
+            fprintf(stderr, "unsupported baud rate %ld\n", baud);
+            close(fd);
+            return -1;
+        }
+        struct termios tio;
+        tcgetattr(fd, &tio);
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tio.c_cc[VMIN] = 1;
+        tio.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+static void print_stats(const bq25896_frame_reader_t &r, uint64_t bytes){
+    fprintf(stderr, "frames %u  dropped %u  corrupt %u  resyncs %u  bytes %llu (%.1f per frame)\n",
+            r.frames, r.dropped, r.corrupt, r.resyncs, (unsigned long long)bytes,
+            r.frames ? (double)bytes / r.frames : 0.0);
+}
+
+static int decode(const char *path, long baud, const char *log_path, bool quiet){
+    int fd = open_source(path, baud);
+    if(fd < 0) return 1;
+
+    FILE *log = NULL;
+    if(log_path){
+        log = fopen(log_path, "wb");
+        if(!log){
+            fprintf(stderr, "%s: %s\n", log_path, strerror(errno));
+            return 1;
+        }
+        bq25896_log_header_t header;
+        bq25896_log_init_header(&header);
+        fwrite(&header, sizeof(header), 1, log);
+    }
+
+    signal(SIGINT, on_sigint);
+
+    bq25896_frame_reader_t reader;
+    bq25896_frame_reader_init(&reader);
+    bq25896_frame_t frame;
+    uint64_t bytes = 0;
+    // millis() wraps after 49 days, unwrap it for the log
+    uint64_t epoch_ms = 0;
+    uint32_t last_ms = 0;
+    bool have_ms = false;
+
+    if(!quiet) printf("seq,timestamp_ms,batv_mv,sysv_mv,tspct_pct,vbusv_mv,ichgr_ma,vbus_stat,chrg_stat,pg_stat,fault\n");
+
+    uint8_t buf[4096];
+    while(!stop){
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if(n < 0 && errno == EINTR) continue;
+        if(n <= 0) break;
+        bytes += n;
+        for(ssize_t i = 0; i < n; i++){
+            if(!bq25896_frame_feed(&reader, buf[i], &frame)) continue;
+            const bq25896_regs_t &r = frame.regs;
+            if(!quiet){
+                printf("%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,0x%02X\n", frame.seq, frame.timestamp_ms,
+                       bq25896_decode_batv(r.batv.batv), bq25896_decode_sysv(r.sysv.sysv),
+                       bq25896_decode_tspct(r.tspct.tspct), bq25896_decode_vbusv(r.vbusv.vbusv),
+                       bq25896_decode_ichgr(r.ichgr.ichgr), r.vbus_stat.vbus_stat,
+                       r.vbus_stat.chrg_stat, r.vbus_stat.pg_stat, r.raw[FAULT]);
+            }
+            if(log){
+                if(have_ms && frame.timestamp_ms < last_ms && last_ms - frame.timestamp_ms > 0x80000000u){
+                    epoch_ms += 0x100000000ull;
+                }
+                have_ms = true;
+                last_ms = frame.timestamp_ms;
+                bq25896_log_record_t rec;
+                rec.timestamp_us = (epoch_ms + frame.timestamp_ms) * 1000;
+                rec.device_id = 0;
+                rec.regs = frame.regs;
+                fwrite(&rec, sizeof(rec), 1, log);
+            }
+        }
+    }
+
+    if(fd != STDIN_FILENO) close(fd);
+    if(log) fclose(log);
+    print_stats(reader, bytes);
+    return 0;
+}
+
+static int generate(const char *path, uint32_t frames, uint32_t drop_every){
+    FILE *out = fopen(path, "wb");
+    if(!out){
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return 1;
+    }
+    srand(1);
+    bq25896_regs_t regs;
+    memset(&regs, 0, sizeof(regs));
+    for(uint32_t i = 0; i < frames; i++){
+        regs.batv.batv = 60 + rand() % 8;
+        regs.sysv.sysv = 70 + rand() % 4;
+        regs.tspct.tspct = 60;
+        regs.vbusv.vbusv = 24;
+        regs.vbus_stat.chrg_stat = 2;
+        regs.ichgr.ichgr = 20 + rand() % 4;
+        uint8_t f[BQ25896_FRAME_MAX];
+        size_t n = bq25896_frame_encode(i, i * 10, regs, f);
+        if(drop_every && i % drop_every == drop_every - 1) continue;
+        if(drop_every && i % drop_every == 0 && i) f[n / 2] ^= 0x01;
+        fwrite(f, 1, n, out);
+    }
+    fclose(out);
+    return 0;
+}
+
+static void usage(const char *argv0){
+    fprintf(stderr, "usage: %s [--baud N] [--log OUT] [--quiet] SOURCE\n"
+                    "       %s --generate OUT frames [drop_every]\n", argv0, argv0);
+}
+
+int main(int argc, char **argv){
+    if(argc >= 4 && !strcmp(argv[1], "--generate")){
+        return generate(argv[2], strtoul(argv[3], NULL, 0), argc > 4 ? strtoul(argv[4], NULL, 0) : 0);
+    }
+    long baud = 115200;
+    const char *log_path = NULL;
+    bool quiet = false;
+    const char *source = NULL;
+    for(int i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "--baud") && i + 1 < argc) baud = strtol(argv[++i], NULL, 0);
+        else if(!strcmp(argv[i], "--log") && i + 1 < argc) log_path = argv[++i];
+        else if(!strcmp(argv[i], "--quiet")) quiet = true;
+        else if(!source && argv[i][0] != '-') source = argv[i];
+        else if(!source && !strcmp(argv[i], "-")) source = argv[i];
+        else{
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if(!source){
+        usage(argv[0]);
+        return 2;
+    }
+    return decode(source, baud, log_path, quiet);
+}
@@ -0,0 +1,153 @@
+/*
+
+    Profile of the driver from its tracepoints on Linux
+
+    Build from the library root (the tracepoints are off by default):
+        g++ -O2 -DBQ25896_ENABLE_TRACEPOINTS=1 -I. -Iextras/host extras/tools/bq25896_tp_profile.cpp PMIC_BQ25896.cpp PMIC_BQ25896_LowPower.cpp extras/host/host_arduino.cpp -o bq25896_tp_profile
+
+    Usage:
+        bq25896_tp_profile [--rounds N]
+
+    Runs a polling loop against the simulated charger (setters, cached
+    getters, snapshots and INT servicing) with the host sink of
+    extras/host/bq25896_tracepoint_host.h, then pairs the events: bus
+    transaction begin to end, setter entry to the end of its write, cache
+    refresh to the end of its read, INT ISR to handler. Prints count and
+    latency percentiles in ns for each, and the count per setter field.
+    On the host the bus is simulated, so the times are the cost of the
+    driver and the shim; the same pairing applies to a device sink.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "PMIC_BQ25896.h"
+#include "PMIC_BQ25896_LowPower.h"
+#include "bq25896_sim.h"
+#include "bq25896_tracepoint_host.h"
+
+#if !BQ25896_ENABLE_TRACEPOINTS
+#error "build with -DBQ25896_ENABLE_TRACEPOINTS=1"
+#endif
+
+enum {
+    SPAN_BUS_READ = 0,
+    SPAN_BUS_WRITE,
+    SPAN_SETTER,
+    SPAN_CACHE_REFRESH,
+    SPAN_INT_LATENCY,
+    SPAN_COUNT
+};
+
+static const char *span_names[SPAN_COUNT] = { "bus read", "bus write", "setter", "cache refresh", "INT latency" };
+
+struct Profile {
+    std::vector<uint32_t> spans[SPAN_COUNT];
+    std::map<uint32_t, uint32_t> setters;
+    // Open spans, 0 if none
+    uint32_t bus_start, setter_start, refresh_start, isr_start;
+    uint8_t bus_dir;
+
+    Profile() : bus_start(0), setter_start(0), refresh_start(0), isr_start(0), bus_dir(0) {}
+
+    void close(uint32_t &start, int span, uint32_t stamp){
+        if(start) spans[span].push_back(stamp - start);
+        start = 0;
+    }
+
+    void feed(const bq25896_tp_event_t &e){
+        switch(e.id){
+            case BQ25896_TP_BUS_BEGIN:
+            bus_start = e.stamp;
+            bus_dir = (e.arg >> 8) & 0xFF;
+            break;
+            case BQ25896_TP_BUS_END:
+            close(bus_start, bus_dir == BQ25896_TRACE_WRITE ? SPAN_BUS_WRITE : SPAN_BUS_READ, e.stamp);
+            // A refresh ends with its read, a setter with its write
+            if(bus_dir == BQ25896_TRACE_READ) close(refresh_start, SPAN_CACHE_REFRESH, e.stamp);
+            else close(setter_start, SPAN_SETTER, e.stamp);
+            break;
+            case BQ25896_TP_SETTER:
+            setter_start = e.stamp;
+            setters[e.arg]++;
+            break;
+            case BQ25896_TP_CACHE_REFRESH:
+            refresh_start = e.stamp;
+            break;
+            case BQ25896_TP_INT_ISR:
+            isr_start = e.stamp;
+            break;
+            case BQ25896_TP_INT_HANDLER:
+            close(isr_start, SPAN_INT_LATENCY, e.stamp);
+            break;
+        }
+    }
+
+    void drain(){
+        bq25896_tp_event_t e;
+        while(bq25896_tp_ring_pop(bq25896_tp_host_ring, e)) feed(e);
+    }
+};
+
+static uint32_t percentile(const std::vector<uint32_t> &v, unsigned p){
+    return v.empty() ? 0 : v[(v.size() - 1) * p / 100];
+}
+
+int main(int argc, char **argv){
+    long rounds = 10000;
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) rounds = atol(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--rounds N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    BQ25896Sim sim;
+    TwoWire bus(&sim);
+    PMIC_BQ25896 pmic;
+    pmic.begin(&bus);
+    pmic.setCACHE(true);
+    host_clock_use_virtual(true);
+    PMIC_BQ25896_LowPower lowpower(pmic);
+    bq25896_lowpower_config_t config = { -1, true, 1000, BQ25896_SLEEP_LIGHT };
+    lowpower.begin(config);
+
+    Profile profile;
+    for(long r = 0; r < rounds; r++){
+        pmic.setICHG(1024 + (r & 7) * 64);
+        pmic.setWD_RST(true);
+        if(r % 10 == 0) pmic.setFIELD(BQ25896_F_VREG, 23);
+        (void)pmic.getVREG();
+        (void)pmic.getBATV();
+        (void)pmic.getICHGR();
+        if(r % 50 == 0){
+            // What the application's INT ISR would mark
+            BQ25896_TRACEPOINT(BQ25896_TP_INT_ISR, 0);
+            lowpower.service();
+        }
+        host_clock_advance_us(250000);
+        profile.drain();
+    }
+
+    printf("%-14s %8s %8s %8s %8s %8s\n", "span", "count", "p50 ns", "p90 ns", "p99 ns", "max ns");
+    for(int s = 0; s < SPAN_COUNT; s++){
+        std::vector<uint32_t> &v = profile.spans[s];
+        std::sort(v.begin(), v.end());
+        printf("%-14s %8zu %8u %8u %8u %8u\n", span_names[s], v.size(), percentile(v, 50), percentile(v, 90),
+               percentile(v, 99), v.empty() ? 0 : v.back());
+    }
+    printf("\nsetter calls by field\n");
+    for(std::map<uint32_t, uint32_t>::const_iterator it = profile.setters.begin(); it != profile.setters.end(); ++it){
+        printf("  %-14s %8u\n", bq25896_fields[it->first].name, it->second);
+    }
+    printf("events dropped %u\n", bq25896_tp_host_ring.dropped);
+    return 0;
+}